@@ -0,0 +1,136 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "BillArchive.h"
+
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "MapReduce.h"
+
+namespace core {
+
+namespace {
+
+// 段文件写入一次、很少读取，取较高的压缩级别。
+constexpr int kCompressionLevel = 9;
+
+// 并行读取时每个工作者的结果。
+struct SegmentBills {
+  bool ok = true;
+  QVector<Bill> bills;
+};
+
+void mergeSegmentBills(SegmentBills &acc, SegmentBills &&part) {
+  acc.ok = acc.ok && part.ok;
+  acc.bills += part.bills;
+}
+
+}  // namespace
+
+BillArchive::BillArchive(const JsonStorage &storage) : storage_(storage) {}
+
+bool BillArchive::write(const QString &userId, const QDate &month,
+                        int version, const QVector<Bill> &bills,
+                        ArchiveSegment &outSegment) const {
+  const ArchiveSegment segment =
+      ArchiveSegment::summarize(month, version, bills);
+  if (!storage_.saveBlob(userId, suffix(segment), encode(bills))) {
+    return false;
+  }
+  outSegment = segment;
+  return true;
+}
+
+bool BillArchive::read(const QString &userId, const ArchiveSegment &segment,
+                       QVector<Bill> &outBills) const {
+  QByteArray bytes;
+  QVector<Bill> bills;
+  if (!storage_.loadBlob(userId, suffix(segment), bytes) ||
+      !decode(bytes, bills) || bills.size() != segment.count) {
+    return false;
+  }
+  outBills = std::move(bills);
+  return true;
+}
+
+bool BillArchive::readOverlapping(const QString &userId,
+                                  const QVector<ArchiveSegment> &segments,
+                                  const QDate &from, const QDate &to,
+                                  QVector<Bill> &outBills) const {
+  QVector<ArchiveSegment> needed;
+  for (const auto &segment : segments) {
+    if (segment.overlaps(from, to)) {
+      needed.push_back(segment);
+    }
+  }
+  if (needed.isEmpty()) {
+    return true;
+  }
+  SegmentBills result = mapReduce<SegmentBills>(
+      needed,
+      [&](const ArchiveSegment &segment) {
+        SegmentBills part;
+        part.ok = read(userId, segment, part.bills);
+        return part;
+      },
+      mergeSegmentBills, mergeSegmentBills);
+  if (!result.ok) {
+    return false;
+  }
+  outBills += result.bills;
+  return true;
+}
+
+void BillArchive::discard(const QString &userId,
+                          const ArchiveSegment &segment) const {
+  storage_.removeBlob(userId, suffix(segment));
+}
+
+QDate BillArchive::monthOf(const Bill &bill) {
+  if (!bill.timestamp.isValid()) {
+    return QDate();
+  }
+  const QDate date = bill.timestamp.date();
+  return QDate(date.year(), date.month(), 1);
+}
+
+// 后缀中不含点号，diskUsage 据此把段文件计入该用户。
+QString BillArchive::suffix(const ArchiveSegment &segment) {
+  return QString("archive-%1-%2")
+      .arg(segment.month.toString("yyyyMM"))
+      .arg(segment.version);
+}
+
+// 紧凑 JSON 数组经 zlib 压缩；账单字段重复度高，通常能压到原来的几分之一。
+QByteArray BillArchive::encode(const QVector<Bill> &bills) {
+  JsonWriter out(JsonWriter::Style::Compact, bills.size() * 192);
+  out.beginArray();
+  for (const auto &bill : bills) {
+    bill.writeJson(out);
+  }
+  out.endArray();
+  return qCompress(out.take(), kCompressionLevel);
+}
+
+bool BillArchive::decode(const QByteArray &bytes, QVector<Bill> &outBills) {
+  const QByteArray json = qUncompress(bytes);
+  JsonReader in(json);
+  if (in.peek() != JsonReader::Type::Array) {
+    return false;
+  }
+  QVector<Bill> bills;
+  in.beginArray();
+  while (in.nextElement()) {
+    bills.push_back(Bill::readJson(in));
+  }
+  if (!in.ok() || !in.atEnd()) {
+    return false;
+  }
+  outBills = std::move(bills);
+  return true;
+}
+
+}  // namespace core
@@ -0,0 +1,52 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QByteArray>
+#include <QDate>
+#include <QVector>
+
+#include "Entities.h"
+#include "JsonStorage.h"
+
+namespace core {
+
+// BillArchive 把某个月的冷账单压缩成一个不可变的段文件，作为用户的附属
+// 文件 <userId>.archive-<yyyyMM>-<version> 保存。段文件写入后不再修改：
+// 补入或取回账单时写出新版本，用户文件提交后再删除旧版本，因此中途失败
+// 时用户文件引用的段始终完整。加载用户不会读取段文件，只有需要明细的
+// 查询才按月解压对应的段。
+class BillArchive {
+ public:
+  explicit BillArchive(const JsonStorage &storage);
+
+  // 写入一个新版本的段文件，成功后返回其摘要。
+  bool write(const QString &userId, const QDate &month, int version,
+             const QVector<Bill> &bills, ArchiveSegment &outSegment) const;
+  // 读取并解压一个段；文件缺失、损坏或条数与摘要不符时返回 false。
+  bool read(const QString &userId, const ArchiveSegment &segment,
+            QVector<Bill> &outBills) const;
+  // 并行读取与 [from, to] 相交的各段（端点无效表示不限）的全部账单。
+  bool readOverlapping(const QString &userId,
+                       const QVector<ArchiveSegment> &segments,
+                       const QDate &from, const QDate &to,
+                       QVector<Bill> &outBills) const;
+  // 删除已被新版本取代的段文件。
+  void discard(const QString &userId, const ArchiveSegment &segment) const;
+
+  // 账单所在月的 1 日，无有效时间的账单返回无效日期。
+  static QDate monthOf(const Bill &bill);
+  // 段文件的附属文件后缀。
+  static QString suffix(const ArchiveSegment &segment);
+  static QByteArray encode(const QVector<Bill> &bills);
+  static bool decode(const QByteArray &bytes, QVector<Bill> &outBills);
+
+ private:
+  const JsonStorage &storage_;
+};
+
+}  // namespace core
@@ -0,0 +1,506 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "BillQuery.h"
+
+#include <QHash>
+#include <QMap>
+#include <QStringList>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace core {
+
+namespace {
+
+// 每批求值的账单数：选择向量足够小以留在缓存中。
+constexpr int kBatchSize = 1024;
+
+struct Token {
+  enum Kind { Word, String, Symbol, End } kind = End;
+  QString text;
+};
+
+// 词法分析：引号字符串、比较符号、括号与逗号，其余连续字符视为单词。
+bool tokenize(const QString &input, QVector<Token> &tokens,
+              QString &errorMessage) {
+  int i = 0;
+  while (i < input.size()) {
+    const QChar ch = input.at(i);
+    if (ch.isSpace()) {
+      ++i;
+      continue;
+    }
+    if (ch == QLatin1Char('"') || ch == QLatin1Char('\'')) {
+      const int end = input.indexOf(ch, i + 1);
+      if (end < 0) {
+        errorMessage = "引号未闭合";
+        return false;
+      }
+      tokens.push_back({Token::String, input.mid(i + 1, end - i - 1)});
+      i = end + 1;
+      continue;
+    }
+    if (QStringLiteral("(),").contains(ch)) {
+      tokens.push_back({Token::Symbol, QString(ch)});
+      ++i;
+      continue;
+    }
+    if (QStringLiteral("=!<>~").contains(ch)) {
+      QString op(ch);
+      if (i + 1 < input.size() && input.at(i + 1) == QLatin1Char('=')) {
+        op += QLatin1Char('=');
+      }
+      tokens.push_back({Token::Symbol, op});
+      i += op.size();
+      continue;
+    }
+    int end = i;
+    while (end < input.size() && !input.at(end).isSpace() &&
+           !QStringLiteral("(),=!<>~\"'").contains(input.at(end))) {
+      ++end;
+    }
+    tokens.push_back({Token::Word, input.mid(i, end - i)});
+    i = end;
+  }
+  tokens.push_back({Token::End, QString()});
+  return true;
+}
+
+// 相对日期区间，按传入的 today 计算。
+bool periodRange(const QString &name, const QDate &today, QDate &from,
+                 QDate &to) {
+  const int quarterStartMonth = (today.month() - 1) / 3 * 3 + 1;
+  const QDate quarterStart(today.year(), quarterStartMonth, 1);
+  const QDate monthStart(today.year(), today.month(), 1);
+  const QDate yearStart(today.year(), 1, 1);
+  if (name == "today") {
+    from = to = today;
+  } else if (name == "yesterday") {
+    from = to = today.addDays(-1);
+  } else if (name == "this_week") {
+    from = today.addDays(1 - today.dayOfWeek());
+    to = from.addDays(6);
+  } else if (name == "last_7_days") {
+    from = today.addDays(-6);
+    to = today;
+  } else if (name == "last_30_days") {
+    from = today.addDays(-29);
+    to = today;
+  } else if (name == "this_month") {
+    from = monthStart;
+    to = monthStart.addMonths(1).addDays(-1);
+  } else if (name == "last_month") {
+    from = monthStart.addMonths(-1);
+    to = monthStart.addDays(-1);
+  } else if (name == "this_quarter") {
+    from = quarterStart;
+    to = quarterStart.addMonths(3).addDays(-1);
+  } else if (name == "last_quarter") {
+    from = quarterStart.addMonths(-3);
+    to = quarterStart.addDays(-1);
+  } else if (name == "this_year") {
+    from = yearStart;
+    to = yearStart.addYears(1).addDays(-1);
+  } else if (name == "last_year") {
+    from = yearStart.addYears(-1);
+    to = yearStart.addDays(-1);
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// 递归下降解析器，直接产出流水线所需的各个部件。
+class Parser {
+ public:
+  Parser(const QVector<Token> &tokens, const QVector<Category> &categories)
+      : tokens_(tokens) {
+    for (const auto &category : categories) {
+      categoryIds_.insert(category.id.toString(), category.id);
+      categoryIds_.insert(category.name, category.id);
+    }
+  }
+
+  const Token &peek() const { return tokens_[pos_]; }
+  Token take() { return tokens_[pos_ < tokens_.size() - 1 ? pos_++ : pos_]; }
+  bool atEnd() const { return peek().kind == Token::End; }
+
+  bool acceptWord(const char *word) {
+    if (peek().kind == Token::Word &&
+        peek().text.compare(QLatin1String(word), Qt::CaseInsensitive) == 0) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+  bool acceptSymbol(const char *symbol) {
+    if (peek().kind == Token::Symbol && peek().text == QLatin1String(symbol)) {
+      ++pos_;
+      return true;
+    }
+    return false;
+  }
+  // 读取一个值：单词或引号字符串。
+  bool value(QString &out) {
+    if (peek().kind != Token::Word && peek().kind != Token::String) {
+      return false;
+    }
+    out = take().text;
+    return true;
+  }
+  bool resolveCategory(const QString &value, EntityId &id) const {
+    const auto it = categoryIds_.constFind(value);
+    if (it == categoryIds_.constEnd()) {
+      return false;
+    }
+    id = it.value();
+    return true;
+  }
+
+ private:
+  const QVector<Token> &tokens_;
+  int pos_ = 0;
+  QHash<QString, EntityId> categoryIds_;
+};
+
+// 比较运算符映射。
+bool comparison(const QString &symbol, int &op) {
+  static const QStringList kOps = {"=", "!=", "<", "<=", ">", ">="};
+  op = kOps.indexOf(symbol == "==" ? QStringLiteral("=") : symbol);
+  return op >= 0;
+}
+
+}  // namespace
+
+// 解析并编译表达式：日期条件折叠成区间，其余子句按估计代价排序。
+bool BillQuery::compile(const QString &expression,
+                        const QVector<Category> &categories, BillQuery &out,
+                        QString &errorMessage, const QDate &today) {
+  QVector<Token> tokens;
+  if (!tokenize(expression, tokens, errorMessage)) {
+    errorMessage = "查询语法错误：" + errorMessage;
+    return false;
+  }
+  Parser parser(tokens, categories);
+  BillQuery query;
+  auto fail = [&errorMessage](const QString &message) {
+    errorMessage = "查询语法错误：" + message;
+    return false;
+  };
+
+  bool first = true;
+  while (!parser.atEnd()) {
+    if (parser.acceptWord("group")) {
+      if (!parser.acceptWord("by")) {
+        return fail("group 后应为 by");
+      }
+      if (parser.acceptWord("category")) {
+        query.groupKey_ = QueryGroupKey::Category;
+      } else if (parser.acceptWord("day")) {
+        query.groupKey_ = QueryGroupKey::Day;
+      } else if (parser.acceptWord("month")) {
+        query.groupKey_ = QueryGroupKey::Month;
+      } else {
+        return fail("只支持按 category、day 或 month 分组");
+      }
+      if (!parser.atEnd()) {
+        return fail("group by 必须位于末尾");
+      }
+      break;
+    }
+    if (!first && !parser.acceptWord("and") && !parser.acceptWord("&&")) {
+      return fail(QString("意外的输入 \"%1\"").arg(parser.peek().text));
+    }
+    first = false;
+
+    Stage stage;
+    int op = 0;
+    if (parser.acceptWord("type")) {
+      stage.field = Field::Type;
+      QString value;
+      if (!comparison(parser.take().text, op) || op > 1 ||
+          !parser.value(value)) {
+        return fail("type 只支持 = 或 !=");
+      }
+      stage.op = op == 0 ? Op::Eq : Op::Ne;
+      const QString lowered = value.toLower();
+      if (lowered == "income" || lowered == "收入") {
+        stage.type = BillType::Income;
+      } else if (lowered == "expense" || lowered == "支出") {
+        stage.type = BillType::Expense;
+      } else {
+        return fail("未知的收支类型 " + value);
+      }
+    } else if (parser.acceptWord("category")) {
+      stage.field = Field::Category;
+      QStringList values;
+      const bool negated = parser.acceptWord("not");
+      if (parser.acceptWord("in")) {
+        stage.op = negated ? Op::NotIn : Op::In;
+        if (!parser.acceptSymbol("(")) {
+          return fail("in 后应为括号列表");
+        }
+        do {
+          QString value;
+          if (!parser.value(value)) {
+            return fail("分类列表格式错误");
+          }
+          values << value;
+        } while (parser.acceptSymbol(","));
+        if (!parser.acceptSymbol(")")) {
+          return fail("分类列表缺少右括号");
+        }
+      } else {
+        QString value;
+        if (negated || !comparison(parser.take().text, op) || op > 1 ||
+            !parser.value(value)) {
+          return fail("category 只支持 =、!= 或 in");
+        }
+        stage.op = op == 0 ? Op::In : Op::NotIn;
+        values << value;
+      }
+      for (const auto &value : values) {
+        EntityId id;
+        if (!parser.resolveCategory(value, id)) {
+          return fail("未知分类 " + value);
+        }
+        stage.ids.insert(id);
+      }
+    } else if (parser.acceptWord("amount")) {
+      stage.field = Field::Amount;
+      QString value;
+      bool ok = false;
+      if (!comparison(parser.take().text, op) || !parser.value(value)) {
+        return fail("amount 后应为比较运算与数值");
+      }
+      stage.number = value.toDouble(&ok);
+      if (!ok) {
+        return fail("金额无效 " + value);
+      }
+      stage.op = static_cast<Op>(op);
+    } else if (parser.acceptWord("date")) {
+      QDate from;
+      QDate to;
+      QString value;
+      if (parser.acceptWord("in")) {
+        if (!parser.value(value) ||
+            !periodRange(value.toLower(), today, from, to)) {
+          return fail("未知的时间区间 " + value);
+        }
+      } else {
+        if (!comparison(parser.take().text, op) || !parser.value(value)) {
+          return fail("date 后应为比较运算与日期");
+        }
+        const QDate date = QDate::fromString(value, Qt::ISODate);
+        if (!date.isValid()) {
+          return fail("日期格式应为 yyyy-MM-dd");
+        }
+        switch (static_cast<Op>(op)) {
+          case Op::Eq:
+            from = to = date;
+            break;
+          case Op::Lt:
+            to = date.addDays(-1);
+            break;
+          case Op::Le:
+            to = date;
+            break;
+          case Op::Gt:
+            from = date.addDays(1);
+            break;
+          case Op::Ge:
+            from = date;
+            break;
+          default:
+            // 不等于无法裁剪区间，保留为普通谓词。
+            stage.field = Field::Date;
+            stage.op = Op::Ne;
+            stage.date = date;
+            query.stages_.push_back(stage);
+            continue;
+        }
+      }
+      if (from.isValid() && (!query.from_.isValid() || from > query.from_)) {
+        query.from_ = from;
+      }
+      if (to.isValid() && (!query.to_.isValid() || to < query.to_)) {
+        query.to_ = to;
+      }
+      continue;
+    } else if (parser.acceptWord("note")) {
+      stage.field = Field::Note;
+      if (!parser.acceptWord("contains") && !parser.acceptSymbol("~")) {
+        return fail("note 只支持 contains");
+      }
+      if (!parser.value(stage.text)) {
+        return fail("contains 后应为文本");
+      }
+      stage.op = Op::Contains;
+    } else {
+      return fail(QString("未知字段 \"%1\"").arg(parser.peek().text));
+    }
+    query.stages_.push_back(stage);
+  }
+
+  std::stable_sort(query.stages_.begin(), query.stages_.end(),
+                   [](const Stage &a, const Stage &b) {
+                     return stageCost(a) < stageCost(b);
+                   });
+  out = query;
+  return true;
+}
+
+QVector<int> BillQuery::timeOrder(const QVector<Bill> &bills) {
+  QVector<qint64> keys(bills.size());
+  for (int i = 0; i < bills.size(); ++i) {
+    keys[i] = bills[i].timestamp.isValid()
+                  ? bills[i].timestamp.toMSecsSinceEpoch()
+                  : std::numeric_limits<qint64>::min();
+  }
+  QVector<int> order(bills.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&keys](int a, int b) { return keys[a] < keys[b]; });
+  return order;
+}
+
+// 先二分出日期区间，再以选择向量分批穿过各级谓词，最后聚合幸存账单。
+BillQueryResult BillQuery::run(const QVector<Bill> &bills,
+                               const QVector<int> &order) const {
+  BillQueryResult result;
+  auto begin = order.constBegin();
+  auto end = order.constEnd();
+  if (from_.isValid()) {
+    begin = std::lower_bound(begin, end, from_,
+                             [&bills](int i, const QDate &date) {
+                               return bills[i].timestamp.date() < date;
+                             });
+  }
+  if (to_.isValid()) {
+    end = std::upper_bound(begin, end, to_,
+                           [&bills](const QDate &date, int i) {
+                             return date < bills[i].timestamp.date();
+                           });
+  }
+  if (from_.isValid() && to_.isValid() && from_ > to_) {
+    end = begin;
+  }
+
+  QMap<QString, RollupTotals> groups;
+  QVector<int> selection;
+  selection.reserve(kBatchSize);
+  for (auto batch = begin; batch < end;) {
+    const auto batchEnd = batch + std::min<qptrdiff>(kBatchSize, end - batch);
+    selection.clear();
+    for (auto it = batch; it != batchEnd; ++it) {
+      selection.push_back(*it);
+    }
+    batch = batchEnd;
+    for (const auto &stage : stages_) {
+      int kept = 0;
+      for (const int index : selection) {
+        if (matches(stage, bills[index])) {
+          selection[kept++] = index;
+        }
+      }
+      selection.resize(kept);
+      if (selection.isEmpty()) {
+        break;
+      }
+    }
+
+    for (const int index : selection) {
+      const Bill &bill = bills[index];
+      result.bills.push_back(bill);
+      RollupTotals delta;
+      delta.count = 1;
+      (bill.type == BillType::Income ? delta.income : delta.expense) =
+          bill.amount;
+      result.totals.income += delta.income;
+      result.totals.expense += delta.expense;
+      ++result.totals.count;
+      if (groupKey_ == QueryGroupKey::None) {
+        continue;
+      }
+      QString key;
+      switch (groupKey_) {
+        case QueryGroupKey::Category:
+          key = bill.categoryId.toString();
+          break;
+        case QueryGroupKey::Day:
+          key = bill.timestamp.date().toString(Qt::ISODate);
+          break;
+        case QueryGroupKey::Month:
+          key = bill.timestamp.date().toString("yyyy-MM");
+          break;
+        case QueryGroupKey::None:
+          break;
+      }
+      auto &totals = groups[key];
+      totals.income += delta.income;
+      totals.expense += delta.expense;
+      ++totals.count;
+    }
+  }
+
+  result.groups.reserve(groups.size());
+  for (auto it = groups.constBegin(); it != groups.constEnd(); ++it) {
+    result.groups.push_back({it.key(), it.value()});
+  }
+  return result;
+}
+
+// 数值比较最便宜，集合查找其次，子串匹配最贵，放在流水线末端。
+int BillQuery::stageCost(const Stage &stage) {
+  switch (stage.field) {
+    case Field::Type:
+    case Field::Amount:
+      return 0;
+    case Field::Date:
+      return 1;
+    case Field::Category:
+      return 2;
+    case Field::Note:
+      return 3;
+  }
+  return 3;
+}
+
+bool BillQuery::matches(const Stage &stage, const Bill &bill) const {
+  switch (stage.field) {
+    case Field::Type:
+      return (bill.type == stage.type) == (stage.op == Op::Eq);
+    case Field::Category:
+      return stage.ids.contains(bill.categoryId) == (stage.op == Op::In);
+    case Field::Date:
+      return bill.timestamp.date() != stage.date;
+    case Field::Note:
+      return bill.note.contains(stage.text, Qt::CaseInsensitive);
+    case Field::Amount:
+      break;
+  }
+  switch (stage.op) {
+    case Op::Eq:
+      return qFuzzyCompare(bill.amount + 1.0, stage.number + 1.0);
+    case Op::Ne:
+      return !qFuzzyCompare(bill.amount + 1.0, stage.number + 1.0);
+    case Op::Lt:
+      return bill.amount < stage.number;
+    case Op::Le:
+      return bill.amount <= stage.number;
+    case Op::Gt:
+      return bill.amount > stage.number;
+    case Op::Ge:
+      return bill.amount >= stage.number;
+    default:
+      return false;
+  }
+}
+
+}  // namespace core
@@ -0,0 +1,91 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include "Entities.h"
+
+#include <QDate>
+#include <QSet>
+#include <QString>
+#include <QVector>
+
+namespace core {
+
+// 分组维度。
+enum class QueryGroupKey { None, Category, Day, Month };
+
+// 分组聚合的一行，key 为分类 ID 或 "yyyy-MM-dd" / "yyyy-MM"。
+struct QueryGroup {
+  QString key;
+  RollupTotals totals;
+};
+
+// 查询结果：命中的账单按时间升序，totals 为全部命中账单的合计。
+struct BillQueryResult {
+  QVector<Bill> bills;
+  RollupTotals totals;
+  QVector<QueryGroup> groups;
+};
+
+// BillQuery 把过滤表达式编译成按代价排序的谓词流水线，然后分批求值。
+// 表达式由 and 连接的子句组成，可选以 group by 结尾，例如：
+//   type = expense and category in (餐饮, 交通) and amount > 100
+//   and date in last_quarter and note contains "taxi" group by month
+// 支持的子句：
+//   type = | != income|expense|收入|支出
+//   category = | != 名称或ID；category [not] in (值, ...)
+//   amount = != < <= > >= 数值
+//   date = != < <= > >= yyyy-MM-dd；date in today|yesterday|this_week|
+//     last_7_days|last_30_days|this_month|last_month|this_quarter|
+//     last_quarter|this_year|last_year
+//   note contains|~ 文本（不区分大小写）
+// 日期条件会先在按时间排序的下标上二分裁剪，其余谓词只作用于区间内的账单。
+class BillQuery {
+ public:
+  // 编译表达式；分类名称在此时解析为 ID，today 用于计算相对日期。
+  static bool compile(const QString &expression,
+                      const QVector<Category> &categories, BillQuery &out,
+                      QString &errorMessage,
+                      const QDate &today = QDate::currentDate());
+
+  // 账单下标按时间升序排列，无效时间排在最前；可在同一份数据上复用。
+  static QVector<int> timeOrder(const QVector<Bill> &bills);
+
+  // 在 order（timeOrder 的结果）给出的顺序上求值。
+  BillQueryResult run(const QVector<Bill> &bills,
+                      const QVector<int> &order) const;
+
+  QueryGroupKey groupKey() const { return groupKey_; }
+  // 日期条件裁剪出的闭区间，无效表示该端不限。
+  const QDate &dateFrom() const { return from_; }
+  const QDate &dateTo() const { return to_; }
+
+ private:
+  enum class Field { Type, Category, Amount, Date, Note };
+  enum class Op { Eq, Ne, Lt, Le, Gt, Ge, In, NotIn, Contains };
+
+  // 流水线中的一级谓词，字段与操作在编译期确定，求值时只做分支跳转。
+  struct Stage {
+    Field field = Field::Type;
+    Op op = Op::Eq;
+    double number = 0.0;
+    BillType type = BillType::Expense;
+    QDate date;
+    QSet<EntityId> ids;
+    QString text;
+  };
+
+  static int stageCost(const Stage &stage);
+  bool matches(const Stage &stage, const Bill &bill) const;
+
+  QVector<Stage> stages_;
+  QDate from_;  // 日期下界（含），无效表示不限
+  QDate to_;    // 日期上界（含）
+  QueryGroupKey groupKey_ = QueryGroupKey::None;
+};
+
+}  // namespace core
@@ -0,0 +1,236 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "CommentStore.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QPair>
+
+#include <algorithm>
+
+#include "JsonWriter.h"
+
+namespace core {
+
+namespace {
+
+const char *const kCommentDir = "comments";
+const char *const kThreadSuffix = ".jsonl";
+
+}  // namespace
+
+CommentStore::CommentStore(const QDir &baseDir,
+                           const DurabilityOptions &durability)
+    : dir_(baseDir.filePath(kCommentDir)), committer_(durability) {
+  if (!dir_.exists()) {
+    dir_.mkpath(".");
+  }
+}
+
+bool CommentStore::append(const EntityId &postId, const Comment &comment) {
+  auto entry = thread(postId);
+  QMutexLocker locker(&entry->mutex);
+  ensureLoaded(postId, *entry);
+  return appendLines(postId, *entry, {comment});
+}
+
+bool CommentStore::importThread(const EntityId &postId,
+                                const QVector<Comment> &comments) {
+  auto entry = thread(postId);
+  QMutexLocker locker(&entry->mutex);
+  ensureLoaded(postId, *entry);
+  if (!entry->offsets.isEmpty() || comments.isEmpty()) {
+    return true;
+  }
+  return appendLines(postId, *entry, comments);
+}
+
+CommentStore::Summary CommentStore::summary(const EntityId &postId) const {
+  auto entry = thread(postId);
+  QMutexLocker locker(&entry->mutex);
+  ensureLoaded(postId, *entry);
+  return {entry->offsets.size(), entry->recent};
+}
+
+// 借助行偏移直接定位到页首，只解析本页的行。
+QVector<Comment> CommentStore::read(const EntityId &postId, int offset,
+                                    int limit, int *total) const {
+  auto entry = thread(postId);
+  QMutexLocker locker(&entry->mutex);
+  ensureLoaded(postId, *entry);
+  const int count = entry->offsets.size();
+  if (total) {
+    *total = count;
+  }
+  const int begin = qBound(0, offset, count);
+  const int end = limit < 0 ? count : std::min(count, begin + limit);
+  QVector<Comment> comments;
+  if (begin >= end) {
+    return comments;
+  }
+  QFile file(threadPath(postId));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return comments;
+  }
+  comments.reserve(end - begin);
+  for (int i = begin; i < end; ++i) {
+    if (file.pos() != entry->offsets[i] && !file.seek(entry->offsets[i])) {
+      break;
+    }
+    Comment comment;
+    if (parseLine(file.readLine(), comment)) {
+      comments.push_back(comment);
+    }
+  }
+  return comments;
+}
+
+void CommentStore::setThreadCacheLimit(int threads) {
+  QMutexLocker locker(&threadsMutex_);
+  threadCacheLimit_ = std::max(1, threads);
+  evictIdleThreads();
+}
+
+int CommentStore::cachedThreads() const {
+  QMutexLocker locker(&threadsMutex_);
+  return threads_.size();
+}
+
+std::shared_ptr<CommentStore::Thread> CommentStore::thread(
+    const EntityId &postId) const {
+  QMutexLocker locker(&threadsMutex_);
+  auto it = threads_.find(postId);
+  if (it == threads_.end()) {
+    if (threads_.size() >= threadCacheLimit_) {
+      evictIdleThreads();
+    }
+    it = threads_.insert(postId, std::make_shared<Thread>());
+  }
+  it.value()->lastUsed = ++useTick_;
+  return it.value();
+}
+
+// 只被本表引用的串没有人在读写，可以丢弃；其余的即使超出上限也保留。
+// 一次腾出四分之一的空间，使扫描的开销均摊到后续的插入上。调用方须持有
+// threadsMutex_。
+void CommentStore::evictIdleThreads() const {
+  const int target = threadCacheLimit_ - std::max(1, threadCacheLimit_ / 4);
+  if (threads_.size() <= target) {
+    return;
+  }
+  QVector<QPair<quint64, EntityId>> idle;
+  for (auto it = threads_.constBegin(); it != threads_.constEnd(); ++it) {
+    if (it.value().use_count() == 1) {
+      idle.push_back({it.value()->lastUsed, it.key()});
+    }
+  }
+  std::sort(idle.begin(), idle.end(),
+            [](const QPair<quint64, EntityId> &a,
+               const QPair<quint64, EntityId> &b) {
+              return a.first < b.first;
+            });
+  for (const auto &entry : idle) {
+    if (threads_.size() <= target) {
+      break;
+    }
+    threads_.remove(entry.second);
+  }
+}
+
+// 首次访问时扫描一遍文件，记录每条有效行的偏移；崩溃时写了一半的末行
+// 被截掉，后续追加从最后一个完整行之后开始。调用方须持有该串的锁。
+void CommentStore::ensureLoaded(const EntityId &postId,
+                                Thread &thread) const {
+  if (thread.loaded) {
+    return;
+  }
+  thread.loaded = true;
+  QFile file(threadPath(postId));
+  if (!file.open(QIODevice::ReadOnly)) {
+    return;
+  }
+  const QByteArray bytes = file.readAll();
+  file.close();
+  int start = 0;
+  while (start < bytes.size()) {
+    const int end = bytes.indexOf('\n', start);
+    if (end < 0) {
+      break;
+    }
+    Comment comment;
+    if (parseLine(bytes.mid(start, end - start), comment)) {
+      thread.offsets.push_back(start);
+      pushRecent(thread.recent, comment);
+    }
+    start = end + 1;
+  }
+  if (start < bytes.size()) {
+    file.resize(start);
+  }
+}
+
+// 整批行一次写入并按持久性选项刷盘；失败时截回写入前的长度，不留下
+// 半截记录。
+bool CommentStore::appendLines(const EntityId &postId, Thread &thread,
+                               const QVector<Comment> &comments) const {
+  const QString path = threadPath(postId);
+  const QFileInfo info(path);
+  const qint64 start = info.exists() ? info.size() : 0;
+  QByteArray bytes;
+  QVector<qint64> offsets;
+  offsets.reserve(comments.size());
+  for (const auto &comment : comments) {
+    offsets.push_back(start + bytes.size());
+    bytes.append(encodeLine(comment));
+  }
+  if (!committer_.append(path, bytes)) {
+    if (QFile::exists(path)) {
+      QFile::resize(path, start);
+    }
+    return false;
+  }
+  thread.offsets += offsets;
+  for (const auto &comment : comments) {
+    pushRecent(thread.recent, comment);
+  }
+  return true;
+}
+
+QString CommentStore::threadPath(const EntityId &postId) const {
+  return dir_.filePath(postId.toString() + kThreadSuffix);
+}
+
+QByteArray CommentStore::encodeLine(const Comment &comment) {
+  JsonWriter writer(JsonWriter::Style::Compact);
+  comment.writeJson(writer);
+  QByteArray line = writer.take();
+  line.append('\n');
+  return line;
+}
+
+bool CommentStore::parseLine(const QByteArray &line, Comment &comment) {
+  QJsonParseError error;
+  const auto doc = QJsonDocument::fromJson(line, &error);
+  if (error.error != QJsonParseError::NoError || !doc.isObject()) {
+    return false;
+  }
+  comment = Comment::fromJson(doc.object());
+  return !comment.id.isEmpty();
+}
+
+void CommentStore::pushRecent(QVector<Comment> &recent,
+                              const Comment &comment) {
+  if (recent.size() == kRecentComments) {
+    recent.removeFirst();
+  }
+  recent.push_back(comment);
+}
+
+}  // namespace core
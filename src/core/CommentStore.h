@@ -0,0 +1,83 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QByteArray>
+#include <QDir>
+#include <QHash>
+#include <QMutex>
+#include <QVector>
+
+#include <memory>
+
+#include "Entities.h"
+#include "GroupCommit.h"
+
+namespace core {
+
+// CommentStore 把每条动态的评论保存在独立的追加式文件
+// comments/<postId>.jsonl 中，一行一条紧凑 JSON。评论不再写回动态作者的
+// 数据文件，热门动态只会争用自己那条评论串的锁。追加按 DurabilityOptions
+// 刷盘；内存中只缓存有限条评论串的行偏移，空闲的串超出上限后被丢弃。
+class CommentStore {
+ public:
+  // 动态随时间线附带的最近评论条数。
+  static constexpr int kRecentComments = 3;
+  // 默认最多缓存的评论串数。
+  static constexpr int kDefaultCachedThreads = 4096;
+
+  struct Summary {
+    int count = 0;
+    // 按时间顺序的最后几条评论。
+    QVector<Comment> recent;
+  };
+
+  explicit CommentStore(const QDir &baseDir,
+                        const DurabilityOptions &durability = {});
+
+  // 追加一条评论，写入并刷新后才更新内存中的摘要。
+  bool append(const EntityId &postId, const Comment &comment);
+  // 迁移旧数据：仅当该动态还没有评论文件时整串写入，重复调用无副作用。
+  bool importThread(const EntityId &postId, const QVector<Comment> &comments);
+  Summary summary(const EntityId &postId) const;
+  // 按时间顺序分页读取：跳过前 offset 条，最多 limit 条（负数表示不限）。
+  QVector<Comment> read(const EntityId &postId, int offset, int limit,
+                        int *total = nullptr) const;
+
+  // 缓存评论串数的上限；超出时丢弃最久未访问的空闲串，再次访问时重新扫描。
+  void setThreadCacheLimit(int threads);
+  int cachedThreads() const;
+
+ private:
+  // 单条评论串的状态：各行在文件中的起始偏移与最近评论，首次访问时扫描得到。
+  struct Thread {
+    QMutex mutex;
+    bool loaded = false;
+    QVector<qint64> offsets;
+    QVector<Comment> recent;
+    quint64 lastUsed = 0;  // 受 threadsMutex_ 保护
+  };
+
+  std::shared_ptr<Thread> thread(const EntityId &postId) const;
+  void ensureLoaded(const EntityId &postId, Thread &thread) const;
+  bool appendLines(const EntityId &postId, Thread &thread,
+                   const QVector<Comment> &comments) const;
+  QString threadPath(const EntityId &postId) const;
+  static QByteArray encodeLine(const Comment &comment);
+  static bool parseLine(const QByteArray &line, Comment &comment);
+  static void pushRecent(QVector<Comment> &recent, const Comment &comment);
+  void evictIdleThreads() const;
+
+  QDir dir_;
+  GroupCommitter committer_;
+  mutable QMutex threadsMutex_;
+  mutable QHash<EntityId, std::shared_ptr<Thread>> threads_;
+  mutable quint64 useTick_ = 0;
+  int threadCacheLimit_ = kDefaultCachedThreads;
+};
+
+}  // namespace core
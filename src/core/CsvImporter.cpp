@@ -0,0 +1,193 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "CsvImporter.h"
+
+#include "TimestampCodec.h"
+
+#include <QDateTime>
+#include <QTextStream>
+
+#include <cmath>
+
+namespace core {
+
+namespace {
+
+enum Column { kTimestamp, kAmount, kType, kCategory, kNote, kId };
+
+// 引号未闭合时记录跨越多行，需要继续读取。
+bool hasOpenQuote(const QString &record) {
+  return record.count(QLatin1Char('"')) % 2 != 0;
+}
+
+// 支持 ISO 8601 与常见的 "yyyy-MM-dd HH:mm[:ss]"、"yyyy/MM/dd" 格式。
+QDateTime parseTimestamp(const QString &text) {
+  QDateTime value = TimestampCodec::parse(text);
+  if (value.isValid()) {
+    return value;
+  }
+  static const char *const kFormats[] = {"yyyy-MM-dd HH:mm:ss",
+                                         "yyyy-MM-dd HH:mm", "yyyy/MM/dd HH:mm",
+                                         "yyyy-MM-dd", "yyyy/MM/dd"};
+  for (const char *format : kFormats) {
+    value = QDateTime::fromString(text, QLatin1String(format));
+    if (value.isValid()) {
+      return value;
+    }
+  }
+  return QDateTime();
+}
+
+// 识别中英文的收支类型，无法识别时返回 false。
+bool parseType(const QString &text, BillType &type) {
+  const QString lowered = text.trimmed().toLower();
+  if (lowered == "income" || lowered == "收入") {
+    type = BillType::Income;
+    return true;
+  }
+  if (lowered == "expense" || lowered == "支出") {
+    type = BillType::Expense;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace
+
+// 预先建立 ID 与名称两张哈希表，逐行查找为 O(1)。
+CsvBillImporter::CsvBillImporter(const QVector<Category> &categories) {
+  byId_.reserve(categories.size());
+  byName_.reserve(categories.size());
+  for (const auto &category : categories) {
+    byId_.insert(category.id.toString(), category);
+    byName_.insert(category.name, category);
+  }
+}
+
+// 按行流式读取，引号内的换行会把后续物理行拼入同一条记录。
+bool CsvBillImporter::parse(QIODevice &device, QVector<Bill> &outBills,
+                            QString &errorMessage) {
+  if (!device.isOpen() && !device.open(QIODevice::ReadOnly)) {
+    errorMessage = "无法读取导入文件";
+    return false;
+  }
+  if (!device.isReadable()) {
+    errorMessage = "无法读取导入文件";
+    return false;
+  }
+
+  QTextStream stream(&device);
+  stream.setCodec("UTF-8");
+  int lineNumber = 0;
+  bool firstRecord = true;
+  while (!stream.atEnd()) {
+    QString record = stream.readLine();
+    const int recordLine = ++lineNumber;
+    while (hasOpenQuote(record) && !stream.atEnd()) {
+      record += QLatin1Char('\n') + stream.readLine();
+      ++lineNumber;
+    }
+    if (record.trimmed().isEmpty()) {
+      continue;
+    }
+
+    const QStringList fields = splitRecord(record);
+    if (firstRecord) {
+      firstRecord = false;
+      // 首行的金额列无法解析为数字时视为表头。
+      bool numeric = false;
+      fields.value(kAmount).trimmed().toDouble(&numeric);
+      if (!numeric) {
+        continue;
+      }
+    }
+
+    Bill bill;
+    QString reason;
+    if (parseRecord(fields, bill, reason)) {
+      outBills.push_back(bill);
+    } else {
+      invalidRows_.push_back({recordLine, reason});
+    }
+  }
+  return true;
+}
+
+// 逐字符扫描，双引号内的逗号不分列，连续两个双引号表示一个字面量引号。
+QStringList CsvBillImporter::splitRecord(const QString &record) {
+  QStringList fields;
+  QString field;
+  bool quoted = false;
+  for (int i = 0; i < record.size(); ++i) {
+    const QChar ch = record.at(i);
+    if (quoted) {
+      if (ch == QLatin1Char('"')) {
+        if (i + 1 < record.size() && record.at(i + 1) == QLatin1Char('"')) {
+          field += ch;
+          ++i;
+        } else {
+          quoted = false;
+        }
+      } else {
+        field += ch;
+      }
+    } else if (ch == QLatin1Char('"')) {
+      quoted = true;
+    } else if (ch == QLatin1Char(',')) {
+      fields << field;
+      field.clear();
+    } else if (ch != QLatin1Char('\r')) {
+      field += ch;
+    }
+  }
+  fields << field;
+  return fields;
+}
+
+// 将一行字段转换为账单；负金额视为支出并取绝对值。
+bool CsvBillImporter::parseRecord(const QStringList &fields, Bill &bill,
+                                  QString &reason) const {
+  if (fields.size() <= kCategory) {
+    reason = "列数不足";
+    return false;
+  }
+
+  bill.timestamp = parseTimestamp(fields.at(kTimestamp).trimmed());
+  if (!bill.timestamp.isValid()) {
+    reason = "时间格式无效";
+    return false;
+  }
+
+  bool ok = false;
+  const double amount = fields.at(kAmount).trimmed().toDouble(&ok);
+  if (!ok || !std::isfinite(amount)) {
+    reason = "金额无效";
+    return false;
+  }
+  bill.amount = std::abs(amount);
+
+  const QString categoryKey = fields.at(kCategory).trimmed();
+  auto category = byId_.constFind(categoryKey);
+  if (category == byId_.constEnd()) {
+    category = byName_.constFind(categoryKey);
+    if (category == byName_.constEnd()) {
+      reason = "分类不存在";
+      return false;
+    }
+  }
+  bill.categoryId = category->id;
+
+  if (!parseType(fields.at(kType), bill.type)) {
+    const bool income = amount >= 0 && category->type == "income";
+    bill.type = income ? BillType::Income : BillType::Expense;
+  }
+  bill.note = fields.value(kNote).trimmed();
+  bill.id = fields.value(kId).trimmed();
+  return true;
+}
+
+}  // namespace core
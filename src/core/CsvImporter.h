@@ -0,0 +1,46 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include "Entities.h"
+
+#include <QHash>
+#include <QIODevice>
+#include <QPair>
+#include <QStringList>
+#include <QVector>
+
+namespace core {
+
+// CsvBillImporter 逐行解析银行流水等 CSV 文件，不把整个文件读入内存。
+// 列顺序：timestamp,amount,type,category,note[,id]，首行为表头时自动跳过。
+// category 可以是分类 ID 或分类名称；type 为空时按金额符号或分类类型推断。
+class CsvBillImporter {
+ public:
+  explicit CsvBillImporter(const QVector<Category> &categories);
+
+  // 解析设备中的全部行；仅在设备不可读时返回 false。
+  bool parse(QIODevice &device, QVector<Bill> &outBills,
+             QString &errorMessage);
+  // 解析失败的行（行号从 1 开始，原因）。
+  const QVector<QPair<int, QString>> &invalidRows() const {
+    return invalidRows_;
+  }
+
+  // 按 RFC 4180 拆分一条记录，支持引号与转义的双引号。
+  static QStringList splitRecord(const QString &record);
+
+ private:
+  bool parseRecord(const QStringList &fields, Bill &bill,
+                   QString &reason) const;
+
+  QHash<QString, Category> byId_;
+  QHash<QString, Category> byName_;
+  QVector<QPair<int, QString>> invalidRows_;
+};
+
+}  // namespace core
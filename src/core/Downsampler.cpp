@@ -0,0 +1,108 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "Downsampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace core {
+
+// 桶边界按浮点步长计算，首尾点单独处理，中间 threshold - 2 个桶。
+QVector<QPointF> Downsampler::lttb(const QVector<QPointF> &points,
+                                   int threshold) {
+  const int count = points.size();
+  if (threshold < 3 || count <= threshold) {
+    return points;
+  }
+
+  QVector<QPointF> sampled;
+  sampled.reserve(threshold);
+  sampled.push_back(points.first());
+
+  const double every = static_cast<double>(count - 2) / (threshold - 2);
+  int anchor = 0;
+  for (int bucket = 0; bucket < threshold - 2; ++bucket) {
+    // 下一个桶的平均点作为三角形的第三个顶点；最后一桶的下一桶只含末点。
+    const int nextStart = static_cast<int>((bucket + 1) * every) + 1;
+    const int nextEnd =
+        std::min(static_cast<int>((bucket + 2) * every) + 1, count);
+    double avgX = points.last().x();
+    double avgY = points.last().y();
+    if (nextStart < nextEnd) {
+      avgX = 0.0;
+      avgY = 0.0;
+      for (int i = nextStart; i < nextEnd; ++i) {
+        avgX += points[i].x();
+        avgY += points[i].y();
+      }
+      avgX /= nextEnd - nextStart;
+      avgY /= nextEnd - nextStart;
+    }
+
+    const int start = static_cast<int>(bucket * every) + 1;
+    const int end = std::min(nextStart, count - 1);
+    const QPointF &a = points[anchor];
+    double bestArea = -1.0;
+    int best = start;
+    for (int i = start; i < end; ++i) {
+      const double area =
+          std::fabs((a.x() - avgX) * (points[i].y() - a.y()) -
+                    (a.x() - points[i].x()) * (avgY - a.y()));
+      if (area > bestArea) {
+        bestArea = area;
+        best = i;
+      }
+    }
+    sampled.push_back(points[best]);
+    anchor = best;
+  }
+
+  sampled.push_back(points.last());
+  return sampled;
+}
+
+// 桶内最小、最大值点按原有先后顺序输出，折线在桶内仍保持时间方向。
+QVector<QPointF> Downsampler::minMax(const QVector<QPointF> &points,
+                                     int buckets) {
+  const int count = points.size();
+  if (buckets < 1 || count <= 2 * buckets) {
+    return points;
+  }
+  const double minX = points.first().x();
+  const double span = points.last().x() - minX;
+  if (!(span > 0.0)) {
+    return {points.first(), points.last()};
+  }
+
+  QVector<QPointF> sampled;
+  sampled.reserve(2 * buckets);
+  int i = 0;
+  for (int bucket = 0; bucket < buckets && i < count; ++bucket) {
+    const double bucketEnd = minX + span * (bucket + 1) / buckets;
+    const bool lastBucket = bucket == buckets - 1;
+    int low = i;
+    int high = i;
+    for (; i < count && (lastBucket || points[i].x() < bucketEnd); ++i) {
+      if (points[i].y() < points[low].y()) {
+        low = i;
+      }
+      if (points[i].y() > points[high].y()) {
+        high = i;
+      }
+    }
+    if (i == low && i == high) {
+      continue;  // 空桶：循环没有前进
+    }
+    sampled.push_back(points[std::min(low, high)]);
+    if (low != high) {
+      sampled.push_back(points[std::max(low, high)]);
+    }
+  }
+  return sampled;
+}
+
+}  // namespace core
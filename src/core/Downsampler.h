@@ -0,0 +1,28 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QPointF>
+#include <QVector>
+
+namespace core {
+
+// Downsampler 把按 x 升序排列的长序列压缩到给定点数以内，
+// 使图表绘制的代价只与屏幕宽度相关，与时间跨度无关。
+class Downsampler {
+ public:
+  // Largest-Triangle-Three-Buckets：保留首尾点，中间每桶选出与相邻桶
+  // 构成最大三角形面积的点，视觉形状最接近原序列。返回恰好 threshold 个点；
+  // 点数不超过 threshold 或 threshold < 3 时原样返回。
+  static QVector<QPointF> lttb(const QVector<QPointF> &points, int threshold);
+
+  // 按 x 区间等分为 buckets 个桶（通常取像素宽度），每桶保留最小与最大值点，
+  // 尖峰一定不会丢失。返回不超过 2 * buckets 个点，按 x 升序。
+  static QVector<QPointF> minMax(const QVector<QPointF> &points, int buckets);
+};
+
+}  // namespace core
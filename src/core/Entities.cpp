@@ -6,165 +6,245 @@
 
 #include "Entities.h"
 
+#include "EntityFields.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+
 #include <QJsonDocument>
 #include <QJsonValue>
 
+#include <utility>
+
 namespace core {
 
-// 将枚举类型转换为 JSON 中使用的字符串表示。
-static QString billTypeToString(BillType type) {
-  return type == BillType::Income ? "income" : "expense";
+namespace {
+
+// 索引与容器同步时哈希命中即返回，否则线性扫描兜底。
+template <typename T>
+int findIn(const QVector<T> &items, const EntityIndex &index,
+           const EntityId &id) {
+  if (index.size() == items.size()) {
+    const int at = index.find(id);
+    if (at < 0 || (at < items.size() && items[at].id == id)) {
+      return at;
+    }
+  }
+  for (int i = 0; i < items.size(); ++i) {
+    if (items[i].id == id) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+// 重复的 ID 会让索引永远比容器小，查找每次都退化为线性扫描：只保留
+// 第一次出现的实体（也是线性扫描原本命中的那个）。没有重复时不改动容器，
+// 不会触发隐式共享的深拷贝。
+template <typename T>
+void rebuildUnique(QVector<T> &items, EntityIndex &index) {
+  index.clear();
+  index.reserve(items.size());
+  int kept = 0;
+  for (int i = 0; i < items.size(); ++i) {
+    const EntityId &id = items.at(i).id;
+    if (index.find(id) >= 0) {
+      continue;
+    }
+    index.insert(id, kept);
+    if (kept != i) {
+      items[kept] = std::move(items[i]);
+    }
+    ++kept;
+  }
+  if (kept != items.size()) {
+    items.resize(kept);
+  }
 }
 
-// 根据存储的字符串恢复枚举类型，默认视为支出。
-static BillType billTypeFromString(const QString &value) {
-  return value == "income" ? BillType::Income : BillType::Expense;
+template <typename T>
+int putIn(QVector<T> &items, EntityIndex &index, const T &item) {
+  if (index.size() != items.size()) {
+    rebuildUnique(items, index);
+  }
+  const int at = index.find(item.id);
+  if (at >= 0) {
+    items[at] = item;
+    return at;
+  }
+  index.insert(item.id, items.size());
+  items.push_back(item);
+  return items.size() - 1;
 }
 
-// Category 序列化，将核心字段写入 JSON 结构。
-QJsonObject Category::toJson() const {
+// 末尾元素移入空位，只需更新一条索引。
+template <typename T>
+void swapRemoveAt(QVector<T> &items, EntityIndex &index, int at) {
+  if (index.size() != items.size()) {
+    index.rebuild(items);
+  }
+  index.erase(items[at].id);
+  const int last = items.size() - 1;
+  if (at != last) {
+    items[at] = std::move(items[last]);
+    index.insert(items[at].id, at);
+  }
+  items.removeLast();
+}
+
+}  // namespace
+
+// 字段表见 EntityFields.h，下列成员函数只是生成代码的入口。
+template <typename T>
+static QJsonObject toJsonObject(const T &value) {
   QJsonObject obj;
-  obj["id"] = id;
-  obj["name"] = name;
-  obj["type"] = type;
+  reflect::toJson(value, obj);
   return obj;
 }
 
-// Category 反序列化，容错未知字段。
+// value 携带 JSON 中缺失字段时使用的默认值。
+template <typename T>
+static T fromJsonObject(const QJsonObject &obj, T value = T()) {
+  reflect::fromJson(obj, value);
+  return value;
+}
+
+// 流式读取同理，value 携带缺失字段的默认值。
+template <typename T>
+static T readObject(JsonReader &in, T value = T()) {
+  reflect::read(in, value);
+  return value;
+}
+
+QJsonObject Category::toJson() const { return toJsonObject(*this); }
+
+void Category::writeJson(JsonWriter &out) const {
+  reflect::writeJson(out, *this);
+}
+
+// 未提供类型的分类视为支出分类。
 Category Category::fromJson(const QJsonObject &obj) {
   Category category;
-  category.id = obj.value("id").toString();
-  category.name = obj.value("name").toString();
-  category.type = obj.value("type").toString("expense");
-  return category;
+  category.type = "expense";
+  return fromJsonObject(obj, category);
 }
 
-// Bill 序列化，确保时间戳与类型能恢复。
-QJsonObject Bill::toJson() const {
-  QJsonObject obj;
-  obj["id"] = id;
-  obj["amount"] = amount;
-  obj["categoryId"] = categoryId;
-  obj["note"] = note;
-  obj["timestamp"] = timestamp.toString(Qt::ISODate);
-  obj["type"] = billTypeToString(type);
-  return obj;
+Category Category::readJson(JsonReader &in) {
+  Category category;
+  category.type = "expense";
+  return readObject(in, category);
 }
 
-// Bill 反序列化，未提供类型时默认为支出。
+QJsonObject Bill::toJson() const { return toJsonObject(*this); }
+
+void Bill::writeJson(JsonWriter &out) const { reflect::writeJson(out, *this); }
+
 Bill Bill::fromJson(const QJsonObject &obj) {
-  Bill bill;
-  bill.id = obj.value("id").toString();
-  bill.amount = obj.value("amount").toDouble();
-  bill.categoryId = obj.value("categoryId").toString();
-  bill.note = obj.value("note").toString();
-  bill.timestamp =
-      QDateTime::fromString(obj.value("timestamp").toString(), Qt::ISODate);
-  bill.type = billTypeFromString(obj.value("type").toString());
-  return bill;
-}
-
-// Reminder 序列化。
-QJsonObject Reminder::toJson() const {
-  QJsonObject obj;
-  obj["id"] = id;
-  obj["message"] = message;
-  obj["remindAt"] = remindAt.toString(Qt::ISODate);
-  obj["enabled"] = enabled;
-  return obj;
+  return fromJsonObject<Bill>(obj);
+}
+
+Bill Bill::readJson(JsonReader &in) { return readObject<Bill>(in); }
+
+QJsonObject Reminder::toJson() const { return toJsonObject(*this); }
+
+void Reminder::writeJson(JsonWriter &out) const {
+  reflect::writeJson(out, *this);
 }
 
-// Reminder 反序列化。
 Reminder Reminder::fromJson(const QJsonObject &obj) {
-  Reminder reminder;
-  reminder.id = obj.value("id").toString();
-  reminder.message = obj.value("message").toString();
-  reminder.remindAt =
-      QDateTime::fromString(obj.value("remindAt").toString(), Qt::ISODate);
-  reminder.enabled = obj.value("enabled").toBool(true);
-  return reminder;
+  return fromJsonObject<Reminder>(obj);
 }
 
-// Comment 序列化。
-QJsonObject Comment::toJson() const {
-  QJsonObject obj;
-  obj["id"] = id;
-  obj["authorId"] = authorId;
-  obj["content"] = content;
-  obj["createdAt"] = createdAt.toString(Qt::ISODate);
-  return obj;
+Reminder Reminder::readJson(JsonReader &in) { return readObject<Reminder>(in); }
+
+QJsonObject Comment::toJson() const { return toJsonObject(*this); }
+
+void Comment::writeJson(JsonWriter &out) const {
+  reflect::writeJson(out, *this);
 }
 
-// Comment 反序列化。
 Comment Comment::fromJson(const QJsonObject &obj) {
-  Comment comment;
-  comment.id = obj.value("id").toString();
-  comment.authorId = obj.value("authorId").toString();
-  comment.content = obj.value("content").toString();
-  comment.createdAt =
-      QDateTime::fromString(obj.value("createdAt").toString(), Qt::ISODate);
-  return comment;
+  return fromJsonObject<Comment>(obj);
 }
 
-// SocialPost 序列化，附带评论列表。
-QJsonObject SocialPost::toJson() const {
-  QJsonObject obj;
-  obj["id"] = id;
-  obj["authorId"] = authorId;
-  obj["content"] = content;
-  obj["visibility"] = visibility;
-  obj["createdAt"] = createdAt.toString(Qt::ISODate);
-  QJsonArray commentsArray;
-  for (const auto &comment : comments) {
-    commentsArray.append(comment.toJson());
-  }
-  obj["comments"] = commentsArray;
-  return obj;
+Comment Comment::readJson(JsonReader &in) { return readObject<Comment>(in); }
+
+QJsonObject SocialPost::toJson() const { return toJsonObject(*this); }
+
+void SocialPost::writeJson(JsonWriter &out) const {
+  reflect::writeJson(out, *this);
 }
 
-// SocialPost 反序列化，逐条恢复评论。
 SocialPost SocialPost::fromJson(const QJsonObject &obj) {
-  SocialPost post;
-  post.id = obj.value("id").toString();
-  post.authorId = obj.value("authorId").toString();
-  post.content = obj.value("content").toString();
-  post.visibility = obj.value("visibility").toString("public");
-  post.createdAt =
-      QDateTime::fromString(obj.value("createdAt").toString(), Qt::ISODate);
-  const auto commentsArray = obj.value("comments").toArray();
-  for (const auto &value : commentsArray) {
-    post.comments.push_back(Comment::fromJson(value.toObject()));
-  }
-  return post;
+  return fromJsonObject<SocialPost>(obj);
 }
 
-// UserProfile 序列化。
-QJsonObject UserProfile::toJson() const {
-  QJsonObject obj;
-  obj["id"] = id;
-  obj["username"] = username;
-  obj["email"] = email;
-  obj["passwordHash"] = passwordHash;
-  obj["notificationsEnabled"] = notificationsEnabled;
-  obj["privacyLevel"] = privacyLevel;
-  obj["friendIds"] = QJsonArray::fromStringList(friendIds);
-  return obj;
+SocialPost SocialPost::readJson(JsonReader &in) {
+  return readObject<SocialPost>(in);
+}
+
+QJsonObject UserProfile::toJson() const { return toJsonObject(*this); }
+
+void UserProfile::writeJson(JsonWriter &out) const {
+  reflect::writeJson(out, *this);
 }
 
-// UserProfile 反序列化。
 UserProfile UserProfile::fromJson(const QJsonObject &obj) {
-  UserProfile profile;
-  profile.id = obj.value("id").toString();
-  profile.username = obj.value("username").toString();
-  profile.email = obj.value("email").toString();
-  profile.passwordHash = obj.value("passwordHash").toString();
-  profile.notificationsEnabled = obj.value("notificationsEnabled").toBool(true);
-  profile.privacyLevel = obj.value("privacyLevel").toString("friends");
-  const auto friendArray = obj.value("friendIds").toArray();
-  for (const auto &value : friendArray) {
-    profile.friendIds.append(value.toString());
-  }
-  return profile;
+  return fromJsonObject<UserProfile>(obj);
+}
+
+UserProfile UserProfile::readJson(JsonReader &in) {
+  return readObject<UserProfile>(in);
+}
+
+void UserData::reindex() {
+  rebuildUnique(categories, categoryIndex);
+  rebuildUnique(bills, billIndex);
+  rebuildUnique(reminders, reminderIndex);
+  rebuildUnique(posts, postIndex);
+}
+
+int UserData::findCategory(const EntityId &id) const {
+  return findIn(categories, categoryIndex, id);
+}
+
+int UserData::findBill(const EntityId &id) const {
+  return findIn(bills, billIndex, id);
+}
+
+int UserData::findReminder(const EntityId &id) const {
+  return findIn(reminders, reminderIndex, id);
+}
+
+int UserData::findPost(const EntityId &id) const {
+  return findIn(posts, postIndex, id);
+}
+
+int UserData::putCategory(const Category &category) {
+  return putIn(categories, categoryIndex, category);
+}
+
+int UserData::putBill(const Bill &bill) {
+  return putIn(bills, billIndex, bill);
+}
+
+int UserData::putReminder(const Reminder &reminder) {
+  return putIn(reminders, reminderIndex, reminder);
+}
+
+int UserData::putPost(const SocialPost &post) {
+  return putIn(posts, postIndex, post);
+}
+
+// 分类数量很少，删除后整体重建索引即可。
+void UserData::eraseCategoryAt(int index) {
+  categories.removeAt(index);
+  categoryIndex.rebuild(categories);
+}
+
+void UserData::eraseBillAt(int index) { swapRemoveAt(bills, billIndex, index); }
+
+void UserData::eraseReminderAt(int index) {
+  swapRemoveAt(reminders, reminderIndex, index);
 }
 
 }  // namespace core
@@ -7,74 +7,95 @@
 #pragma once
 
 #include <QDateTime>
+#include <QHash>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QString>
 #include <QStringList>
 #include <QVector>
 
+#include "EntityId.h"
+#include "Rollups.h"
+
 namespace core {
 
+class JsonReader;
+class JsonWriter;
+
 // 领域模型的基础数据结构，仅包含数值字段与序列化接口，便于在核心逻辑与存储之间复用。
 
 enum class BillType { Income, Expense };
 
 // Category 描述用户自定义的账目分类信息。
 struct Category {
-  QString id;
+  EntityId id;
   QString name;
   QString type;  // "income" or "expense"
 
   QJsonObject toJson() const;
+  void writeJson(JsonWriter &out) const;
   static Category fromJson(const QJsonObject &obj);
+  static Category readJson(JsonReader &in);
 };
 
 // Bill 表示一次收支记录，包含金额、分类、类型等信息。
 struct Bill {
-  QString id;
+  EntityId id;
   double amount = 0.0;
-  QString categoryId;
+  EntityId categoryId;
   QString note;
   QDateTime timestamp;
   BillType type = BillType::Expense;
 
   QJsonObject toJson() const;
+  void writeJson(JsonWriter &out) const;
   static Bill fromJson(const QJsonObject &obj);
+  static Bill readJson(JsonReader &in);
 };
 
 // Reminder 保存用户自定义提醒的文本与触发时间。
 struct Reminder {
-  QString id;
+  EntityId id;
   QString message;
   QDateTime remindAt;
   bool enabled = true;
 
   QJsonObject toJson() const;
+  void writeJson(JsonWriter &out) const;
   static Reminder fromJson(const QJsonObject &obj);
+  static Reminder readJson(JsonReader &in);
 };
 
 // Comment 用于社交动态下的评论内容。
 struct Comment {
-  QString id;
-  QString authorId;
+  EntityId id;
+  EntityId authorId;
   QString content;
   QDateTime createdAt;
 
   QJsonObject toJson() const;
+  void writeJson(JsonWriter &out) const;
   static Comment fromJson(const QJsonObject &obj);
+  static Comment readJson(JsonReader &in);
 };
 
-// SocialPost 表示一条用户动态，可附带评论列表。
+// SocialPost 表示一条用户动态。完整评论串保存在 CommentStore 中，
+// 读取时只附带评论总数与最近几条评论。
 struct SocialPost {
-  QString id;
-  QString authorId;
+  EntityId id;
+  EntityId authorId;
   QString content;
-  QString visibility;  // "public" or "friends"
+  PostVisibility visibility = PostVisibility::Public;
   QDateTime createdAt;
+  // 最近的评论；旧版数据文件中内嵌的完整评论在加载时迁入评论库。
   QVector<Comment> comments;
+  // 评论总数，读取时由评论库填充，不写入数据文件。
+  int commentCount = 0;
 
   QJsonObject toJson() const;
+  void writeJson(JsonWriter &out) const;
   static SocialPost fromJson(const QJsonObject &obj);
+  static SocialPost readJson(JsonReader &in);
 };
 
 // UserProfile 存储用户的基本资料与社交关系。
@@ -88,16 +109,73 @@ struct UserProfile {
   QStringList friendIds;
 
   QJsonObject toJson() const;
+  void writeJson(JsonWriter &out) const;
   static UserProfile fromJson(const QJsonObject &obj);
+  static UserProfile readJson(JsonReader &in);
+};
+
+// EntityIndex 维护实体 ID 到容器下标的映射，随容器的插入与删除同步更新。
+class EntityIndex {
+ public:
+  template <typename T>
+  void rebuild(const QVector<T> &items) {
+    slots_.clear();
+    slots_.reserve(items.size());
+    for (int i = 0; i < items.size(); ++i) {
+      slots_.insert(items[i].id, i);
+    }
+  }
+  void clear() { slots_.clear(); }
+  void reserve(int size) { slots_.reserve(size); }
+  int find(const EntityId &id) const { return slots_.value(id, -1); }
+  void insert(const EntityId &id, int index) { slots_.insert(id, index); }
+  void erase(const EntityId &id) { slots_.remove(id); }
+  int size() const { return slots_.size(); }
+
+ private:
+  QHash<EntityId, int> slots_;
 };
 
 // UserData 汇总单个用户的所有业务数据片段。
+// 账单、分类、提醒与动态各带一份 ID 索引，通过下方的 find/put/erase 接口
+// 维护；直接改动容器（如事务回调）后需调用 reindex()。索引与容器大小
+// 不一致时查找退化为线性扫描，写入接口会先重建索引。重建时同一 ID 只保留
+// 第一次出现的实体，索引因此总能与容器重新对齐。
 struct UserData {
   UserProfile profile;
   QVector<Category> categories;
   QVector<Bill> bills;
   QVector<Reminder> reminders;
   QVector<SocialPost> posts;
+  // 账单的日历预聚合，随账单增量维护并一同持久化。
+  CalendarRollups rollups;
+  // 已移入冷归档的账单按月的摘要；bills 与 rollups 只含未归档的账单。
+  QVector<ArchiveSegment> archive;
+
+  EntityIndex categoryIndex;
+  EntityIndex billIndex;
+  EntityIndex reminderIndex;
+  EntityIndex postIndex;
+
+  // 按当前容器内容重建全部 ID 索引，并去掉 ID 重复的实体。
+  void reindex();
+
+  // 按 ID 返回下标，未找到返回 -1。
+  int findCategory(const EntityId &id) const;
+  int findBill(const EntityId &id) const;
+  int findReminder(const EntityId &id) const;
+  int findPost(const EntityId &id) const;
+
+  // 同 ID 则原位替换，否则追加；返回实体所在下标。
+  int putCategory(const Category &category);
+  int putBill(const Bill &bill);
+  int putReminder(const Reminder &reminder);
+  int putPost(const SocialPost &post);
+
+  // 分类删除保持原有顺序（供界面展示）；账单与提醒与末尾元素交换后弹出。
+  void eraseCategoryAt(int index);
+  void eraseBillAt(int index);
+  void eraseReminderAt(int index);
 };
 
 }  // namespace core
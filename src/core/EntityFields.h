@@ -0,0 +1,144 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include "Entities.h"
+#include "Reflection.h"
+
+namespace core {
+namespace reflect {
+
+// 领域实体的字段表：新增字段只需在这里登记一次（保持键名升序），
+// JSON、流式 JSON 与二进制编解码随之生成。
+
+template <>
+struct Codec<BillType> {
+  static QLatin1String text(BillType value) {
+    return value == BillType::Income ? QLatin1String("income")
+                                     : QLatin1String("expense");
+  }
+  static QJsonValue toJson(BillType value) { return text(value); }
+  static void write(JsonWriter &out, BillType value) {
+    out.value(text(value));
+  }
+  // 无法识别的取值按支出处理。
+  static void fromJson(const QJsonValue &json, BillType &value) {
+    value = json.toString() == QLatin1String("income") ? BillType::Income
+                                                       : BillType::Expense;
+  }
+  static void read(JsonReader &in, BillType &value) {
+    QString text;
+    in.readString(text);
+    value = text == QLatin1String("income") ? BillType::Income
+                                            : BillType::Expense;
+  }
+  static void save(QDataStream &out, BillType value) {
+    out << static_cast<quint8>(value);
+  }
+  static void load(QDataStream &in, BillType &value) {
+    quint8 raw = 0;
+    in >> raw;
+    value = raw == static_cast<quint8>(BillType::Income) ? BillType::Income
+                                                         : BillType::Expense;
+  }
+};
+
+template <>
+struct Codec<PostVisibility> {
+  static QLatin1String text(PostVisibility value) {
+    return value == PostVisibility::Friends ? QLatin1String("friends")
+                                            : QLatin1String("public");
+  }
+  static QJsonValue toJson(PostVisibility value) { return text(value); }
+  static void write(JsonWriter &out, PostVisibility value) {
+    out.value(text(value));
+  }
+  // 非字符串保持原值；无法识别的文本按更严格的仅好友处理。
+  static void fromJson(const QJsonValue &json, PostVisibility &value) {
+    if (!parseVisibility(json.toString(visibilityToString(value)), value)) {
+      value = PostVisibility::Friends;
+    }
+  }
+  static void read(JsonReader &in, PostVisibility &value) {
+    QString text;
+    if (in.readString(text) && !parseVisibility(text, value)) {
+      value = PostVisibility::Friends;
+    }
+  }
+  static void save(QDataStream &out, PostVisibility value) {
+    out << static_cast<quint8>(value);
+  }
+  static void load(QDataStream &in, PostVisibility &value) {
+    quint8 raw = 0;
+    in >> raw;
+    value = raw == static_cast<quint8>(PostVisibility::Public)
+                ? PostVisibility::Public
+                : PostVisibility::Friends;
+  }
+};
+
+template <>
+struct Describe<Category> {
+  static constexpr auto fields =
+      std::make_tuple(field("id", &Category::id),
+                      field("name", &Category::name),
+                      field("type", &Category::type));
+};
+
+template <>
+struct Describe<Bill> {
+  static constexpr auto fields =
+      std::make_tuple(field("amount", &Bill::amount),
+                      field("categoryId", &Bill::categoryId),
+                      field("id", &Bill::id), field("note", &Bill::note),
+                      field("timestamp", &Bill::timestamp),
+                      field("type", &Bill::type));
+};
+
+template <>
+struct Describe<Reminder> {
+  static constexpr auto fields =
+      std::make_tuple(field("enabled", &Reminder::enabled),
+                      field("id", &Reminder::id),
+                      field("message", &Reminder::message),
+                      field("remindAt", &Reminder::remindAt));
+};
+
+template <>
+struct Describe<Comment> {
+  static constexpr auto fields =
+      std::make_tuple(field("authorId", &Comment::authorId),
+                      field("content", &Comment::content),
+                      field("createdAt", &Comment::createdAt),
+                      field("id", &Comment::id));
+};
+
+template <>
+struct Describe<SocialPost> {
+  static constexpr auto fields =
+      std::make_tuple(field("authorId", &SocialPost::authorId),
+                      field("comments", &SocialPost::comments),
+                      field("content", &SocialPost::content),
+                      field("createdAt", &SocialPost::createdAt),
+                      field("id", &SocialPost::id),
+                      field("visibility", &SocialPost::visibility));
+};
+
+template <>
+struct Describe<UserProfile> {
+  static constexpr auto fields = std::make_tuple(
+      field("email", &UserProfile::email),
+      field("friendIds", &UserProfile::friendIds),
+      field("id", &UserProfile::id),
+      field("notificationsEnabled", &UserProfile::notificationsEnabled),
+      field("passwordHash", &UserProfile::passwordHash),
+      field("privacyLevel", &UserProfile::privacyLevel),
+      field("username", &UserProfile::username));
+};
+
+}  // namespace reflect
+}  // namespace core
@@ -0,0 +1,196 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "EntityId.h"
+
+#include <QHash>
+#include <QReadLocker>
+#include <QReadWriteLock>
+#include <QVector>
+#include <QWriteLocker>
+
+namespace core {
+
+namespace {
+
+constexpr int kUuidLength = 36;
+
+// 驻留表只增不减，条目数与历史上出现过的非 UUID 文本数相当。
+struct InternTable {
+  QReadWriteLock lock;
+  QHash<QString, quint64> slots;
+  QVector<QString> texts;
+};
+
+InternTable &internTable() {
+  static InternTable table;
+  return table;
+}
+
+// 未登记时返回 0。
+quint64 findInterned(const QString &text) {
+  auto &table = internTable();
+  QReadLocker locker(&table.lock);
+  return table.slots.value(text, 0);
+}
+
+quint64 intern(const QString &text) {
+  auto &table = internTable();
+  {
+    QReadLocker locker(&table.lock);
+    const auto it = table.slots.constFind(text);
+    if (it != table.slots.constEnd()) {
+      return it.value();
+    }
+  }
+  QWriteLocker locker(&table.lock);
+  const auto it = table.slots.constFind(text);
+  if (it != table.slots.constEnd()) {
+    return it.value();
+  }
+  table.texts.push_back(text);
+  const quint64 slot = static_cast<quint64>(table.texts.size());
+  table.slots.insert(text, slot);
+  return slot;
+}
+
+int hexValue(ushort ch) {
+  if (ch >= '0' && ch <= '9') {
+    return ch - '0';
+  }
+  if (ch >= 'a' && ch <= 'f') {
+    return ch - 'a' + 10;
+  }
+  return -1;
+}
+
+ushort code(QChar ch) { return ch.unicode(); }
+ushort code(char ch) { return static_cast<uchar>(ch); }
+
+// 只接受 QUuid::WithoutBraces 产生的小写形式，保证 toString 可逆。
+template <typename Char>
+bool parseUuid(const Char *data, int size, quint64 &high, quint64 &low) {
+  if (size != kUuidLength) {
+    return false;
+  }
+  quint64 parts[2] = {0, 0};
+  int nibbles = 0;
+  for (int i = 0; i < kUuidLength; ++i) {
+    const ushort ch = code(data[i]);
+    if (i == 8 || i == 13 || i == 18 || i == 23) {
+      if (ch != '-') {
+        return false;
+      }
+      continue;
+    }
+    const int value = hexValue(ch);
+    if (value < 0) {
+      return false;
+    }
+    auto &part = parts[nibbles / 16];
+    part = (part << 4) | static_cast<quint64>(value);
+    ++nibbles;
+  }
+  high = parts[0];
+  low = parts[1];
+  return true;
+}
+
+}  // namespace
+
+EntityId::EntityId(const QString &text) {
+  if (text.isEmpty()) {
+    return;
+  }
+  if (parseUuid(text.constData(), text.size(), high_, low_) &&
+      high_ != kInternedTag && (high_ != 0 || low_ != 0)) {
+    return;
+  }
+  high_ = kInternedTag;
+  low_ = intern(text);
+}
+
+bool EntityId::lookup(const QString &text, EntityId &out) {
+  EntityId id;
+  if (!text.isEmpty() &&
+      !(parseUuid(text.constData(), text.size(), id.high_, id.low_) &&
+        id.high_ != kInternedTag && (id.high_ != 0 || id.low_ != 0))) {
+    id.high_ = kInternedTag;
+    id.low_ = findInterned(text);
+    if (id.low_ == 0) {
+      return false;
+    }
+  }
+  out = id;
+  return true;
+}
+
+bool EntityId::lessInterned(const EntityId &a, const EntityId &b) {
+  return a.low_ != b.low_ && a.toString() < b.toString();
+}
+
+EntityId::EntityId(const char *text) : EntityId(QString::fromUtf8(text)) {}
+
+// UUID 形式直接从字节解析；其余文本才构造 QString 走驻留表。
+EntityId EntityId::fromUtf8(const char *data, int size) {
+  EntityId id;
+  if (parseUuid(data, size, id.high_, id.low_) && id.high_ != kInternedTag &&
+      (id.high_ != 0 || id.low_ != 0)) {
+    return id;
+  }
+  return EntityId(QString::fromUtf8(data, size));
+}
+
+EntityId EntityId::fromParts(quint64 high, quint64 low) {
+  EntityId id;
+  id.high_ = high;
+  id.low_ = low;
+  return id;
+}
+
+QString EntityId::toString() const {
+  if (isEmpty()) {
+    return QString();
+  }
+  if (isInterned()) {
+    auto &table = internTable();
+    QReadLocker locker(&table.lock);
+    return table.texts.value(static_cast<int>(low_) - 1);
+  }
+  static const char kDigits[] = "0123456789abcdef";
+  QString text(kUuidLength, QLatin1Char('-'));
+  QChar *out = text.data();
+  int nibble = 0;
+  for (int i = 0; i < kUuidLength; ++i) {
+    if (i == 8 || i == 13 || i == 18 || i == 23) {
+      continue;
+    }
+    const quint64 part = nibble < 16 ? high_ : low_;
+    const int shift = (15 - nibble % 16) * 4;
+    out[i] = QLatin1Char(kDigits[(part >> shift) & 0xF]);
+    ++nibble;
+  }
+  return text;
+}
+
+QString visibilityToString(PostVisibility visibility) {
+  return visibility == PostVisibility::Friends ? QStringLiteral("friends")
+                                               : QStringLiteral("public");
+}
+
+bool parseVisibility(const QString &value, PostVisibility &out) {
+  if (value == QLatin1String("public")) {
+    out = PostVisibility::Public;
+    return true;
+  }
+  if (value == QLatin1String("friends")) {
+    out = PostVisibility::Friends;
+    return true;
+  }
+  return false;
+}
+
+}  // namespace core
@@ -0,0 +1,79 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QtGlobal>
+
+namespace core {
+
+// EntityId 以两个 64 位整数保存实体 ID，只在序列化边界与文本互转。
+// 小写无括号的 UUID 文本直接解析为 128 位值；其他文本（旧数据或测试中的
+// 短 ID）登记到进程级驻留表，以表内序号编码，同样可以 O(1) 比较与哈希。
+// 两种编码都能无损还原为原始文本。驻留表只增不减，来自客户端的文本须先
+// 经 lookup 检查，只有存储中加载的 ID 才登记。
+class EntityId {
+ public:
+  EntityId() = default;
+  // 允许从文本隐式构造，便于接口继续接受 QString 参数。
+  EntityId(const QString &text);  // NOLINT(runtime/explicit)
+  EntityId(const char *text);     // NOLINT(runtime/explicit)
+
+  // 不登记的查找：空文本、UUID 或已驻留的文本返回 true 并写入 out，
+  // 其余文本返回 false，不可能对应任何已加载的实体。
+  static bool lookup(const QString &text, EntityId &out);
+
+  // 由 128 位数值直接构造，供 ID 生成器使用。
+  static EntityId fromParts(quint64 high, quint64 low);
+  // 从 UTF-8 字节构造，等价于 EntityId(QString::fromUtf8(data, size))。
+  static EntityId fromUtf8(const char *data, int size);
+
+  QString toString() const;
+  bool isEmpty() const { return high_ == 0 && low_ == 0; }
+  bool isInterned() const { return high_ == kInternedTag; }
+  quint64 high() const { return high_; }
+  quint64 low() const { return low_; }
+
+  friend bool operator==(const EntityId &a, const EntityId &b) {
+    return a.high_ == b.high_ && a.low_ == b.low_;
+  }
+  friend bool operator!=(const EntityId &a, const EntityId &b) {
+    return !(a == b);
+  }
+  // 驻留 ID 按文本排序，与登记先后无关，不同进程中的顺序一致。
+  friend bool operator<(const EntityId &a, const EntityId &b) {
+    if (a.high_ != b.high_) {
+      return a.high_ < b.high_;
+    }
+    return a.isInterned() ? lessInterned(a, b) : a.low_ < b.low_;
+  }
+
+ private:
+  static bool lessInterned(const EntityId &a, const EntityId &b);
+
+  // 驻留 ID 的高位标记；解析出同样高位的 UUID 文本也走驻留表。
+  static constexpr quint64 kInternedTag = ~quint64(0);
+
+  quint64 high_ = 0;
+  quint64 low_ = 0;
+};
+
+// 两个 64 位分量混合后折叠为 32 位；不转调 qHash(quint64)，以免被本重载遮蔽。
+inline uint qHash(const EntityId &id, uint seed = 0) {
+  const quint64 mixed = id.high() ^ (id.low() * 0x9E3779B97F4A7C15ULL);
+  return static_cast<uint>(mixed ^ (mixed >> 32)) ^ seed;
+}
+
+// 动态可见范围。
+enum class PostVisibility { Public, Friends };
+
+// 与 JSON / 接口中的 "public"、"friends" 互转；无法识别的文本返回 false。
+QString visibilityToString(PostVisibility visibility);
+bool parseVisibility(const QString &value, PostVisibility &out);
+
+}  // namespace core
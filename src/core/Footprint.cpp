@@ -0,0 +1,86 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "Footprint.h"
+
+namespace core {
+
+namespace {
+
+// Qt 字符串与容器共用的数据头（引用计数、长度、容量、偏移）。
+constexpr qint64 kArrayHeader = sizeof(QArrayData);
+// EntityIndex 的每个节点：next 指针、缓存的哈希值、键与下标，外加一个桶指针。
+constexpr qint64 kIndexEntry =
+    2 * sizeof(void *) + sizeof(uint) + sizeof(EntityId) + sizeof(int);
+
+qint64 stringBytes(const QString &text) {
+  return text.isEmpty() ? 0
+                        : kArrayHeader + (text.capacity() + 1) * sizeof(QChar);
+}
+
+template <typename T>
+qint64 vectorBytes(const QVector<T> &items) {
+  return items.capacity() == 0 ? 0
+                                : kArrayHeader + items.capacity() * sizeof(T);
+}
+
+qint64 indexBytes(const EntityIndex &index) {
+  return index.size() * kIndexEntry;
+}
+
+// 归档段摘要：每段一个按分类的哈希表，节点结构同上。
+qint64 archiveBytes(const QVector<ArchiveSegment> &archive) {
+  constexpr qint64 kTotalsEntry = 2 * sizeof(void *) + sizeof(uint) +
+                                  sizeof(EntityId) + sizeof(RollupTotals);
+  qint64 bytes = vectorBytes(archive);
+  for (const auto &segment : archive) {
+    bytes += segment.byCategory.capacity() * sizeof(void *) +
+             segment.byCategory.size() * kTotalsEntry;
+  }
+  return bytes;
+}
+
+}  // namespace
+
+MemoryFootprint MemoryFootprint::of(const UserData &data) {
+  MemoryFootprint footprint;
+  footprint.bills = vectorBytes(data.bills) + indexBytes(data.billIndex) +
+                    data.rollups.estimatedBytes() + archiveBytes(data.archive);
+  for (const auto &bill : data.bills) {
+    footprint.notes += stringBytes(bill.note);
+  }
+  for (const auto &reminder : data.reminders) {
+    footprint.notes += stringBytes(reminder.message);
+  }
+
+  footprint.posts = vectorBytes(data.posts) + indexBytes(data.postIndex);
+  for (const auto &post : data.posts) {
+    footprint.posts += stringBytes(post.content);
+    footprint.comments += vectorBytes(post.comments);
+    for (const auto &comment : post.comments) {
+      footprint.comments += stringBytes(comment.content);
+    }
+  }
+
+  const auto &profile = data.profile;
+  footprint.other = sizeof(UserData) + stringBytes(profile.id) +
+                    stringBytes(profile.username) + stringBytes(profile.email) +
+                    stringBytes(profile.passwordHash) +
+                    stringBytes(profile.privacyLevel) +
+                    vectorBytes(data.categories) +
+                    indexBytes(data.categoryIndex) +
+                    vectorBytes(data.reminders) +
+                    indexBytes(data.reminderIndex);
+  for (const auto &friendId : profile.friendIds) {
+    footprint.other += sizeof(void *) + stringBytes(friendId);
+  }
+  for (const auto &category : data.categories) {
+    footprint.other += stringBytes(category.name) + stringBytes(category.type);
+  }
+  return footprint;
+}
+
+}  // namespace core
@@ -0,0 +1,48 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include "Entities.h"
+
+#include <QString>
+
+namespace core {
+
+// 单个用户数据在内存中的估算占用（字节），按分区拆分。
+// 按容器容量与字符串长度估算，不区分隐式共享，结果偏保守。
+struct MemoryFootprint {
+  qint64 bills = 0;     // 账单、账单索引、日历预聚合与归档摘要
+  qint64 notes = 0;     // 账单备注与提醒文本
+  qint64 posts = 0;     // 动态正文与动态索引
+  qint64 comments = 0;  // 快照中携带的评论
+  qint64 other = 0;     // 档案、分类与提醒
+  qint64 search = 0;    // 检索索引，由 LedgerService 记入，随快照一同逐出
+
+  qint64 total() const {
+    return bills + notes + posts + comments + other + search;
+  }
+  // 遍历一次用户数据得到估算值，代价与数据量线性相关。
+  static MemoryFootprint of(const UserData &data);
+};
+
+// 单个用户的内存与磁盘占用；cached 为 false 表示快照当前不在缓存中。
+struct UserFootprint {
+  QString userId;
+  MemoryFootprint memory;
+  qint64 diskBytes = 0;
+  bool cached = false;
+};
+
+// 快照缓存的全局内存计量。
+struct MemoryGauge {
+  qint64 cachedBytes = 0;
+  qint64 budgetBytes = 0;  // 0 表示不限
+  int cachedUsers = 0;
+  quint64 evictions = 0;
+};
+
+}  // namespace core
@@ -0,0 +1,339 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "GroupCommit.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QSet>
+#include <QStringList>
+#include <QThread>
+
+#ifdef Q_OS_WIN
+#include <io.h>
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace core {
+
+namespace {
+
+const QString kTempSuffix = ".tmp";
+const QString kBackupSuffix = ".bak";
+const QString kIntentSuffix = ".intent";
+
+// 将文件内容刷到存储设备。
+bool syncFile(QFile &file) {
+  if (!file.flush()) {
+    return false;
+  }
+#if defined(Q_OS_WIN)
+  return _commit(file.handle()) == 0;
+#elif defined(Q_OS_MACOS)
+  return ::fcntl(file.handle(), F_FULLFSYNC) != -1 ||
+         ::fsync(file.handle()) == 0;
+#elif defined(Q_OS_LINUX)
+  return ::fdatasync(file.handle()) == 0;
+#else
+  return ::fsync(file.handle()) == 0;
+#endif
+}
+
+// 重命名后同步目录项，保证新文件名本身也已持久化（Windows 无需也无法这样做）。
+bool syncDirectory(const QString &directory) {
+#ifdef Q_OS_WIN
+  Q_UNUSED(directory);
+  return true;
+#else
+  const int fd = ::open(QFile::encodeName(directory).constData(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  const bool ok = ::fsync(fd) == 0;
+  ::close(fd);
+  return ok;
+#endif
+}
+
+// 原子替换目标文件；QFile::rename 在目标存在时会失败，因此直接调用系统接口。
+bool replaceFile(const QString &from, const QString &to) {
+#ifdef Q_OS_WIN
+  return ::MoveFileExW(reinterpret_cast<LPCWSTR>(from.utf16()),
+                       reinterpret_cast<LPCWSTR>(to.utf16()),
+                       MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+  return ::rename(QFile::encodeName(from).constData(),
+                  QFile::encodeName(to).constData()) == 0;
+#endif
+}
+
+// 意图标记仍在说明多文件提交没有完成，把每个目标恢复到提交前的状态：
+// “=” 行的目标原本存在，有备份时用备份替换；“+” 行的目标是新建的，删除。
+// 写了一半的末行对应的目标尚未开始重命名，直接忽略。
+void rollBackIntent(const QString &path) {
+  QFile file(path);
+  if (file.open(QIODevice::ReadOnly)) {
+    const QByteArray bytes = file.readAll();
+    file.close();
+    int start = 0;
+    while (start < bytes.size()) {
+      const int end = bytes.indexOf('\n', start);
+      if (end < 0) {
+        break;
+      }
+      if (end - start > 1) {
+        const QString target =
+            QString::fromUtf8(bytes.constData() + start + 1, end - start - 1);
+        if (bytes.at(start) == '+') {
+          QFile::remove(target);
+        } else if (QFile::exists(target + kBackupSuffix)) {
+          QFile::remove(target);
+          replaceFile(target + kBackupSuffix, target);
+        }
+      }
+      start = end + 1;
+    }
+  }
+  QFile::remove(path);
+}
+
+}  // namespace
+
+// 单个提交请求及其结果，由领导者线程填写。
+struct GroupCommitter::Ticket {
+  QVector<FileWrite> writes;
+  QStringList tempPaths;
+  QString intentPath;  // 仅多文件请求使用
+  bool done = false;
+  bool ok = false;
+};
+
+GroupCommitter::GroupCommitter(const DurabilityOptions &options,
+                               QReadWriteLock *replaceLock,
+                               const QString &intentDirectory)
+    : options_(options),
+      replaceLock_(replaceLock),
+      intentDirectory_(intentDirectory) {}
+
+// 领导者/跟随者：没有进行中的批次时当前线程接管队列并执行，否则等待被唤醒。
+bool GroupCommitter::commit(const QVector<FileWrite> &writes) {
+  auto ticket = std::make_shared<Ticket>();
+  ticket->writes = writes;
+
+  QMutexLocker locker(&mutex_);
+  for (const auto &write : writes) {
+    ticket->tempPaths << QString("%1.%2%3").arg(write.target)
+                             .arg(nextSequence_++)
+                             .arg(kTempSuffix);
+  }
+  if (writes.size() > 1) {
+    const QFileInfo first(writes.first().target);
+    const QString directory =
+        intentDirectory_.isEmpty() ? first.absolutePath() : intentDirectory_;
+    ticket->intentPath = QString("%1/%2.%3%4").arg(directory)
+                             .arg(first.fileName())
+                             .arg(nextSequence_++)
+                             .arg(kIntentSuffix);
+  }
+  pending_.push_back(ticket);
+  ++stats_.tickets;
+
+  while (!ticket->done) {
+    if (leaderActive_) {
+      finished_.wait(&mutex_);
+      continue;
+    }
+    leaderActive_ = true;
+    if (options_.groupWindowMicros > 0) {
+      locker.unlock();
+      QThread::usleep(static_cast<unsigned long>(options_.groupWindowMicros));
+      locker.relock();
+    }
+    QVector<TicketPtr> batch;
+    batch.swap(pending_);
+    ++stats_.batches;
+    locker.unlock();
+
+    runBatch(batch);
+
+    locker.relock();
+    leaderActive_ = false;
+    finished_.wakeAll();
+  }
+  return ticket->ok;
+}
+
+// 新建文件时还需同步所在目录，文件名本身才算持久化。
+bool GroupCommitter::append(const QString &target,
+                            const QByteArray &bytes) const {
+  const bool created = !QFile::exists(target);
+  QFile file(target);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Append) ||
+      file.write(bytes) != bytes.size() ||
+      !(options_.fsync ? syncFile(file) : file.flush())) {
+    return false;
+  }
+  if (created && options_.fsync) {
+    syncDirectory(QFileInfo(target).absolutePath());
+  }
+  return true;
+}
+
+// 标记须在第一次重命名之前落盘，否则崩溃后无从得知哪些目标属于同一请求。
+bool GroupCommitter::writeIntent(const Ticket &ticket) const {
+  QByteArray bytes;
+  for (const auto &write : ticket.writes) {
+    bytes += QFile::exists(write.target) ? '=' : '+';
+    bytes += QFileInfo(write.target).absoluteFilePath().toUtf8();
+    bytes += '\n';
+  }
+  QFile file(ticket.intentPath);
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate) ||
+      file.write(bytes) != bytes.size() ||
+      !(options_.fsync ? syncFile(file) : file.flush())) {
+    file.close();
+    QFile::remove(ticket.intentPath);
+    return false;
+  }
+  file.close();
+  return !options_.fsync ||
+         syncDirectory(QFileInfo(ticket.intentPath).absolutePath());
+}
+
+GroupCommitStats GroupCommitter::stats() const {
+  QMutexLocker locker(&mutex_);
+  return stats_;
+}
+
+// 三个阶段：逐个写入并同步临时文件、逐请求重命名；最后每个目录同步一次。
+// 不用 syncfs：它会刷写整个文件系统上其他进程的脏页，耗时没有上界，
+// 且旧内核不报告写回错误。
+void GroupCommitter::runBatch(const QVector<TicketPtr> &batch) {
+  QSet<QString> directories;
+  quint64 barriers = 0;
+
+  for (const auto &ticket : batch) {
+    ticket->ok = true;
+    for (int i = 0; i < ticket->writes.size() && ticket->ok; ++i) {
+      const auto &write = ticket->writes.at(i);
+      QFile file(ticket->tempPaths.at(i));
+      ticket->ok = file.open(QIODevice::WriteOnly | QIODevice::Truncate) &&
+                   file.write(write.bytes) == write.bytes.size() &&
+                   (options_.fsync ? syncFile(file) : file.flush());
+      barriers += options_.fsync ? 1 : 0;
+      directories.insert(QFileInfo(write.target).absolutePath());
+    }
+    if (!ticket->ok) {
+      for (const auto &temp : ticket->tempPaths) {
+        QFile::remove(temp);
+      }
+    }
+  }
+
+  if (replaceLock_ != nullptr) {
+    replaceLock_->lockForWrite();
+  }
+  for (const auto &ticket : batch) {
+    if (!ticket->ok) {
+      continue;
+    }
+    const auto &writes = ticket->writes;
+    if (writes.size() == 1) {
+      const QString &temp = ticket->tempPaths.first();
+      ticket->ok = replaceFile(temp, writes.first().target);
+      if (!ticket->ok) {
+        QFile::remove(temp);
+      }
+      continue;
+    }
+
+    // 多文件请求先把原文件移为备份，失败时按逆序恢复，保证整体回滚。
+    if (!writeIntent(*ticket)) {
+      ticket->ok = false;
+      for (const auto &temp : ticket->tempPaths) {
+        QFile::remove(temp);
+      }
+      continue;
+    }
+    int committed = 0;
+    for (; committed < writes.size(); ++committed) {
+      const QString &target = writes.at(committed).target;
+      QFile::remove(target + kBackupSuffix);
+      if (QFile::exists(target) &&
+          !replaceFile(target, target + kBackupSuffix)) {
+        break;
+      }
+      if (!replaceFile(ticket->tempPaths.at(committed), target)) {
+        replaceFile(target + kBackupSuffix, target);
+        break;
+      }
+    }
+    ticket->ok = committed == writes.size();
+    for (int i = 0; !ticket->ok && i < committed; ++i) {
+      const QString &target = writes.at(i).target;
+      QFile::remove(target);
+      replaceFile(target + kBackupSuffix, target);
+    }
+    // 重命名（或回滚）落盘后才能撤销标记，此后残留的备份只是待删的旧版本。
+    if (options_.fsync) {
+      for (const auto &write : writes) {
+        syncDirectory(QFileInfo(write.target).absolutePath());
+      }
+    }
+    QFile::remove(ticket->intentPath);
+    for (int i = 0; i < writes.size(); ++i) {
+      QFile::remove(writes.at(i).target + kBackupSuffix);
+      QFile::remove(ticket->tempPaths.at(i));
+    }
+  }
+  if (replaceLock_ != nullptr) {
+    replaceLock_->unlock();
+  }
+
+  if (options_.fsync) {
+    for (const auto &directory : directories) {
+      syncDirectory(directory);
+    }
+  }
+
+  QMutexLocker locker(&mutex_);
+  stats_.syncBarriers += barriers;
+  for (const auto &ticket : batch) {
+    ticket->done = true;
+  }
+}
+
+// 先按意图标记整体回滚未完成的多文件提交；之后仍残留的备份若目标缺失，
+// 同样恢复旧版本，否则是已完成提交未及删除的旧版本。
+void GroupCommitter::recoverDirectory(const QString &directory) {
+  QDir dir(directory);
+  const auto intents = dir.entryList({"*" + kIntentSuffix}, QDir::Files);
+  for (const auto &intent : intents) {
+    rollBackIntent(dir.filePath(intent));
+  }
+  const auto backups = dir.entryList({"*" + kBackupSuffix}, QDir::Files);
+  for (const auto &backup : backups) {
+    const QString backupPath = dir.filePath(backup);
+    const QString target = backupPath.left(backupPath.size() -
+                                           kBackupSuffix.size());
+    if (QFile::exists(target)) {
+      QFile::remove(backupPath);
+    } else {
+      replaceFile(backupPath, target);
+    }
+  }
+  const auto temps = dir.entryList({"*" + kTempSuffix}, QDir::Files);
+  for (const auto &temp : temps) {
+    QFile::remove(dir.filePath(temp));
+  }
+}
+
+}  // namespace core
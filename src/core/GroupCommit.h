@@ -0,0 +1,88 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QString>
+#include <QVector>
+#include <QWaitCondition>
+
+#include <memory>
+
+namespace core {
+
+// DurabilityOptions 控制落盘的持久性与成本。
+struct DurabilityOptions {
+  // 为 false 时只 flush 不 fsync，进程崩溃安全但掉电可能丢失最近提交。
+  bool fsync = true;
+  // 领导者开始一组提交前额外等待的微秒数，用于在低并发时攒批。
+  int groupWindowMicros = 0;
+};
+
+// 一次待提交的整文件写入。
+struct FileWrite {
+  QString target;
+  QByteArray bytes;
+};
+
+// 组提交统计：tickets 为提交请求数，batches 为实际执行的刷盘批次数，
+// syncBarriers 为临时文件的同步次数。
+struct GroupCommitStats {
+  quint64 tickets = 0;
+  quint64 batches = 0;
+  quint64 syncBarriers = 0;
+};
+
+// GroupCommitter 以“临时文件 + fsync + 原子重命名”写入文件，并把并发到达的
+// 提交合并成一批：先到的线程充当领导者，为当前排队的所有请求统一刷盘，
+// 其余线程等待结果。每个请求（可包含多个文件）要么整体生效、要么整体回滚；
+// 多文件请求在第一次重命名前写下列出全部目标的意图标记，崩溃后据此回滚。
+class GroupCommitter {
+ public:
+  // replaceLock 可选：重命名阶段持有其写锁，与持有读锁的读者互斥
+  // （Windows 上文件被打开时无法被替换）。intentDirectory 为意图标记所在
+  // 目录，须在其他目录之前恢复；为空时放在第一个目标所在目录。
+  explicit GroupCommitter(const DurabilityOptions &options = {},
+                          QReadWriteLock *replaceLock = nullptr,
+                          const QString &intentDirectory = QString());
+
+  GroupCommitter(const GroupCommitter &) = delete;
+  GroupCommitter &operator=(const GroupCommitter &) = delete;
+
+  // 提交一组写入并阻塞到其落盘（或失败）为止。
+  bool commit(const QVector<FileWrite> &writes);
+  // 向只追加的日志文件末尾写入，按同样的持久性选项刷盘；不参与合批。
+  bool append(const QString &target, const QByteArray &bytes) const;
+
+  GroupCommitStats stats() const;
+  const DurabilityOptions &options() const { return options_; }
+
+  // 启动时清理中断的提交：按残留的意图标记整体回滚，恢复孤立的备份文件，
+  // 删除残留的临时文件。
+  static void recoverDirectory(const QString &directory);
+
+ private:
+  struct Ticket;
+  using TicketPtr = std::shared_ptr<Ticket>;
+
+  void runBatch(const QVector<TicketPtr> &batch);
+  bool writeIntent(const Ticket &ticket) const;
+
+  DurabilityOptions options_;
+  QReadWriteLock *replaceLock_ = nullptr;
+  QString intentDirectory_;
+  mutable QMutex mutex_;
+  QWaitCondition finished_;
+  QVector<TicketPtr> pending_;
+  bool leaderActive_ = false;
+  quint64 nextSequence_ = 0;
+  GroupCommitStats stats_;
+};
+
+}  // namespace core
@@ -0,0 +1,83 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "IdGenerator.h"
+
+#include <QDateTime>
+#include <QRandomGenerator>
+
+#include <random>
+
+namespace core {
+
+namespace {
+
+constexpr quint64 kVersion = 0x7;
+constexpr quint64 kVariant = quint64(0x2) << 62;
+constexpr quint64 kTimestampMask = (quint64(1) << 48) - 1;
+// 计数器高 12 位放在 rand_a，低 30 位放在 rand_b 的开头。
+constexpr int kCounterLowBits = 30;
+constexpr quint64 kCounterMask = (quint64(1) << 42) - 1;
+constexpr quint64 kCounterLowMask = (quint64(1) << kCounterLowBits) - 1;
+
+struct GeneratorState {
+  qint64 lastMsecs = -1;
+  quint64 counter = 0;
+  std::mt19937_64 random;
+  bool seeded = false;
+};
+
+thread_local GeneratorState tlsState;
+
+// 新毫秒的计数器起点取随机值的下半区间，留出足够的递增空间。
+quint64 freshCounter(GeneratorState &state) {
+  return state.random() & (kCounterMask >> 1);
+}
+
+}  // namespace
+
+EntityId IdGenerator::next() {
+  return next(QDateTime::currentMSecsSinceEpoch());
+}
+
+// 时钟回拨或同一毫秒内沿用上次时间戳并递增计数器；计数器用尽时借用下一毫秒。
+EntityId IdGenerator::next(qint64 nowMsecs) {
+  auto &state = tlsState;
+  if (!state.seeded) {
+    state.random.seed(QRandomGenerator::system()->generate64());
+    state.seeded = true;
+  }
+  if (nowMsecs > state.lastMsecs) {
+    state.lastMsecs = nowMsecs;
+    state.counter = freshCounter(state);
+  } else if (++state.counter > kCounterMask) {
+    ++state.lastMsecs;
+    state.counter = freshCounter(state);
+  }
+
+  const quint64 msecs = static_cast<quint64>(state.lastMsecs) & kTimestampMask;
+  const quint64 high = (msecs << 16) | (kVersion << 12) |
+                       (state.counter >> kCounterLowBits);
+  const quint64 low = kVariant | ((state.counter & kCounterLowMask) << 32) |
+                      (state.random() & 0xFFFFFFFFULL);
+  return EntityId::fromParts(high, low);
+}
+
+EntityId IdGenerator::floorFor(qint64 msecs) {
+  const quint64 stamp = static_cast<quint64>(msecs) & kTimestampMask;
+  return EntityId::fromParts((stamp << 16) | (kVersion << 12), kVariant);
+}
+
+qint64 IdGenerator::timestampOf(const EntityId &id) {
+  if (id.isEmpty() || id.isInterned() ||
+      ((id.high() >> 12) & 0xF) != kVersion ||
+      (id.low() & (quint64(0x3) << 62)) != kVariant) {
+    return -1;
+  }
+  return static_cast<qint64>(id.high() >> 16);
+}
+
+}  // namespace core
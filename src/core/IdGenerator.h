@@ -0,0 +1,31 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include "EntityId.h"
+
+#include <QtGlobal>
+
+namespace core {
+
+// IdGenerator 生成按时间递增的 UUIDv7 形式 ID：高 48 位为毫秒时间戳，
+// 随后是每线程单调递增的 42 位计数器（起点随机），末尾 32 位随机数。
+// 状态全部为 thread_local，生成路径无锁；同一线程产生的 ID 严格递增，
+// 不同线程之间按毫秒有序。文本形式仍是小写 UUID，可被 EntityId 直接解析。
+class IdGenerator {
+ public:
+  static EntityId next();
+  // 指定当前时间（Unix 毫秒），供测试与批量导入复用同一时刻。
+  static EntityId next(qint64 nowMsecs);
+
+  // 该毫秒内可能出现的最小 ID，可作为“晚于某时刻”的游标下界。
+  static EntityId floorFor(qint64 msecs);
+  // 取出 ID 中的毫秒时间戳；非本生成器格式（如旧的随机 UUID）返回 -1。
+  static qint64 timestampOf(const EntityId &id);
+};
+
+}  // namespace core
@@ -0,0 +1,448 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "JsonReader.h"
+
+namespace core {
+
+namespace {
+
+// 与 QJsonDocument 相同的嵌套深度上限，防止恶意输入耗尽栈。
+constexpr int kMaxDepth = 1024;
+// 超过该长度的字符串（动态正文等）很少重复，不进入字符串池。
+constexpr int kMaxPooledBytes = 64;
+// 尾数不超过 2^53、十进制指数不超过 22 时，一次乘除即可得到正确舍入的结果。
+constexpr quint64 kMaxExactMantissa = quint64(1) << 53;
+constexpr int kMaxExactExponent = 22;
+constexpr double kPowersOf10[kMaxExactExponent + 1] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+bool isDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+int hexValue(char ch) {
+  if (ch >= '0' && ch <= '9') {
+    return ch - '0';
+  }
+  if (ch >= 'a' && ch <= 'f') {
+    return ch - 'a' + 10;
+  }
+  if (ch >= 'A' && ch <= 'F') {
+    return ch - 'A' + 10;
+  }
+  return -1;
+}
+
+// 已通过语法校验的数字。常见的金额走快速路径，其余交给 Qt 的转换。
+double toDouble(const char *begin, const char *end) {
+  const char *p = begin;
+  const bool negative = *p == '-';
+  if (negative) {
+    ++p;
+  }
+  quint64 mantissa = 0;
+  int exponent = 0;
+  bool exact = true;
+  for (; p != end && isDigit(*p); ++p) {
+    if (mantissa < kMaxExactMantissa / 10) {
+      mantissa = mantissa * 10 + (*p - '0');
+    } else {
+      exact = false;
+    }
+  }
+  if (p != end && *p == '.') {
+    for (++p; p != end && isDigit(*p); ++p) {
+      if (mantissa < kMaxExactMantissa / 10) {
+        mantissa = mantissa * 10 + (*p - '0');
+        --exponent;
+      } else {
+        exact = false;
+      }
+    }
+  }
+  if (p != end) {
+    ++p;  // 'e' 或 'E'
+    const bool negativeExponent = *p == '-';
+    if (*p == '-' || *p == '+') {
+      ++p;
+    }
+    int explicitExponent = 0;
+    for (; p != end && explicitExponent < 10000; ++p) {
+      explicitExponent = explicitExponent * 10 + (*p - '0');
+    }
+    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+  }
+
+  if (!exact || exponent < -kMaxExactExponent ||
+      exponent > kMaxExactExponent) {
+    return QByteArray(begin, static_cast<int>(end - begin)).toDouble();
+  }
+  double value = static_cast<double>(mantissa);
+  value = exponent < 0 ? value / kPowersOf10[-exponent]
+                       : value * kPowersOf10[exponent];
+  return negative ? -value : value;
+}
+
+}  // namespace
+
+JsonReader::JsonReader(const QByteArray &bytes)
+    : pos_(bytes.constData()), end_(bytes.constData() + bytes.size()) {}
+
+bool JsonReader::atEnd() {
+  skipSpace();
+  return pos_ == end_;
+}
+
+JsonReader::Type JsonReader::peek() {
+  skipSpace();
+  if (!ok_ || pos_ == end_) {
+    return Type::Invalid;
+  }
+  switch (*pos_) {
+    case '{':
+      return Type::Object;
+    case '[':
+      return Type::Array;
+    case '"':
+      return Type::String;
+    case 't':
+    case 'f':
+      return Type::Bool;
+    case 'n':
+      return Type::Null;
+    default:
+      return *pos_ == '-' || isDigit(*pos_) ? Type::Number : Type::Invalid;
+  }
+}
+
+bool JsonReader::beginObject() {
+  return peek() == Type::Object ? open('{') : fail();
+}
+
+bool JsonReader::nextKey(QLatin1String &key) {
+  if (!separator('}')) {
+    return false;
+  }
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  bool escaped = false;
+  if (!scanString(begin, end, escaped)) {
+    return false;
+  }
+  skipSpace();
+  if (pos_ == end_ || *pos_ != ':') {
+    return fail();
+  }
+  ++pos_;
+  key = QLatin1String(begin, static_cast<int>(end - begin));
+  return true;
+}
+
+bool JsonReader::beginArray() {
+  return peek() == Type::Array ? open('[') : fail();
+}
+
+bool JsonReader::nextElement() { return separator(']'); }
+
+bool JsonReader::readString(QString &out) {
+  if (peek() != Type::String) {
+    skipValue();
+    return false;
+  }
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  bool escaped = false;
+  if (!scanString(begin, end, escaped)) {
+    return false;
+  }
+  const int size = static_cast<int>(end - begin);
+  if (escaped) {
+    out = unescape(begin, end);
+  } else if (size == 0) {
+    out = QString();
+  } else if (size > kMaxPooledBytes) {
+    out = QString::fromUtf8(begin, size);
+  } else {
+    QString &pooled = pool_[std::string_view(begin, size)];
+    if (pooled.isNull()) {
+      pooled = QString::fromUtf8(begin, size);
+    }
+    out = pooled;
+  }
+  return ok_;
+}
+
+bool JsonReader::readDouble(double &out) {
+  if (peek() != Type::Number) {
+    skipValue();
+    return false;
+  }
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  if (!scanNumber(begin, end)) {
+    return false;
+  }
+  out = toDouble(begin, end);
+  return true;
+}
+
+bool JsonReader::readBool(bool &out) {
+  if (peek() != Type::Bool) {
+    skipValue();
+    return false;
+  }
+  out = *pos_ == 't';
+  return skipLiteral(out ? QLatin1String("true") : QLatin1String("false"));
+}
+
+bool JsonReader::readRawString(const char *&data, int &size) {
+  if (peek() != Type::String) {
+    return false;
+  }
+  const char *start = pos_;
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  bool escaped = false;
+  if (!scanString(begin, end, escaped)) {
+    return false;
+  }
+  if (escaped) {
+    pos_ = start;
+    return false;
+  }
+  data = begin;
+  size = static_cast<int>(end - begin);
+  return true;
+}
+
+void JsonReader::skipValue() {
+  const char *begin = nullptr;
+  const char *end = nullptr;
+  bool escaped = false;
+  QLatin1String key;
+  switch (peek()) {
+    case Type::Object:
+      open('{');
+      while (nextKey(key)) {
+        skipValue();
+      }
+      break;
+    case Type::Array:
+      open('[');
+      while (nextElement()) {
+        skipValue();
+      }
+      break;
+    case Type::String:
+      scanString(begin, end, escaped);
+      break;
+    case Type::Number:
+      scanNumber(begin, end);
+      break;
+    case Type::Bool:
+      skipLiteral(*pos_ == 't' ? QLatin1String("true")
+                               : QLatin1String("false"));
+      break;
+    case Type::Null:
+      skipLiteral(QLatin1String("null"));
+      break;
+    case Type::Invalid:
+      fail();
+      break;
+  }
+}
+
+bool JsonReader::rawValue(const char *&data, int &size) {
+  skipSpace();
+  const char *begin = pos_;
+  skipValue();
+  if (!ok_) {
+    return false;
+  }
+  data = begin;
+  size = static_cast<int>(pos_ - begin);
+  return true;
+}
+
+bool JsonReader::fail() {
+  ok_ = false;
+  return false;
+}
+
+void JsonReader::skipSpace() {
+  while (pos_ != end_ &&
+         (*pos_ == ' ' || *pos_ == '\n' || *pos_ == '\r' || *pos_ == '\t')) {
+    ++pos_;
+  }
+}
+
+bool JsonReader::open(char bracket) {
+  if (pos_ == end_ || *pos_ != bracket || hasItems_.size() >= kMaxDepth) {
+    return fail();
+  }
+  ++pos_;
+  hasItems_.append(false);
+  return true;
+}
+
+bool JsonReader::separator(char close) {
+  skipSpace();
+  if (!ok_ || pos_ == end_ || hasItems_.isEmpty()) {
+    return fail();
+  }
+  if (*pos_ == close) {
+    ++pos_;
+    hasItems_.removeLast();
+    return false;
+  }
+  if (hasItems_.last()) {
+    if (*pos_ != ',') {
+      return fail();
+    }
+    ++pos_;
+  }
+  hasItems_.last() = true;
+  return true;
+}
+
+// 成功后 pos_ 指向右引号之后，[begin, end) 为引号内的原始字节。
+bool JsonReader::scanString(const char *&begin, const char *&end,
+                            bool &escaped) {
+  skipSpace();
+  if (pos_ == end_ || *pos_ != '"') {
+    return fail();
+  }
+  escaped = false;
+  begin = pos_ + 1;
+  for (const char *p = begin; p != end_; ++p) {
+    const auto ch = static_cast<uchar>(*p);
+    if (ch == '"') {
+      end = p;
+      pos_ = p + 1;
+      return true;
+    }
+    if (ch < 0x20) {
+      return fail();
+    }
+    if (ch == '\\') {
+      escaped = true;
+      if (++p == end_) {
+        break;
+      }
+    }
+  }
+  return fail();
+}
+
+// 按 JSON 语法校验：-?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+bool JsonReader::scanNumber(const char *&begin, const char *&end) {
+  skipSpace();
+  const char *p = pos_;
+  if (p != end_ && *p == '-') {
+    ++p;
+  }
+  if (p == end_ || !isDigit(*p)) {
+    return fail();
+  }
+  if (*p == '0') {
+    ++p;
+  } else {
+    while (p != end_ && isDigit(*p)) {
+      ++p;
+    }
+  }
+  if (p != end_ && *p == '.') {
+    if (++p == end_ || !isDigit(*p)) {
+      return fail();
+    }
+    while (p != end_ && isDigit(*p)) {
+      ++p;
+    }
+  }
+  if (p != end_ && (*p == 'e' || *p == 'E')) {
+    ++p;
+    if (p != end_ && (*p == '+' || *p == '-')) {
+      ++p;
+    }
+    if (p == end_ || !isDigit(*p)) {
+      return fail();
+    }
+    while (p != end_ && isDigit(*p)) {
+      ++p;
+    }
+  }
+  begin = pos_;
+  end = p;
+  pos_ = p;
+  return true;
+}
+
+bool JsonReader::skipLiteral(QLatin1String literal) {
+  if (end_ - pos_ < literal.size() ||
+      QLatin1String(pos_, literal.size()) != literal) {
+    return fail();
+  }
+  pos_ += literal.size();
+  return true;
+}
+
+// \uXXXX 直接作为 UTF-16 码元追加，代理对因此自然拼合。
+QString JsonReader::unescape(const char *begin, const char *end) {
+  QString out;
+  out.reserve(static_cast<int>(end - begin));
+  const char *run = begin;
+  for (const char *p = begin; p != end; ++p) {
+    if (*p != '\\') {
+      continue;
+    }
+    out.append(QString::fromUtf8(run, static_cast<int>(p - run)));
+    ++p;
+    switch (*p) {
+      case '"':
+      case '\\':
+      case '/':
+        out.append(QLatin1Char(*p));
+        break;
+      case 'b':
+        out.append(QLatin1Char('\b'));
+        break;
+      case 'f':
+        out.append(QLatin1Char('\f'));
+        break;
+      case 'n':
+        out.append(QLatin1Char('\n'));
+        break;
+      case 'r':
+        out.append(QLatin1Char('\r'));
+        break;
+      case 't':
+        out.append(QLatin1Char('\t'));
+        break;
+      case 'u': {
+        ushort unit = 0;
+        for (int i = 1; i <= 4; ++i) {
+          const int digit = p + i < end ? hexValue(p[i]) : -1;
+          if (digit < 0) {
+            fail();
+            return QString();
+          }
+          unit = static_cast<ushort>(unit << 4 | digit);
+        }
+        out.append(QChar(unit));
+        p += 4;
+        break;
+      }
+      default:
+        fail();
+        return QString();
+    }
+    run = p + 1;
+  }
+  out.append(QString::fromUtf8(run, static_cast<int>(end - run)));
+  return out;
+}
+
+}  // namespace core
@@ -0,0 +1,75 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QByteArray>
+#include <QLatin1String>
+#include <QString>
+#include <QVarLengthArray>
+
+#include <string_view>
+#include <unordered_map>
+
+namespace core {
+
+// JsonReader 与 JsonWriter 相对：在一块 UTF-8 缓冲区上按顺序拉取 JSON 记号，
+// 不构造 QJsonObject/QJsonValue 中间树。键名以及 ID、时间戳这类只需解析的
+// 字符串直接以缓冲区切片返回；需要保留的字符串才分配 QString，且同一次
+// 读取中重复出现的短字符串只分配一次，其余出现处隐式共享。
+// 缓冲区须在读取期间保持有效。出现语法错误后 ok() 为 false，之后的读取
+// 一律失败，调用方应整体丢弃本次结果。
+class JsonReader {
+ public:
+  enum class Type { Invalid, Null, Bool, Number, String, Array, Object };
+
+  explicit JsonReader(const QByteArray &bytes);
+
+  bool ok() const { return ok_; }
+  // 只剩空白时返回 true。
+  bool atEnd();
+  // 下一个值的类型，不消耗输入。
+  Type peek();
+
+  // 进入对象后循环调用 nextKey，返回 false 时对象已读完（或出错）。
+  // 含转义的键名原样返回，不会与任何字段名相等。
+  bool beginObject();
+  bool nextKey(QLatin1String &key);
+  // 进入数组后循环调用 nextElement，返回 false 时数组已读完（或出错）。
+  bool beginArray();
+  bool nextElement();
+
+  // 类型不符时跳过该值并返回 false，调用方保留原值。
+  bool readString(QString &out);
+  bool readDouble(double &out);
+  bool readBool(bool &out);
+  // 不含转义的字符串以切片返回；其他情况返回 false 且不消耗输入。
+  bool readRawString(const char *&data, int &size);
+  void skipValue();
+  // 跳过一个值并返回其原始字节的切片。
+  bool rawValue(const char *&data, int &size);
+
+ private:
+  bool fail();
+  void skipSpace();
+  bool open(char bracket);
+  // nextKey 与 nextElement 共用的分隔符处理。
+  bool separator(char close);
+  bool scanString(const char *&begin, const char *&end, bool &escaped);
+  bool scanNumber(const char *&begin, const char *&end);
+  bool skipLiteral(QLatin1String literal);
+  QString unescape(const char *begin, const char *end);
+
+  const char *pos_;
+  const char *end_;
+  bool ok_ = true;
+  // 每层容器是否已读过元素。
+  QVarLengthArray<bool, 16> hasItems_;
+  // 本次读取中出现过的短字符串，键指向缓冲区。
+  std::unordered_map<std::string_view, QString> pool_;
+};
+
+}  // namespace core
@@ -6,21 +6,105 @@
 
 #include "JsonStorage.h"
 
+#include "JsonReader.h"
+#include "MapReduce.h"
+
+#include <QDirIterator>
 #include <QFile>
+#include <QFileInfo>
 #include <QJsonDocument>
+#include <QMutexLocker>
+#include <QPair>
 #include <QProcessEnvironment>
 #include <QStandardPaths>
 #include <QUuid>
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <optional>
+
 namespace core {
 
 static const QString kDataFolderName = "bookeeper_data";
+// 分片目录的根与用户清单文件。
+static const QString kShardRoot = "users";
+static const QString kManifestName = "users.manifest";
+// 清单日志中的删除记录超过该数量且多于现存用户数时整体重写。
+constexpr int kMinManifestRemovals = 64;
+
+// 单个线程保留的读缓冲区上限，超过时用完即释放。
+constexpr int kMaxRetainedBuffer = 4 * 1024 * 1024;
+
+// FNV-1a：结果不受 Qt 哈希种子与版本影响，分片位置在各平台上保持稳定。
+static quint32 shardHash(const QString &userId) {
+  quint32 hash = 2166136261u;
+  for (const char byte : userId.toUtf8()) {
+    hash ^= static_cast<uchar>(byte);
+    hash *= 16777619u;
+  }
+  return hash;
+}
 
-// 构造函数会在需要时自动创建数据目录。
-JsonStorage::JsonStorage(const QDir &baseDir) : dataDir_(baseDir) {
+// 读入复用的缓冲区：容量随读过的最大文件增长，之后的读取不再分配。
+static bool readInto(QFile &file, QByteArray &buffer) {
+  const qint64 size = file.size();
+  if (size > std::numeric_limits<int>::max()) {
+    return false;
+  }
+  buffer.resize(static_cast<int>(size));
+  return file.read(buffer.data(), size) == size;
+}
+
+static void releaseIfOversized(QByteArray &buffer) {
+  if (buffer.capacity() > kMaxRetainedBuffer) {
+    buffer = QByteArray();
+  }
+}
+
+// 非数组与旧实现一样得到空容器；数组元素逐个流式读取。
+template <typename T>
+static void readEntities(JsonReader &in, QVector<T> &items,
+                         T (*read)(JsonReader &)) {
+  if (in.peek() != JsonReader::Type::Array) {
+    in.skipValue();
+    return;
+  }
+  in.beginArray();
+  while (in.nextElement()) {
+    items.push_back(read(in));
+  }
+}
+
+// 只取档案：其余字段按语法跳过，整份文件仍须合法。
+static bool decodeProfile(const QByteArray &bytes, UserProfile &out) {
+  JsonReader in(bytes);
+  if (!in.beginObject()) {
+    return false;
+  }
+  QLatin1String key;
+  while (in.nextKey(key)) {
+    if (key == QLatin1String("profile")) {
+      out = UserProfile::readJson(in);
+    } else {
+      in.skipValue();
+    }
+  }
+  return in.ok() && in.atEnd();
+}
+
+// 构造函数会在需要时自动创建数据目录，清理上次中断的提交，
+// 加载用户清单并迁移旧版的平铺布局。
+JsonStorage::JsonStorage(const QDir &baseDir,
+                         const DurabilityOptions &durability)
+    : dataDir_(baseDir),
+      committer_(durability, &lock_, baseDir.absolutePath()) {
   if (!dataDir_.exists()) {
     dataDir_.mkpath(".");
   }
+  GroupCommitter::recoverDirectory(dataDir_.absolutePath());
+  loadManifest();
+  migrateFlatLayout();
 }
 
 // AppDataLocation 可能为空，必要时回退到用户主目录。
@@ -40,124 +124,442 @@ QDir JsonStorage::defaultDataDir() {
   return dir;
 }
 
-// 写入用户数据时采用写锁，防止并发写入冲突。
+// 单用户保存作为一个提交请求交给组提交器。
 bool JsonStorage::saveUser(const UserData &data) const {
-  QWriteLocker locker(&lock_);
-  QFile file(userFilePath(data.profile.id));
-  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+  prepareShard(data.profile.id, true);
+  if (!registerUsers({data.profile.id})) {
     return false;
   }
-  const auto json = QJsonDocument(serialize(data)).toJson();
-  if (file.write(json) != json.size()) {
+  return committer_.commit(
+      {FileWrite{userFilePath(data.profile.id), encode(data)}});
+}
+
+// 多用户保存作为同一个提交请求：共享一次刷盘，任一文件失败则整体回滚。
+bool JsonStorage::saveUsers(const QVector<UserData> &batch) const {
+  QVector<FileWrite> writes;
+  QStringList userIds;
+  writes.reserve(batch.size());
+  for (const auto &data : batch) {
+    prepareShard(data.profile.id, true);
+    userIds << data.profile.id;
+    writes.push_back(FileWrite{userFilePath(data.profile.id), encode(data)});
+  }
+  if (!registerUsers(userIds)) {
     return false;
   }
-  file.flush();
-  return true;
+  return committer_.commit(writes);
 }
 
-// 读取用户数据使用读锁，提高并发读取能力。
+// 读锁只覆盖读文件；解码在锁外进行，每个线程复用同一块读缓冲区。
 bool JsonStorage::loadUser(const QString &userId, UserData &outData) const {
-  QReadLocker locker(&lock_);
-  QFile file(userFilePath(userId));
-  if (!file.exists() || !file.open(QIODevice::ReadOnly)) {
-    return false;
+  prepareShard(userId, false);
+  static thread_local QByteArray buffer;
+  {
+    QReadLocker locker(&lock_);
+    QFile file(userFilePath(userId));
+    if (!file.open(QIODevice::ReadOnly) || !readInto(file, buffer)) {
+      return false;
+    }
+  }
+  const bool loaded = decode(buffer, outData);
+  releaseIfOversized(buffer);
+  return loaded;
+}
+
+// 按清单枚举用户，各用户文件在线程池上并行读取与解析，结果保持清单顺序。
+QVector<UserProfile> JsonStorage::listUsers() const {
+  const QStringList ids = userIds();
+  using Indexed = QVector<QPair<int, UserProfile>>;
+  QVector<int> indexes(ids.size());
+  std::iota(indexes.begin(), indexes.end(), 0);
+  Indexed found = mapReduce<Indexed>(
+      indexes,
+      [&](int index) -> std::pair<int, std::optional<UserProfile>> {
+        prepareShard(ids.at(index), false);
+        static thread_local QByteArray buffer;
+        {
+          QReadLocker locker(&lock_);
+          QFile file(userFilePath(ids.at(index)));
+          if (!file.open(QIODevice::ReadOnly) || !readInto(file, buffer)) {
+            return {index, std::nullopt};
+          }
+        }
+        UserProfile profile;
+        const bool decoded = decodeProfile(buffer, profile);
+        releaseIfOversized(buffer);
+        if (!decoded) {
+          return {index, std::nullopt};
+        }
+        return {index, std::move(profile)};
+      },
+      [](Indexed &acc, std::pair<int, std::optional<UserProfile>> &&one) {
+        if (one.second) {
+          acc.push_back({one.first, std::move(*one.second)});
+        }
+      },
+      [](Indexed &acc, Indexed &&partial) { acc += partial; });
+  std::sort(found.begin(), found.end(),
+            [](const QPair<int, UserProfile> &a,
+               const QPair<int, UserProfile> &b) { return a.first < b.first; });
+
+  QVector<UserProfile> profiles;
+  profiles.reserve(found.size());
+  for (auto &entry : found) {
+    profiles.push_back(std::move(entry.second));
   }
-  const auto doc = QJsonDocument::fromJson(file.readAll());
-  if (!doc.isObject()) {
+  return profiles;
+}
+
+QStringList JsonStorage::userIds() const {
+  QMutexLocker locker(&manifestMutex_);
+  return manifest_;
+}
+
+// 附属文件同样经由组提交器原子写入。
+bool JsonStorage::saveBlob(const QString &userId, const QString &suffix,
+                           const QByteArray &bytes) const {
+  prepareShard(userId, true);
+  return committer_.commit({FileWrite{shardFilePath(userId, suffix), bytes}});
+}
+
+bool JsonStorage::loadBlob(const QString &userId, const QString &suffix,
+                           QByteArray &outBytes) const {
+  prepareShard(userId, false);
+  QReadLocker locker(&lock_);
+  QFile file(shardFilePath(userId, suffix));
+  if (!file.open(QIODevice::ReadOnly)) {
     return false;
   }
-  outData = deserialize(doc.object());
+  outBytes = file.readAll();
   return true;
 }
 
-// 遍历目录下所有 JSON 文件，抽取用户档案列表。
-QVector<UserProfile> JsonStorage::listUsers() const {
-  QReadLocker locker(&lock_);
-  QVector<UserProfile> profiles;
-  const auto entries = dataDir_.entryList({"*.json"}, QDir::Files);
-  for (const auto &entry : entries) {
-    QFile file(dataDir_.filePath(entry));
-    if (!file.open(QIODevice::ReadOnly)) {
-      continue;
+bool JsonStorage::removeBlob(const QString &userId,
+                             const QString &suffix) const {
+  prepareShard(userId, false);
+  QWriteLocker locker(&lock_);
+  QFile file(shardFilePath(userId, suffix));
+  return !file.exists() || file.remove();
+}
+
+// 删除用户文件时使用写锁保证互斥，附属文件一并删除，最后从清单中注销。
+bool JsonStorage::removeUser(const QString &userId) const {
+  prepareShard(userId, false);
+  bool removed = false;
+  {
+    QWriteLocker locker(&lock_);
+    const QDir shard = QFileInfo(userFilePath(userId)).absoluteDir();
+    const auto blobs = shard.entryList({userId + ".*"}, QDir::Files);
+    for (const auto &blob : blobs) {
+      if (blob != userId + ".json") {
+        QFile::remove(shard.filePath(blob));
+      }
     }
-    const auto doc = QJsonDocument::fromJson(file.readAll());
-    if (!doc.isObject()) {
-      continue;
+    removed = QFile::remove(userFilePath(userId));
+  }
+
+  QMutexLocker locker(&manifestMutex_);
+  const auto it = std::lower_bound(manifest_.begin(), manifest_.end(), userId);
+  if (it == manifest_.end() || *it != userId) {
+    return removed;
+  }
+  manifest_.erase(it);
+  ++manifestRemovals_;
+  if (manifestRemovals_ > kMinManifestRemovals &&
+      manifestRemovals_ > manifest_.size()) {
+    writeManifest();
+  } else {
+    committer_.append(manifestPath(), "-" + userId.toUtf8() + "\n");
+  }
+  return removed;
+}
+
+qint64 JsonStorage::diskUsage(const QString &userId) const {
+  const QDir shard = QFileInfo(userFilePath(userId)).absoluteDir();
+  qint64 bytes = 0;
+  for (const auto &info : shard.entryInfoList({userId + ".*"}, QDir::Files)) {
+    // 跳过提交中的临时文件与 ID 带点的其他用户。
+    if (!info.fileName().midRef(userId.size() + 1).contains('.')) {
+      bytes += info.size();
     }
-    profiles.push_back(
-        UserProfile::fromJson(doc.object().value("profile").toObject()));
   }
-  return profiles;
+  return bytes;
 }
 
-// 删除用户文件时使用写锁保证互斥。
-bool JsonStorage::removeUser(const QString &userId) const {
-  QWriteLocker locker(&lock_);
-  return QFile::remove(userFilePath(userId));
+QString JsonStorage::relativeFilePath(const QString &userId,
+                                      const QString &suffix) {
+  const quint32 hash = shardHash(userId);
+  return QString("%1/%2/%3/")
+             .arg(kShardRoot)
+             .arg((hash >> 8) & 0xFF, 2, 16, QLatin1Char('0'))
+             .arg(hash & 0xFF, 2, 16, QLatin1Char('0')) +
+         userId + "." + suffix;
 }
 
 QString JsonStorage::userFilePath(const QString &userId) const {
-  return dataDir_.filePath(userId + ".json");
+  return shardFilePath(userId, "json");
 }
 
-// 按模块序列化所有业务数据。
-QJsonObject JsonStorage::serialize(const UserData &data) {
-  QJsonObject obj;
-  obj["profile"] = data.profile.toJson();
+QString JsonStorage::shardFilePath(const QString &userId,
+                                   const QString &suffix) const {
+  return dataDir_.filePath(relativeFilePath(userId, suffix));
+}
 
-  QJsonArray categories;
-  for (const auto &category : data.categories) {
-    categories.append(category.toJson());
+// 目录尚不存在且只是读取时不做记录，留到首次写入时创建。
+void JsonStorage::prepareShard(const QString &userId, bool create) const {
+  const QString directory = QFileInfo(userFilePath(userId)).absolutePath();
+  QMutexLocker locker(&shardsMutex_);
+  if (preparedShards_.contains(directory)) {
+    return;
+  }
+  if (QDir(directory).exists()) {
+    GroupCommitter::recoverDirectory(directory);
+  } else if (!create || !QDir().mkpath(directory)) {
+    return;
   }
-  obj["categories"] = categories;
+  preparedShards_.insert(directory);
+}
 
-  QJsonArray bills;
-  for (const auto &bill : data.bills) {
-    bills.append(bill.toJson());
+// 清单是只追加的日志：“+id” 登记、“-id” 注销；末尾写了一半的行是崩溃时
+// 未完成的登记（对应的用户文件尚未写入），直接丢弃。
+void JsonStorage::loadManifest() {
+  QFile file(manifestPath());
+  if (!file.open(QIODevice::ReadOnly)) {
+    rebuildManifest();
+    return;
   }
-  obj["bills"] = bills;
+  const QByteArray bytes = file.readAll();
+  file.close();
+  QSet<QString> ids;
+  int removals = 0;
+  int start = 0;
+  while (start < bytes.size()) {
+    const int end = bytes.indexOf('\n', start);
+    if (end < 0) {
+      break;
+    }
+    if (end - start > 1) {
+      const QString id =
+          QString::fromUtf8(bytes.constData() + start + 1, end - start - 1);
+      if (bytes.at(start) == '+') {
+        ids.insert(id);
+      } else if (bytes.at(start) == '-') {
+        ids.remove(id);
+        ++removals;
+      }
+    }
+    start = end + 1;
+  }
+  manifest_ = ids.values();
+  std::sort(manifest_.begin(), manifest_.end());
+  manifestRemovals_ = removals;
+  if (start < bytes.size() || (removals > kMinManifestRemovals &&
+                               removals > manifest_.size())) {
+    writeManifest();
+  }
+}
 
-  QJsonArray reminders;
-  for (const auto &reminder : data.reminders) {
-    reminders.append(reminder.toJson());
+// 清单缺失（首次运行或被删除）时遍历分片目录重建，只在启动时发生一次。
+void JsonStorage::rebuildManifest() {
+  QSet<QString> ids;
+  QDirIterator it(dataDir_.filePath(kShardRoot), {"*.json"}, QDir::Files,
+                  QDirIterator::Subdirectories);
+  while (it.hasNext()) {
+    it.next();
+    ids.insert(it.fileInfo().completeBaseName());
   }
-  obj["reminders"] = reminders;
+  manifest_ = ids.values();
+  std::sort(manifest_.begin(), manifest_.end());
+  writeManifest();
+}
 
-  QJsonArray posts;
-  for (const auto &post : data.posts) {
-    posts.append(post.toJson());
+// 旧版布局把 <userId>.json 与附属文件平铺在数据目录下，逐个用户移入分片
+// 目录后整体重写清单。每次移动都是同一文件系统内的原子重命名，中途中断时
+// 下次启动会重建清单并继续迁移剩余文件。
+void JsonStorage::migrateFlatLayout() {
+  const auto legacy = dataDir_.entryList({"*.json"}, QDir::Files);
+  if (legacy.isEmpty()) {
+    return;
+  }
+  QSet<QString> ids;
+  for (const auto &id : manifest_) {
+    ids.insert(id);
+  }
+  for (const auto &name : legacy) {
+    const QString userId = name.left(name.size() - 5);
+    prepareShard(userId, true);
+    const QDir shard = QFileInfo(userFilePath(userId)).absoluteDir();
+    for (const auto &file : dataDir_.entryList({userId + ".*"}, QDir::Files)) {
+      // 带点的其他用户 ID 也可能匹配通配符，只移动 <userId>.<后缀> 形式的文件。
+      if (file.midRef(userId.size() + 1).contains('.')) {
+        continue;
+      }
+      const QString target = shard.filePath(file);
+      if (QFile::exists(target)) {
+        QFile::remove(dataDir_.filePath(file));
+      } else {
+        QFile::rename(dataDir_.filePath(file), target);
+      }
+    }
+    ids.insert(userId);
   }
-  obj["posts"] = posts;
+  manifest_ = ids.values();
+  std::sort(manifest_.begin(), manifest_.end());
+  writeManifest();
+}
 
-  return obj;
+// 新用户先追加登记再写数据文件：崩溃时最多留下没有文件的登记，枚举时跳过。
+bool JsonStorage::registerUsers(const QStringList &userIds) const {
+  QMutexLocker locker(&manifestMutex_);
+  QByteArray lines;
+  QStringList added;
+  for (const auto &userId : userIds) {
+    const auto it =
+        std::lower_bound(manifest_.constBegin(), manifest_.constEnd(), userId);
+    if ((it == manifest_.constEnd() || *it != userId) &&
+        !added.contains(userId)) {
+      lines += "+" + userId.toUtf8() + "\n";
+      added << userId;
+    }
+  }
+  if (added.isEmpty()) {
+    return true;
+  }
+  if (!committer_.append(manifestPath(), lines)) {
+    return false;
+  }
+  for (const auto &userId : added) {
+    manifest_.insert(
+        std::lower_bound(manifest_.begin(), manifest_.end(), userId) -
+            manifest_.begin(),
+        userId);
+  }
+  return true;
 }
 
-// 从 JSON 逐段恢复业务数据。
-UserData JsonStorage::deserialize(const QJsonObject &obj) {
-  UserData data;
-  data.profile = UserProfile::fromJson(obj.value("profile").toObject());
+// 整体重写经由组提交器原子替换；调用方持有清单锁或处于构造阶段。
+bool JsonStorage::writeManifest() const {
+  QByteArray bytes;
+  bytes.reserve(manifest_.size() * 40);
+  for (const auto &userId : manifest_) {
+    bytes += "+" + userId.toUtf8() + "\n";
+  }
+  if (!committer_.commit({FileWrite{manifestPath(), bytes}})) {
+    return false;
+  }
+  manifestRemovals_ = 0;
+  return true;
+}
+
+QString JsonStorage::manifestPath() const {
+  return dataDir_.filePath(kManifestName);
+}
+
+// 按模块流式写出所有业务数据，顶层键按名称升序，与 QJsonDocument 的输出一致。
+QByteArray JsonStorage::encode(const UserData &data, JsonWriter::Style style) {
+  // 按各类实体的典型体积预留缓冲区，通常整个编码过程只分配一次。
+  const int estimate = 1024 + data.categories.size() * 128 +
+                       data.bills.size() * 256 + data.reminders.size() * 192 +
+                       data.posts.size() * 384 +
+                       data.rollups.billCount() * 160;
+  JsonWriter out(style, estimate);
+  out.beginObject();
 
-  const auto categories = obj.value("categories").toArray();
-  for (const auto &value : categories) {
-    data.categories.push_back(Category::fromJson(value.toObject()));
+  // 没有归档的文件不写该键，与旧版文件逐字节一致。
+  if (!data.archive.isEmpty()) {
+    out.key("archive");
+    out.beginArray();
+    for (const auto &segment : data.archive) {
+      segment.writeJson(out);
+    }
+    out.endArray();
+  }
+
+  out.key("bills");
+  out.beginArray();
+  for (const auto &bill : data.bills) {
+    bill.writeJson(out);
+  }
+  out.endArray();
+
+  out.key("categories");
+  out.beginArray();
+  for (const auto &category : data.categories) {
+    category.writeJson(out);
   }
+  out.endArray();
 
-  const auto bills = obj.value("bills").toArray();
-  for (const auto &value : bills) {
-    data.bills.push_back(Bill::fromJson(value.toObject()));
+  out.key("posts");
+  out.beginArray();
+  for (const auto &post : data.posts) {
+    post.writeJson(out);
   }
+  out.endArray();
+
+  out.key("profile");
+  data.profile.writeJson(out);
 
-  const auto reminders = obj.value("reminders").toArray();
-  for (const auto &value : reminders) {
-    data.reminders.push_back(Reminder::fromJson(value.toObject()));
+  out.key("reminders");
+  out.beginArray();
+  for (const auto &reminder : data.reminders) {
+    reminder.writeJson(out);
   }
+  out.endArray();
+
+  out.key("rollups");
+  data.rollups.writeJson(out);
 
-  const auto posts = obj.value("posts").toArray();
-  for (const auto &value : posts) {
-    data.posts.push_back(SocialPost::fromJson(value.toObject()));
+  out.endObject();
+  return out.take();
+}
+
+// 键名、ID 与时间戳直接在缓冲区上比较和解析，只为保留下来的字符串分配
+// 内存；汇总表的体积与账单数无关，仍交给 QJsonDocument。
+bool JsonStorage::decode(const QByteArray &bytes, UserData &outData) {
+  JsonReader in(bytes);
+  if (!in.beginObject()) {
+    return false;
+  }
+  UserData data;
+  QJsonObject rollups;
+  QLatin1String key;
+  while (in.nextKey(key)) {
+    if (key == QLatin1String("archive")) {
+      readEntities(in, data.archive, &ArchiveSegment::readJson);
+    } else if (key == QLatin1String("bills")) {
+      readEntities(in, data.bills, &Bill::readJson);
+    } else if (key == QLatin1String("categories")) {
+      readEntities(in, data.categories, &Category::readJson);
+    } else if (key == QLatin1String("posts")) {
+      readEntities(in, data.posts, &SocialPost::readJson);
+    } else if (key == QLatin1String("profile")) {
+      data.profile = UserProfile::readJson(in);
+    } else if (key == QLatin1String("reminders")) {
+      readEntities(in, data.reminders, &Reminder::readJson);
+    } else if (key == QLatin1String("rollups")) {
+      const char *raw = nullptr;
+      int size = 0;
+      if (in.rawValue(raw, size)) {
+        rollups = QJsonDocument::fromJson(QByteArray::fromRawData(raw, size))
+                      .object();
+      }
+    } else {
+      in.skipValue();
+    }
+  }
+  if (!in.ok() || !in.atEnd()) {
+    return false;
   }
 
-  return data;
+  // 先去掉 ID 重复的实体；旧文件没有汇总表，或汇总与账单数量不一致时
+  // 从账单重建。
+  data.reindex();
+  if (!CalendarRollups::fromJson(rollups, data.rollups) ||
+      data.rollups.billCount() != data.bills.size()) {
+    data.rollups = CalendarRollups::build(data.bills);
+  }
+  outData = std::move(data);
+  return true;
 }
 
 }  // namespace core
@@ -7,39 +7,90 @@
 #pragma once
 
 #include "Entities.h"
+#include "GroupCommit.h"
+#include "JsonWriter.h"
 
 #include <QDir>
+#include <QMutex>
 #include <QReadWriteLock>
+#include <QSet>
+#include <QStringList>
 
 namespace core {
 
 // JsonStorage 将每个用户的数据写入独立 JSON 文件，并提供线程安全封装。
+// 用户文件按 ID 的哈希分到两级子目录 users/<xx>/<yy>/ 中，单个目录的条目数
+// 保持在很小的规模；枚举用户读取数据目录下的清单文件，不再遍历目录。
+// 旧版平铺在数据目录下的文件在构造时自动迁入分片目录。
 class JsonStorage {
  public:
-  explicit JsonStorage(const QDir &baseDir = defaultDataDir());
+  explicit JsonStorage(const QDir &baseDir = defaultDataDir(),
+                       const DurabilityOptions &durability = {});
 
   // 返回默认的数据目录，位于 AppData 下的 bookeeper_data。
   static QDir defaultDataDir();
 
-  // 将用户完整数据写入文件。
+  // 将用户完整数据写入文件（临时文件 + fsync + 原子重命名，可与并发保存合批）。
   bool saveUser(const UserData &data) const;
+  // 原子地写入多个用户：全部写入临时文件后再逐个替换，
+  // 任一步失败都会回滚已替换的文件，磁盘上要么全是新版本、要么全是旧版本。
+  bool saveUsers(const QVector<UserData> &batch) const;
   // 从文件中读取指定用户数据。
   bool loadUser(const QString &userId, UserData &outData) const;
-  // 枚举所有用户的基础档案。
+  // 枚举所有用户的基础档案，按用户 ID 排序。
   QVector<UserProfile> listUsers() const;
+  // 清单中的全部用户 ID（已排序），不读取任何用户文件。
+  QStringList userIds() const;
+  // 用户的附属二进制文件（如检索索引），与数据文件同目录，
+  // 名为 <userId>.<suffix>。
+  bool saveBlob(const QString &userId, const QString &suffix,
+                const QByteArray &bytes) const;
+  bool loadBlob(const QString &userId, const QString &suffix,
+                QByteArray &outBytes) const;
+  // 删除一个附属文件；文件本就不存在时同样返回 true。
+  bool removeBlob(const QString &userId, const QString &suffix) const;
   // 删除指定用户的持久化文件。
   bool removeUser(const QString &userId) const;
+  // 用户数据文件与附属文件在磁盘上的总字节数（不含评论库）。
+  qint64 diskUsage(const QString &userId) const;
+  // 将用户数据直接流式编码为 JSON 文本；缩进风格与既有文件格式相同，
+  // 浮点数的写法见 JsonWriter。
+  static QByteArray encode(
+      const UserData &data,
+      JsonWriter::Style style = JsonWriter::Style::Indented);
+  // 流式解码 encode 的输出（或任何等价的 JSON），不合法时返回 false。
+  static bool decode(const QByteArray &bytes, UserData &outData);
+  // 组提交统计，用于观测刷盘的摊销效果。
+  GroupCommitStats commitStats() const { return committer_.stats(); }
+  // 用户文件相对数据目录的路径：users/<xx>/<yy>/<userId>.<suffix>。
+  static QString relativeFilePath(const QString &userId,
+                                  const QString &suffix = "json");
 
  private:
   // 根据用户 ID 拼接数据文件路径。
   QString userFilePath(const QString &userId) const;
-  // 辅助函数：将数据结构编码为 JSON。
-  static QJsonObject serialize(const UserData &data);
-  // 辅助函数：从 JSON 解码为数据结构。
-  static UserData deserialize(const QJsonObject &obj);
+  QString shardFilePath(const QString &userId, const QString &suffix) const;
+  // 分片目录首次使用前清理中断的提交；create 为 true 时按需创建目录。
+  // 每个目录只处理一次，写入前必经此处，因此不会与进行中的提交交错。
+  void prepareShard(const QString &userId, bool create) const;
+  // 清单：启动时加载（缺失时遍历分片目录重建），新用户先登记再写文件。
+  void loadManifest();
+  void rebuildManifest();
+  void migrateFlatLayout();
+  bool registerUsers(const QStringList &userIds) const;
+  bool writeManifest() const;
+  QString manifestPath() const;
 
   QDir dataDir_;
   mutable QReadWriteLock lock_;
+  // 写入经由组提交器完成；重命名是原子的，读者不会看到写了一半的文件。
+  mutable GroupCommitter committer_;
+  // 已排序的用户 ID 与清单日志中的删除记录数，删除过多时整体重写。
+  mutable QMutex manifestMutex_;
+  mutable QStringList manifest_;
+  mutable int manifestRemovals_ = 0;
+  mutable QMutex shardsMutex_;
+  mutable QSet<QString> preparedShards_;
 };
 
 }  // namespace core
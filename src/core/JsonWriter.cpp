@@ -0,0 +1,245 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "JsonWriter.h"
+
+#include "TimestampCodec.h"
+
+#include <QLocale>
+
+#include <algorithm>
+#include <cmath>
+
+namespace core {
+
+namespace {
+
+constexpr int kIndentWidth = 4;
+constexpr int kUuidLength = 36;
+// 小于该值的整数按十进制直接写出，与 'g' 最短格式的结果相同。
+constexpr double kPlainIntegerLimit = 1e6;
+
+char hexDigit(uint value) {
+  return static_cast<char>(value < 10 ? '0' + value : 'a' + value - 10);
+}
+
+}  // namespace
+
+JsonWriter::JsonWriter(Style style, int reserveBytes) : style_(style) {
+  if (reserveBytes > 0) {
+    out_.reserve(reserveBytes);
+  }
+  hasItems_.reserve(8);
+}
+
+void JsonWriter::beginObject() { open('{'); }
+
+void JsonWriter::endObject() { close('}'); }
+
+void JsonWriter::beginArray() { open('['); }
+
+void JsonWriter::endArray() { close(']'); }
+
+void JsonWriter::key(const char *name) {
+  prefix();
+  out_.append('"');
+  out_.append(name);
+  out_.append(style_ == Style::Compact ? "\":" : "\": ");
+  afterKey_ = true;
+}
+
+void JsonWriter::value(const QString &text) {
+  prefix();
+  out_.append('"');
+  appendEscaped(text.constData(), text.size());
+  out_.append('"');
+}
+
+void JsonWriter::value(QLatin1String text) {
+  prefix();
+  out_.append('"');
+  out_.append(text.data(), text.size());
+  out_.append('"');
+}
+
+// 与 QJsonDocument 一致：非有限值写 null，其余使用最短往返表示。
+void JsonWriter::value(double number) {
+  prefix();
+  if (!std::isfinite(number)) {
+    out_.append("null");
+    return;
+  }
+  if (std::fabs(number) < kPlainIntegerLimit &&
+      number == std::trunc(number) && !(number == 0 && std::signbit(number))) {
+    char digits[16];
+    int at = sizeof(digits);
+    qint64 remaining = static_cast<qint64>(std::fabs(number));
+    do {
+      digits[--at] = static_cast<char>('0' + remaining % 10);
+      remaining /= 10;
+    } while (remaining > 0);
+    if (number < 0) {
+      digits[--at] = '-';
+    }
+    out_.append(digits + at, static_cast<int>(sizeof(digits)) - at);
+    return;
+  }
+  out_.append(
+      QByteArray::number(number, 'g', QLocale::FloatingPointShortest));
+}
+
+void JsonWriter::value(bool flag) {
+  prefix();
+  out_.append(flag ? "true" : "false");
+}
+
+void JsonWriter::value(const EntityId &id) {
+  if (id.isEmpty() || id.isInterned()) {
+    value(id.toString());
+    return;
+  }
+  prefix();
+  const int start = out_.size();
+  out_.resize(start + kUuidLength + 2);
+  char *p = out_.data() + start;
+  *p++ = '"';
+  int nibble = 0;
+  for (int i = 0; i < kUuidLength; ++i) {
+    if (i == 8 || i == 13 || i == 18 || i == 23) {
+      *p++ = '-';
+      continue;
+    }
+    const quint64 part = nibble < 16 ? id.high() : id.low();
+    const int shift = (15 - nibble % 16) * 4;
+    *p++ = hexDigit(static_cast<uint>((part >> shift) & 0xF));
+    ++nibble;
+  }
+  *p = '"';
+}
+
+void JsonWriter::value(const QDateTime &timestamp) {
+  if (TimestampCodec::tryFormatFast(timestamp, scratch_)) {
+    value(scratch_);
+    return;
+  }
+  value(TimestampCodec::format(timestamp));
+}
+
+QByteArray JsonWriter::take() {
+  if (style_ == Style::Indented) {
+    out_.append('\n');
+  }
+  hasItems_.clear();
+  afterKey_ = false;
+  QByteArray result;
+  result.swap(out_);
+  return result;
+}
+
+// 紧跟键名的值不需要分隔；容器内第二个及以后的元素前补逗号，缩进风格另起一行。
+void JsonWriter::prefix() {
+  if (afterKey_) {
+    afterKey_ = false;
+    return;
+  }
+  if (hasItems_.isEmpty()) {
+    return;
+  }
+  if (hasItems_.last()) {
+    out_.append(style_ == Style::Compact ? "," : ",\n");
+  }
+  hasItems_.last() = true;
+  indent(hasItems_.size());
+}
+
+void JsonWriter::open(char bracket) {
+  prefix();
+  out_.append(bracket);
+  if (style_ == Style::Indented) {
+    out_.append('\n');
+  }
+  hasItems_.push_back(false);
+}
+
+// 与 Qt 相同：空容器写成 "[\n<缩进>]"，非空容器最后一个元素后换行。
+void JsonWriter::close(char bracket) {
+  const bool hadItems = hasItems_.last();
+  hasItems_.removeLast();
+  if (style_ == Style::Indented && hadItems) {
+    out_.append('\n');
+  }
+  indent(hasItems_.size());
+  out_.append(bracket);
+}
+
+void JsonWriter::indent(int depth) {
+  if (style_ == Style::Indented && depth > 0) {
+    const int start = out_.size();
+    out_.resize(start + depth * kIndentWidth);
+    std::fill(out_.data() + start, out_.data() + out_.size(), ' ');
+  }
+}
+
+// 转义规则照搬 Qt 的 JSON 写出器：控制字符写 \uXXXX，孤立代理写 '?'。
+void JsonWriter::appendEscaped(const QChar *text, int size) {
+  for (int i = 0; i < size; ++i) {
+    const uint u = text[i].unicode();
+    if (u < 0x80) {
+      if (u >= 0x20 && u != '"' && u != '\\') {
+        out_.append(static_cast<char>(u));
+        continue;
+      }
+      out_.append('\\');
+      switch (u) {
+        case '"':
+          out_.append('"');
+          break;
+        case '\\':
+          out_.append('\\');
+          break;
+        case '\b':
+          out_.append('b');
+          break;
+        case '\f':
+          out_.append('f');
+          break;
+        case '\n':
+          out_.append('n');
+          break;
+        case '\r':
+          out_.append('r');
+          break;
+        case '\t':
+          out_.append('t');
+          break;
+        default:
+          out_.append("u00");
+          out_.append(hexDigit(u >> 4));
+          out_.append(hexDigit(u & 0xF));
+          break;
+      }
+    } else if (u < 0x800) {
+      out_.append(static_cast<char>(0xC0 | (u >> 6)));
+      out_.append(static_cast<char>(0x80 | (u & 0x3F)));
+    } else if (!QChar::isSurrogate(u)) {
+      out_.append(static_cast<char>(0xE0 | (u >> 12)));
+      out_.append(static_cast<char>(0x80 | ((u >> 6) & 0x3F)));
+      out_.append(static_cast<char>(0x80 | (u & 0x3F)));
+    } else if (QChar::isHighSurrogate(u) && i + 1 < size &&
+               text[i + 1].isLowSurrogate()) {
+      const uint code = QChar::surrogateToUcs4(
+          static_cast<ushort>(u), text[++i].unicode());
+      out_.append(static_cast<char>(0xF0 | (code >> 18)));
+      out_.append(static_cast<char>(0x80 | ((code >> 12) & 0x3F)));
+      out_.append(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+      out_.append(static_cast<char>(0x80 | (code & 0x3F)));
+    } else {
+      out_.append('?');
+    }
+  }
+}
+
+}  // namespace core
@@ -0,0 +1,76 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QLatin1String>
+#include <QString>
+#include <QVector>
+
+#include "EntityId.h"
+
+namespace core {
+
+// JsonWriter 把 JSON 直接流式写入一块预留好的 UTF-8 缓冲区，不构造
+// QJsonObject/QJsonArray 中间树。缩进与转义与 QJsonDocument::toJson 相同
+// （前提是调用方按键名升序写出对象字段）；浮点数取能精确往返的最短写法，
+// 而 Qt 5.12 等版本固定写出 17 位有效数字，因此只保证解析结果一致，
+// 不保证逐字节相同。
+class JsonWriter {
+ public:
+  enum class Style { Compact, Indented };
+
+  explicit JsonWriter(Style style = Style::Indented, int reserveBytes = 0);
+
+  void beginObject();
+  void endObject();
+  void beginArray();
+  void endArray();
+
+  // 键名必须是无需转义的 ASCII 字面量。
+  void key(const char *name);
+
+  void value(const QString &text);
+  void value(QLatin1String text);
+  void value(double number);
+  void value(int number) { value(static_cast<double>(number)); }
+  void value(bool flag);
+  // 字符串字面量必须显式包成 QLatin1String，避免误转为 bool。
+  void value(const char *text) = delete;
+  // UUID 形式的 ID 直接写十六进制，不生成中间字符串。
+  void value(const EntityId &id);
+  // 时间戳按 TimestampCodec 的格式写出，快速路径复用内部暂存串。
+  void value(const QDateTime &timestamp);
+
+  template <typename T>
+  void field(const char *name, const T &v) {
+    key(name);
+    value(v);
+  }
+
+  const QByteArray &buffer() const { return out_; }
+  // 取走结果；缩进风格与 QJsonDocument 一样以换行结尾。
+  QByteArray take();
+
+ private:
+  // 写值或键之前的分隔符与缩进。
+  void prefix();
+  void open(char bracket);
+  void close(char bracket);
+  void indent(int depth);
+  void appendEscaped(const QChar *text, int size);
+
+  QByteArray out_;
+  Style style_;
+  // 每层容器是否已写过元素。
+  QVector<bool> hasItems_;
+  bool afterKey_ = false;
+  QString scratch_;
+};
+
+}  // namespace core
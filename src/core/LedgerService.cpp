@@ -6,62 +6,155 @@
 
 #include "LedgerService.h"
 
+#include "CsvImporter.h"
+#include "IdGenerator.h"
+#include "MapReduce.h"
+
 #include <QCryptographicHash>
 #include <QDateTime>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMap>
+#include <QMutexLocker>
 #include <QPair>
-#include <QUuid>
+#include <QReadWriteLock>
+#include <QSet>
 #include <QVector>
 #include <algorithm>
 
 namespace core {
 
+// 注册流程的串行化键：用户名/邮箱唯一性校验与写入必须互斥。
+static const QString kRegistryKey = "#registry";
+// 检索索引的附属文件后缀。
+static const QString kSearchIndexSuffix = "search";
+// 评论条数混入检索索引指纹时的乘数（64 位黄金分割常数）。
+
+// 系统报表的部分结果，分类以名称为键。
+struct ReportPart {
+  int users = 0;
+  int bills = 0;
+  double income = 0.0;
+  double expense = 0.0;
+  QHash<QString, CategorySummary> categories;
+};
+
+static void addReportPart(ReportPart &acc, ReportPart &&part) {
+  acc.users += part.users;
+  acc.bills += part.bills;
+  acc.income += part.income;
+  acc.expense += part.expense;
+  for (auto it = part.categories.cbegin(); it != part.categories.cend();
+       ++it) {
+    auto &summary = acc.categories[it.key()];
+    summary.name = it->name;
+    summary.income += it->income;
+    summary.expense += it->expense;
+  }
+}
+
+// 时间线排序：新动态在前，同一时刻按 ID 排序，保证分页时顺序稳定。
+static bool newerPostFirst(const SocialPost &a, const SocialPost &b) {
+  if (a.createdAt != b.createdAt) {
+    return a.createdAt > b.createdAt;
+  }
+  return b.id < a.id;
+}
+
+static void addTotals(RollupTotals &target, const RollupTotals &delta) {
+  target.income += delta.income;
+  target.expense += delta.expense;
+  target.count += delta.count;
+}
+
+// 未归档账单取自汇总表，归档部分取自各段摘要，都不读取账单明细。
+static QHash<EntityId, RollupTotals> categoryTotals(const UserData &data) {
+  QHash<EntityId, RollupTotals> totals = data.rollups.totalsByCategory();
+  for (const auto &segment : data.archive) {
+    for (auto it = segment.byCategory.cbegin();
+         it != segment.byCategory.cend(); ++it) {
+      addTotals(totals[it.key()], it.value());
+    }
+  }
+  return totals;
+}
+
+static RollupTotals grandTotals(const UserData &data) {
+  RollupTotals total = data.rollups.grandTotal();
+  for (const auto &segment : data.archive) {
+    addTotals(total, segment.total());
+  }
+  return total;
+}
+
 // 初始化服务时确定数据目录。
-LedgerService::LedgerService() : storage_(JsonStorage::defaultDataDir()) {}
+LedgerService::LedgerService()
+    : storage_(JsonStorage::defaultDataDir()),
+      archive_(storage_),
+      commentStore_(JsonStorage::defaultDataDir()) {
+  snapshots_.setEvictionHandler(
+      [this](const QString &userId) { dropSearchIndex(userId); });
+}
+
+// 析构前把未保存的检索索引写盘。
+LedgerService::~LedgerService() { flushSearchIndexes(); }
+
+// 显式指定数据目录。
+LedgerService::LedgerService(const QDir &dataDir,
+                             const DurabilityOptions &durability)
+    : storage_(dataDir, durability),
+      archive_(storage_),
+      commentStore_(dataDir, durability) {
+  snapshots_.setEvictionHandler(
+      [this](const QString &userId) { dropSearchIndex(userId); });
+}
 
 // 注册流程包括唯一性校验、默认分类初始化与写入存储。
 bool LedgerService::registerUser(const QString &username, const QString &email,
                                  const QString &password, QString &outUserId,
                                  QString &errorMessage) {
-  const auto existing = storage_.listUsers();
-  for (const auto &profile : existing) {
-    if (profile.username.compare(username, Qt::CaseInsensitive) == 0) {
-      errorMessage = "用户名已存在";
-      return false;
-    }
-    if (profile.email.compare(email, Qt::CaseInsensitive) == 0) {
-      errorMessage = "邮箱已注册";
-      return false;
+  return serialized(kRegistryKey, [&]() -> bool {
+    const auto existing = storage_.listUsers();
+    for (const auto &profile : existing) {
+      if (profile.username.compare(username, Qt::CaseInsensitive) == 0) {
+        errorMessage = "用户名已存在";
+        return false;
+      }
+      if (profile.email.compare(email, Qt::CaseInsensitive) == 0) {
+        errorMessage = "邮箱已注册";
+        return false;
+      }
     }
-  }
 
-  UserData data;
-  data.profile.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
-  data.profile.username = username;
-  data.profile.email = email;
-  data.profile.passwordHash = hashPassword(password);
-  data.profile.notificationsEnabled = true;
-  data.profile.privacyLevel = "friends";
+    UserData data;
+    data.profile.id = IdGenerator::next().toString();
+    data.profile.username = username;
+    data.profile.email = email;
+    data.profile.passwordHash = hashPassword(password);
+    data.profile.notificationsEnabled = true;
+    data.profile.privacyLevel = "friends";
 
-  const QVector<QPair<QString, QString>> defaults = {{"日常支出", "expense"},
-                                                     {"餐饮", "expense"},
-                                                     {"交通", "expense"},
-                                                     {"工资", "income"},
-                                                     {"其他", "expense"}};
-  for (const auto &item : defaults) {
-    Category category;
-    category.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
-    category.name = item.first;
-    category.type = item.second;
-    data.categories.push_back(category);
-  }
+    const QVector<QPair<QString, QString>> defaults = {{"日常支出", "expense"},
+                                                       {"餐饮", "expense"},
+                                                       {"交通", "expense"},
+                                                       {"工资", "income"},
+                                                       {"其他", "expense"}};
+    for (const auto &item : defaults) {
+      Category category;
+      category.id = IdGenerator::next();
+      category.name = item.first;
+      category.type = item.second;
+      data.putCategory(category);
+    }
 
-  if (!storage_.saveUser(data)) {
-    errorMessage = "无法保存用户数据";
-    return false;
-  }
+    if (!saveUser(data)) {
+      errorMessage = "无法保存用户数据";
+      return false;
+    }
 
-  outUserId = data.profile.id;
-  return true;
+    outUserId = data.profile.id;
+    return true;
+  });
 }
 
 // 懒加载遍历查找匹配用户名或邮箱，验证哈希后返回用户。
@@ -88,14 +181,16 @@ bool LedgerService::updateSettings(const QString &userId,
                                    bool notificationsEnabled,
                                    const QString &privacyLevel,
                                    QString &errorMessage) {
-  UserData data;
-  if (!loadUser(userId, data)) {
-    errorMessage = "读取用户失败";
-    return false;
-  }
-  data.profile.notificationsEnabled = notificationsEnabled;
-  data.profile.privacyLevel = privacyLevel;
-  return saveUser(data);
+  return serialized(userId, [&]() -> bool {
+    UserData data;
+    if (!loadUser(userId, data)) {
+      errorMessage = "读取用户失败";
+      return false;
+    }
+    data.profile.notificationsEnabled = notificationsEnabled;
+    data.profile.privacyLevel = privacyLevel;
+    return saveUser(data);
+  });
 }
 
 // 好友互加需同时更新双方的关系表。
@@ -112,207 +207,627 @@ bool LedgerService::addFriend(const QString &userId,
     return false;
   }
 
-  UserData userData;
-  if (!loadUser(userId, userData)) {
-    errorMessage = "读取用户失败";
-    return false;
-  }
-  UserData friendData;
-  if (!loadUser(friendProfile->id, friendData)) {
-    errorMessage = "读取好友失败";
-    return false;
-  }
-
-  if (!userData.profile.friendIds.contains(friendProfile->id)) {
-    userData.profile.friendIds.append(friendProfile->id);
-  }
-  if (!friendData.profile.friendIds.contains(userId)) {
-    friendData.profile.friendIds.append(userId);
-  }
-
-  return saveUser(userData) && saveUser(friendData);
+  const QString friendId = friendProfile->id;
+  return transaction(
+      QStringList{userId, friendId},
+      [&](TransactionViews &users, QString &) {
+        auto &userFriends = users.value(userId)->profile.friendIds;
+        if (!userFriends.contains(friendId)) {
+          userFriends.append(friendId);
+        }
+        auto &friendFriends = users.value(friendId)->profile.friendIds;
+        if (!friendFriends.contains(userId)) {
+          friendFriends.append(userId);
+        }
+        return true;
+      },
+      errorMessage);
 }
 
-// 分类查询读取整个用户数据再返回拷贝。
+// 分类查询直接返回当前快照中的分类（隐式共享，不产生深拷贝）。
 QVector<Category> LedgerService::categories(const QString &userId) const {
-  UserData data;
-  if (!loadUser(userId, data)) {
-    return {};
-  }
-  return data.categories;
+  const auto data = snapshot(userId);
+  return data ? data->categories : QVector<Category>();
 }
 
 // 分类新增或更新，若引用被使用则禁止删除。
 bool LedgerService::upsertCategory(const QString &userId,
                                    const Category &category,
                                    QString &errorMessage) {
-  UserData data;
-  if (!loadUser(userId, data)) {
-    errorMessage = "读取用户失败";
-    return false;
-  }
-
-  Category updated = category;
-  if (updated.id.isEmpty()) {
-    updated.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
-  }
+  return serialized(userId, [&]() -> bool {
+    UserData data;
+    if (!loadUser(userId, data)) {
+      errorMessage = "读取用户失败";
+      return false;
+    }
 
-  bool found = false;
-  for (auto &existing : data.categories) {
-    if (existing.id == updated.id) {
-      existing = updated;
-      found = true;
-      break;
+    Category updated = category;
+    if (updated.id.isEmpty()) {
+      updated.id = IdGenerator::next();
     }
-  }
-  if (!found) {
-    data.categories.push_back(updated);
-  }
-  return saveUser(data);
+
+    data.putCategory(updated);
+    return saveUser(data);
+  });
 }
 
 // 删除分类前需要确认没有账单引用该分类。
 bool LedgerService::removeCategory(const QString &userId,
-                                   const QString &categoryId,
+                                   const EntityId &categoryId,
                                    QString &errorMessage) {
-  UserData data;
-  if (!loadUser(userId, data)) {
-    errorMessage = "读取用户失败";
-    return false;
-  }
+  return serialized(userId, [&]() -> bool {
+    UserData data;
+    if (!loadUser(userId, data)) {
+      errorMessage = "读取用户失败";
+      return false;
+    }
 
-  const bool inUse =
-      std::any_of(data.bills.begin(), data.bills.end(), [&](const Bill &bill) {
-        return bill.categoryId == categoryId;
-      });
-  if (inUse) {
-    errorMessage = "分类被账单使用，无法删除";
-    return false;
-  }
+    const bool inUse =
+        std::any_of(
+            data.bills.begin(), data.bills.end(),
+            [&](const Bill &bill) { return bill.categoryId == categoryId; }) ||
+        std::any_of(data.archive.begin(), data.archive.end(),
+                    [&](const ArchiveSegment &segment) {
+                      return segment.byCategory.contains(categoryId);
+                    });
+    if (inUse) {
+      errorMessage = "分类被账单使用，无法删除";
+      return false;
+    }
 
-  data.categories.erase(
-      std::remove_if(data.categories.begin(), data.categories.end(),
-                     [&](const Category &cat) { return cat.id == categoryId; }),
-      data.categories.end());
-  return saveUser(data);
+    const int index = data.findCategory(categoryId);
+    if (index >= 0) {
+      data.eraseCategoryAt(index);
+    }
+    return saveUser(data);
+  });
 }
 
 // 账单增删改流程与分类类似，需校验分类存在。
 QVector<Bill> LedgerService::bills(const QString &userId) const {
-  UserData data;
-  if (!loadUser(userId, data)) {
+  const auto data = snapshot(userId);
+  return data ? data->bills : QVector<Bill>();
+}
+
+QVector<Bill> LedgerService::bills(const QString &userId, const QDate &from,
+                                   const QDate &to) const {
+  auto data = snapshot(userId);
+  if (!data) {
     return {};
   }
-  return data.bills;
+  // 归档段按整月读取，段内超出区间的账单与未归档部分一样按日期筛掉。
+  QVector<Bill> archived;
+  readArchived(userId, data, from, to, archived);
+  QVector<Bill> result;
+  auto collect = [&](const QVector<Bill> &part) {
+    for (const auto &bill : part) {
+      const QDate date = bill.timestamp.date();
+      if ((!from.isValid() || date >= from) && (!to.isValid() || date <= to)) {
+        result.push_back(bill);
+      }
+    }
+  };
+  collect(data->bills);
+  collect(archived);
+  return result;
+}
+
+// 归档段按月份升序保存，最早的段即最早的归档月份。
+QDate LedgerService::earliestBillDate(const QString &userId) const {
+  const auto data = snapshot(userId);
+  if (!data) {
+    return {};
+  }
+  QDate earliest = data->archive.isEmpty() ? QDate()
+                                           : data->archive.first().month;
+  for (const auto &bill : data->bills) {
+    const QDate date = bill.timestamp.date();
+    if (date.isValid() && (!earliest.isValid() || date < earliest)) {
+      earliest = date;
+    }
+  }
+  return earliest;
 }
 
 // 新建或编辑账单，同时补全缺失的 ID 与时间戳。
 bool LedgerService::upsertBill(const QString &userId, const Bill &bill,
                                QString &errorMessage) {
-  UserData data;
-  if (!loadUser(userId, data)) {
-    errorMessage = "读取用户失败";
-    return false;
-  }
+  return serialized(userId, [&]() -> bool {
+    UserData data;
+    if (!loadUser(userId, data)) {
+      errorMessage = "读取用户失败";
+      return false;
+    }
 
-  Bill updated = bill;
-  if (updated.id.isEmpty()) {
-    updated.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
-  }
-  if (!updated.timestamp.isValid()) {
-    updated.timestamp = QDateTime::currentDateTime();
-  }
+    Bill updated = bill;
+    if (updated.id.isEmpty()) {
+      updated.id = IdGenerator::next();
+    }
+    if (!updated.timestamp.isValid()) {
+      updated.timestamp = QDateTime::currentDateTime();
+    }
 
-  const bool categoryExists = std::any_of(
-      data.categories.begin(), data.categories.end(),
-      [&](const Category &cat) { return cat.id == updated.categoryId; });
-  if (!categoryExists) {
-    errorMessage = "分类不存在";
-    return false;
-  }
+    if (data.findCategory(updated.categoryId) < 0) {
+      errorMessage = "分类不存在";
+      return false;
+    }
 
-  bool found = false;
-  for (auto &existing : data.bills) {
-    if (existing.id == updated.id) {
-      existing = updated;
-      found = true;
-      break;
+    // 编辑已归档的账单时先取回（优先查新时间所在的月份），再按普通账单更新。
+    QVector<ArchiveSegment> stale;
+    if (!bill.id.isEmpty() && data.findBill(updated.id) < 0 &&
+        !restoreArchivedBills(data, {updated.id},
+                              {BillArchive::monthOf(updated)}, stale,
+                              errorMessage)) {
+      return false;
     }
+    const int existing = data.findBill(updated.id);
+    if (existing >= 0) {
+      data.rollups.remove(data.bills[existing]);
+    }
+    data.putBill(updated);
+    data.rollups.add(updated);
+    if (!saveUser(data)) {
+      return false;
+    }
+    discardSegments(userId, stale);
+    updateSearchIndex(userId, [&](SearchIndex &index) {
+      index.upsert(SearchKind::Bill, updated.id.toString(), QString(),
+                   updated.note);
+    });
+    return true;
+  });
+}
+
+namespace {
+
+// 记录一条被拒绝的行，超出上限后只计数不保留文本。
+void rejectRow(ImportReport &report, int row, const QString &reason) {
+  ++report.rejected;
+  if (report.errors.size() < kMaxImportErrors) {
+    report.errors << QString("第%1行: %2").arg(row).arg(reason);
   }
-  if (!found) {
-    data.bills.push_back(updated);
-  }
-  return saveUser(data);
 }
 
-// 删除指定账单，若未找到则返回错误提示。
-bool LedgerService::removeBill(const QString &userId, const QString &billId,
-                               QString &errorMessage) {
-  UserData data;
-  if (!loadUser(userId, data)) {
+void finishReport(ImportReport &report, const QElapsedTimer &timer) {
+  report.elapsedMs = timer.elapsed();
+  const qint64 nanos = std::max<qint64>(1, timer.nsecsElapsed());
+  report.rowsPerSecond = report.rows * 1e9 / static_cast<double>(nanos);
+}
+
+}  // namespace
+
+// 批量导入：分类用哈希集合校验，账单 ID 用哈希索引去重，整批只保存一次。
+bool LedgerService::importBills(const QString &userId,
+                                const QVector<Bill> &rows,
+                                ImportReport &report, QString &errorMessage) {
+  QElapsedTimer timer;
+  timer.start();
+  report.rows += rows.size();
+  const bool ok = serialized(userId, [&]() -> bool {
+    UserData data;
+    if (!loadUser(userId, data)) {
+      errorMessage = "读取用户失败";
+      return false;
+    }
+
+    data.bills.reserve(data.bills.size() + rows.size());
+
+    // 覆盖已归档账单的行：一次取回这些账单（先查各行所在月份的段），
+    // 之后按更新计数。
+    QSet<EntityId> archivedIds;
+    QSet<QDate> archivedMonths;
+    if (!data.archive.isEmpty()) {
+      for (const auto &bill : rows) {
+        if (!bill.id.isEmpty() && data.findBill(bill.id) < 0) {
+          archivedIds.insert(bill.id);
+          if (bill.timestamp.isValid()) {
+            archivedMonths.insert(BillArchive::monthOf(bill));
+          }
+        }
+      }
+    }
+    QVector<ArchiveSegment> stale;
+    if (!restoreArchivedBills(data, archivedIds, archivedMonths, stale,
+                              errorMessage)) {
+      return false;
+    }
+
+    const QDateTime now = QDateTime::currentDateTime();
+    QVector<Bill> accepted;
+    for (int row = 0; row < rows.size(); ++row) {
+      Bill bill = rows[row];
+      if (data.findCategory(bill.categoryId) < 0) {
+        rejectRow(report, row + 1, "分类不存在");
+        continue;
+      }
+      if (bill.id.isEmpty()) {
+        bill.id = IdGenerator::next();
+      }
+      if (!bill.timestamp.isValid()) {
+        bill.timestamp = now;
+      }
+      accepted.push_back(bill);
+      const int existing = data.findBill(bill.id);
+      data.rollups.add(bill);
+      if (existing >= 0) {
+        data.rollups.remove(data.bills[existing]);
+        ++report.updated;
+      } else {
+        ++report.inserted;
+      }
+      data.putBill(bill);
+    }
+
+    if (accepted.isEmpty() && stale.isEmpty()) {
+      return true;
+    }
+    if (!saveUser(data)) {
+      errorMessage = "无法保存用户数据";
+      return false;
+    }
+    discardSegments(userId, stale);
+    updateSearchIndex(userId, [&](SearchIndex &index) {
+      for (const auto &bill : accepted) {
+        index.upsert(SearchKind::Bill, bill.id.toString(), QString(),
+                     bill.note);
+      }
+    });
+    return true;
+  });
+  finishReport(report, timer);
+  return ok;
+}
+
+// CSV 导入：先按当前分类流式解析，再整批写入；解析失败的行同样记入报告。
+bool LedgerService::importCsv(const QString &userId, QIODevice &device,
+                              ImportReport &report, QString &errorMessage) {
+  QElapsedTimer timer;
+  timer.start();
+  const auto current = snapshot(userId);
+  if (!current) {
     errorMessage = "读取用户失败";
     return false;
   }
 
-  const auto before = data.bills.size();
-  data.bills.erase(
-      std::remove_if(data.bills.begin(), data.bills.end(),
-                     [&](const Bill &bill) { return bill.id == billId; }),
-      data.bills.end());
-  if (before == data.bills.size()) {
-    errorMessage = "未找到账单";
+  CsvBillImporter importer(current->categories);
+  QVector<Bill> rows;
+  if (!importer.parse(device, rows, errorMessage)) {
     return false;
   }
-  return saveUser(data);
+  report.rows += importer.invalidRows().size();
+  for (const auto &invalid : importer.invalidRows()) {
+    rejectRow(report, invalid.first, invalid.second);
+  }
+  const bool ok = importBills(userId, rows, report, errorMessage);
+  finishReport(report, timer);
+  return ok;
 }
 
-// 汇总接口合并分类与账单，方便 UI 可视化。
+// 删除指定账单，若未找到则返回错误提示。
+bool LedgerService::removeBill(const QString &userId, const EntityId &billId,
+                               QString &errorMessage) {
+  return serialized(userId, [&]() -> bool {
+    UserData data;
+    if (!loadUser(userId, data)) {
+      errorMessage = "读取用户失败";
+      return false;
+    }
+
+    // 不在近期账单中时查找全部归档段，取回后按普通账单删除。
+    QVector<ArchiveSegment> stale;
+    if (data.findBill(billId) < 0 &&
+        !restoreArchivedBills(data, {billId}, {}, stale, errorMessage)) {
+      return false;
+    }
+    const int index = data.findBill(billId);
+    if (index < 0) {
+      errorMessage = "未找到账单";
+      return false;
+    }
+    data.rollups.remove(data.bills[index]);
+    data.eraseBillAt(index);
+    if (!saveUser(data)) {
+      return false;
+    }
+    discardSegments(userId, stale);
+    updateSearchIndex(userId, [&](SearchIndex &index) {
+      index.remove(SearchKind::Bill, billId.toString());
+    });
+    return true;
+  });
+}
+
+// 汇总接口直接读取预聚合的分类合计与归档段摘要，代价与年份数、归档月数
+// 和分类数相关。
 QVector<CategorySummary>
 LedgerService::summarizeByCategory(const QString &userId) const {
-  UserData data;
-  if (!loadUser(userId, data)) {
+  const auto data = snapshot(userId);
+  if (!data) {
     return {};
   }
+  const auto totals = categoryTotals(*data);
   QVector<CategorySummary> summaries;
-  for (const auto &category : data.categories) {
+  summaries.reserve(data->categories.size());
+  for (const auto &category : data->categories) {
     CategorySummary summary;
     summary.categoryId = category.id;
     summary.name = category.name;
-    summaries.push_back(summary);
-  }
-  for (const auto &bill : data.bills) {
-    auto it = std::find_if(summaries.begin(), summaries.end(),
-                           [&](const CategorySummary &summary) {
-                             return summary.categoryId == bill.categoryId;
-                           });
-    if (it != summaries.end()) {
-      if (bill.type == BillType::Income) {
-        it->income += bill.amount;
-      } else {
-        it->expense += bill.amount;
-      }
+    const auto it = totals.constFind(category.id);
+    if (it != totals.constEnd()) {
+      summary.income = it->income;
+      summary.expense = it->expense;
     }
+    summaries.push_back(summary);
   }
   return summaries;
 }
 
-// 统计总收入/总支出时直接遍历账单。
+// 统计总收入。
 double LedgerService::totalIncome(const QString &userId) const {
-  double total = 0.0;
-  for (const auto &bill : bills(userId)) {
-    if (bill.type == BillType::Income) {
-      total += bill.amount;
-    }
-  }
-  return total;
+  const auto data = snapshot(userId);
+  return data ? grandTotals(*data).income : 0.0;
 }
 
 // 统计总支出。
 double LedgerService::totalExpense(const QString &userId) const {
-  double total = 0.0;
-  for (const auto &bill : bills(userId)) {
-    if (bill.type == BillType::Expense) {
-      total += bill.amount;
+  const auto data = snapshot(userId);
+  return data ? grandTotals(*data).expense : 0.0;
+}
+
+// 每个用户的分类合计直接取自预聚合表与归档段摘要，不遍历账单。
+SystemReport LedgerService::systemReport() const {
+  QElapsedTimer timer;
+  timer.start();
+  ReportPart total = mapReduce<ReportPart>(
+      storage_.userIds(),
+      [this](const QString &id) {
+        ReportPart part;
+        UserData loaded;
+        const UserSnapshot cached = snapshots_.peek(id);
+        const UserData *data = cached.get();
+        if (!data) {
+          if (!storage_.loadUser(id, loaded)) {
+            return part;
+          }
+          data = &loaded;
+        }
+        part.users = 1;
+        part.bills = data->bills.size();
+        for (const auto &segment : data->archive) {
+          part.bills += segment.count;
+        }
+        const auto grand = grandTotals(*data);
+        part.income = grand.income;
+        part.expense = grand.expense;
+        const auto totals = categoryTotals(*data);
+        for (const auto &category : data->categories) {
+          const auto it = totals.constFind(category.id);
+          if (it == totals.constEnd()) {
+            continue;
+          }
+          auto &summary = part.categories[category.name];
+          summary.name = category.name;
+          summary.income += it->income;
+          summary.expense += it->expense;
+        }
+        return part;
+      },
+      addReportPart, addReportPart);
+
+  SystemReport report;
+  report.users = total.users;
+  report.bills = total.bills;
+  report.income = total.income;
+  report.expense = total.expense;
+  report.categories = total.categories.values().toVector();
+  std::sort(report.categories.begin(), report.categories.end(),
+            [](const CategorySummary &a, const CategorySummary &b) {
+              if (a.expense != b.expense) {
+                return a.expense > b.expense;
+              }
+              return a.name < b.name;
+            });
+  report.elapsedMs = timer.elapsed();
+  return report;
+}
+
+// 已缓存的用户直接取发布时的估算；其余用户临时读文件估算，用完即弃。
+QVector<UserFootprint> LedgerService::footprints() const {
+  QHash<QString, MemoryFootprint> cached;
+  for (const auto &entry : snapshots_.footprints()) {
+    cached.insert(entry.first, entry.second);
+  }
+  auto result = mapReduce<QVector<UserFootprint>>(
+      storage_.userIds(),
+      [&](const QString &id) {
+        UserFootprint footprint;
+        footprint.userId = id;
+        footprint.diskBytes = storage_.diskUsage(id);
+        const auto it = cached.constFind(id);
+        if (it != cached.constEnd()) {
+          footprint.memory = it.value();
+          footprint.cached = true;
+          return footprint;
+        }
+        UserData loaded;
+        if (storage_.loadUser(id, loaded)) {
+          footprint.memory = MemoryFootprint::of(loaded);
+        }
+        return footprint;
+      },
+      [](QVector<UserFootprint> &acc, UserFootprint &&footprint) {
+        acc.push_back(std::move(footprint));
+      },
+      [](QVector<UserFootprint> &acc, QVector<UserFootprint> &&partial) {
+        acc += partial;
+      });
+  std::sort(result.begin(), result.end(),
+            [](const UserFootprint &a, const UserFootprint &b) {
+              if (a.memory.total() != b.memory.total()) {
+                return a.memory.total() > b.memory.total();
+              }
+              return a.userId < b.userId;
+            });
+  return result;
+}
+
+MemoryGauge LedgerService::memoryGauge() const { return snapshots_.gauge(); }
+
+void LedgerService::setMemoryBudget(qint64 bytes) {
+  snapshots_.setMemoryBudget(bytes);
+}
+
+// 按日/周/月/年返回区间内的收支序列。未归档部分由预聚合表直接提供；
+// 归档段按自然月切分，月、年粒度直接累加段摘要，日、周粒度只解压与
+// 区间相交的段，临时汇总后逐点相加。
+QVector<RollupPoint> LedgerService::periodSeries(
+    const QString &userId, RollupPeriod period, const QDate &from,
+    const QDate &to, const EntityId &categoryId) const {
+  const auto data = snapshot(userId);
+  if (!data) {
+    return {};
+  }
+  auto points = data->rollups.series(period, from, to, categoryId);
+  if (points.isEmpty() || data->archive.isEmpty()) {
+    return points;
+  }
+  const QDate first = points.first().start;
+  const QDate last =
+      CalendarRollups::nextBucket(period, points.last().start).addDays(-1);
+  if (period == RollupPeriod::Month || period == RollupPeriod::Year) {
+    for (const auto &segment : data->archive) {
+      if (!segment.overlaps(first, last)) {
+        continue;
+      }
+      const QDate start = CalendarRollups::bucketStart(period, segment.month);
+      const auto it = std::lower_bound(
+          points.begin(), points.end(), start,
+          [](const RollupPoint &point, const QDate &date) {
+            return point.start < date;
+          });
+      if (it != points.end() && it->start == start) {
+        addTotals(it->totals, categoryId.isEmpty()
+                                  ? segment.total()
+                                  : segment.byCategory.value(categoryId));
+      }
+    }
+    return points;
+  }
+  // 归档读取失败时只返回未归档部分，与归档前的行为一致；换用了新快照
+  // 时未归档部分也按新快照重新取。
+  auto current = data;
+  QVector<Bill> archived;
+  if (!readArchived(userId, current, first, last, archived)) {
+    return points;
+  }
+  if (current != data) {
+    points = current->rollups.series(period, from, to, categoryId);
+  }
+  if (archived.isEmpty()) {
+    return points;
+  }
+  const auto archivedPoints = CalendarRollups::build(archived).series(
+      period, from, to, categoryId);
+  for (int i = 0; i < points.size() && i < archivedPoints.size(); ++i) {
+    addTotals(points[i].totals, archivedPoints[i].totals);
+  }
+  return points;
+}
+
+// 按月归档：已有段的月份与本次的冷账单合并后写出新版本。段文件先于用户
+// 文件写入，提交前失败只会留下未被引用的新版本文件（下次写同一版本时
+// 覆盖）；提交成功后才删除被取代的旧版本。
+bool LedgerService::archiveBills(const QString &userId, const QDate &before,
+                                 int &archived, QString &errorMessage) {
+  archived = 0;
+  return serialized(userId, [&]() -> bool {
+    UserData data;
+    if (!loadUser(userId, data)) {
+      errorMessage = "读取用户失败";
+      return false;
+    }
+
+    QMap<QDate, QVector<Bill>> cold;
+    QVector<Bill> hot;
+    hot.reserve(data.bills.size());
+    for (const auto &bill : data.bills) {
+      if (bill.timestamp.isValid() && bill.timestamp.date() < before) {
+        cold[BillArchive::monthOf(bill)].push_back(bill);
+      } else {
+        hot.push_back(bill);
+      }
+    }
+    if (cold.isEmpty()) {
+      return true;
+    }
+
+    QVector<ArchiveSegment> stale;
+    int count = 0;
+    for (auto it = cold.cbegin(); it != cold.cend(); ++it) {
+      QVector<Bill> bills = it.value();
+      int version = 1;
+      const auto existing = std::find_if(
+          data.archive.begin(), data.archive.end(),
+          [&](const ArchiveSegment &segment) {
+            return segment.month == it.key();
+          });
+      if (existing != data.archive.end()) {
+        QVector<Bill> previous;
+        if (!archive_.read(userId, *existing, previous)) {
+          errorMessage = "读取归档失败";
+          return false;
+        }
+        bills = previous + bills;
+        version = existing->version + 1;
+      }
+      ArchiveSegment segment;
+      if (!archive_.write(userId, it.key(), version, bills, segment)) {
+        errorMessage = "写入归档失败";
+        return false;
+      }
+      if (existing != data.archive.end()) {
+        stale.push_back(*existing);
+        *existing = segment;
+      } else {
+        data.archive.push_back(segment);
+      }
+      for (const auto &bill : it.value()) {
+        data.rollups.remove(bill);
+      }
+      count += it.value().size();
+    }
+    std::sort(data.archive.begin(), data.archive.end(),
+              [](const ArchiveSegment &a, const ArchiveSegment &b) {
+                return a.month < b.month;
+              });
+    data.bills = hot;
+    data.reindex();
+    if (!saveUser(data)) {
+      errorMessage = "无法保存用户数据";
+      return false;
+    }
+    discardSegments(userId, stale);
+    // 全文检索只覆盖近期账单；归档账单仍可经带日期条件的过滤查询找到。
+    updateSearchIndex(userId, [&](SearchIndex &index) {
+      for (const auto &bills : cold) {
+        for (const auto &bill : bills) {
+          index.remove(SearchKind::Bill, bill.id.toString());
+        }
+      }
+    });
+    archived = count;
+    return true;
+  });
+}
+
+// 逐个用户归档，单个用户失败不影响其余用户。
+int LedgerService::archiveColdBills(const QDate &before) {
+  int total = 0;
+  for (const auto &userId : storage_.userIds()) {
+    int archived = 0;
+    QString errorMessage;
+    if (archiveBills(userId, before, archived, errorMessage)) {
+      total += archived;
     }
   }
   return total;
@@ -320,66 +835,52 @@ double LedgerService::totalExpense(const QString &userId) const {
 
 // 提醒相关接口在保存时确保时间有效。
 QVector<Reminder> LedgerService::reminders(const QString &userId) const {
-  UserData data;
-  if (!loadUser(userId, data)) {
-    return {};
-  }
-  return data.reminders;
+  const auto data = snapshot(userId);
+  return data ? data->reminders : QVector<Reminder>();
 }
 
 // 新建或更新提醒，自动补齐缺失的 ID 与时间。
 bool LedgerService::upsertReminder(const QString &userId,
                                    const Reminder &reminder,
                                    QString &errorMessage) {
-  UserData data;
-  if (!loadUser(userId, data)) {
-    errorMessage = "读取用户失败";
-    return false;
-  }
-
-  Reminder updated = reminder;
-  if (updated.id.isEmpty()) {
-    updated.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
-  }
-  if (!updated.remindAt.isValid()) {
-    updated.remindAt = QDateTime::currentDateTime();
-  }
+  return serialized(userId, [&]() -> bool {
+    UserData data;
+    if (!loadUser(userId, data)) {
+      errorMessage = "读取用户失败";
+      return false;
+    }
 
-  bool found = false;
-  for (auto &existing : data.reminders) {
-    if (existing.id == updated.id) {
-      existing = updated;
-      found = true;
-      break;
+    Reminder updated = reminder;
+    if (updated.id.isEmpty()) {
+      updated.id = IdGenerator::next();
     }
-  }
-  if (!found) {
-    data.reminders.push_back(updated);
-  }
-  return saveUser(data);
+    if (!updated.remindAt.isValid()) {
+      updated.remindAt = QDateTime::currentDateTime();
+    }
+
+    data.putReminder(updated);
+    return saveUser(data);
+  });
 }
 
 // 删除提醒，若未找到则反馈错误。
 bool LedgerService::removeReminder(const QString &userId,
-                                   const QString &reminderId,
+                                   const EntityId &reminderId,
                                    QString &errorMessage) {
-  UserData data;
-  if (!loadUser(userId, data)) {
-    errorMessage = "读取用户失败";
-    return false;
-  }
-  const auto before = data.reminders.size();
-  data.reminders.erase(std::remove_if(data.reminders.begin(),
-                                      data.reminders.end(),
-                                      [&](const Reminder &reminder) {
-                                        return reminder.id == reminderId;
-                                      }),
-                       data.reminders.end());
-  if (before == data.reminders.size()) {
-    errorMessage = "未找到提醒";
-    return false;
-  }
-  return saveUser(data);
+  return serialized(userId, [&]() -> bool {
+    UserData data;
+    if (!loadUser(userId, data)) {
+      errorMessage = "读取用户失败";
+      return false;
+    }
+    const int index = data.findReminder(reminderId);
+    if (index < 0) {
+      errorMessage = "未找到提醒";
+      return false;
+    }
+    data.eraseReminderAt(index);
+    return saveUser(data);
+  });
 }
 
 // 根据时间窗口筛选启用状态的提醒。
@@ -400,40 +901,65 @@ QVector<Reminder> LedgerService::upcomingReminders(const QString &userId,
 
 // 时间线会汇总本人、好友与公开动态，按时间倒序排序。
 QVector<SocialPost> LedgerService::timeline(const QString &userId) const {
-  UserData viewerData;
-  if (!loadUser(userId, viewerData)) {
-    return {};
+  auto posts = visiblePosts(userId);
+  std::sort(posts.begin(), posts.end(), newerPostFirst);
+  for (auto &post : posts) {
+    attachComments(post);
   }
+  return posts;
+}
 
-  QVector<SocialPost> posts = viewerData.posts;
-  const auto profiles = storage_.listUsers();
-  for (const auto &profile : profiles) {
-    if (profile.id == userId) {
-      continue;
-    }
-
-    UserData authorData;
-    if (!loadUser(profile.id, authorData)) {
-      continue;
-    }
-
-    const bool isFriend = viewerData.profile.friendIds.contains(profile.id) &&
-                          authorData.profile.friendIds.contains(userId);
+// 只需把前 offset + limit 条排好序，评论摘要也只为本页读取。
+QVector<SocialPost> LedgerService::timelinePage(const QString &userId,
+                                                int offset, int limit,
+                                                int *total) const {
+  auto posts = visiblePosts(userId);
+  if (total) {
+    *total = posts.size();
+  }
+  const int begin = qBound(0, offset, posts.size());
+  const int end = limit < 0 ? posts.size()
+                            : std::min(posts.size(), begin + limit);
+  std::partial_sort(posts.begin(), posts.begin() + end, posts.end(),
+                    newerPostFirst);
+  QVector<SocialPost> page;
+  page.reserve(end - begin);
+  for (int i = begin; i < end; ++i) {
+    page.push_back(posts[i]);
+    attachComments(page.last());
+  }
+  return page;
+}
 
-    for (const auto &post : authorData.posts) {
-      if (post.visibility == "public") {
-        posts.push_back(post);
-      } else if (post.visibility == "friends" && isFriend) {
-        posts.push_back(post);
-      }
+// 可见性规则与 timeline 一致：本人、公开动态，或互为好友时的仅好友动态。
+QVector<Comment> LedgerService::postComments(const QString &viewerId,
+                                             const QString &postOwnerId,
+                                             const EntityId &postId,
+                                             int offset, int limit,
+                                             int *total) const {
+  if (total) {
+    *total = 0;
+  }
+  const auto owner = socialProjection(postOwnerId);
+  if (!owner) {
+    return {};
+  }
+  const auto post = std::find_if(
+      owner->posts.constBegin(), owner->posts.constEnd(),
+      [&](const SocialPost &candidate) { return candidate.id == postId; });
+  if (post == owner->posts.constEnd()) {
+    return {};
+  }
+  if (viewerId != postOwnerId &&
+      post->visibility == PostVisibility::Friends) {
+    const auto viewerData = snapshot(viewerId);
+    if (!viewerData ||
+        !viewerData->profile.friendIds.contains(postOwnerId) ||
+        !owner->friendIds.contains(viewerId)) {
+      return {};
     }
   }
-
-  std::sort(posts.begin(), posts.end(),
-            [](const SocialPost &a, const SocialPost &b) {
-              return a.createdAt > b.createdAt;
-            });
-  return posts;
+  return commentStore_.read(postId, offset, limit, total);
 }
 
 // 发布动态生成新的 UUID 并写入时间戳。
@@ -444,80 +970,630 @@ bool LedgerService::publishPost(const QString &userId, const QString &content,
     errorMessage = "内容不能为空";
     return false;
   }
-
-  UserData data;
-  if (!loadUser(userId, data)) {
-    errorMessage = "读取用户失败";
+  PostVisibility parsedVisibility = PostVisibility::Public;
+  if (!parseVisibility(visibility, parsedVisibility)) {
+    errorMessage = "可见范围无效";
     return false;
   }
 
-  SocialPost post;
-  post.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
-  post.authorId = userId;
-  post.content = content;
-  post.visibility = visibility;
-  post.createdAt = QDateTime::currentDateTimeUtc();
+  return serialized(userId, [&]() -> bool {
+    UserData data;
+    if (!loadUser(userId, data)) {
+      errorMessage = "读取用户失败";
+      return false;
+    }
+
+    SocialPost post;
+    post.id = IdGenerator::next();
+    post.authorId = userId;
+    post.content = content;
+    post.visibility = parsedVisibility;
+    post.createdAt = QDateTime::currentDateTimeUtc();
 
-  data.posts.push_back(post);
-  return saveUser(data);
+    data.putPost(post);
+    if (!saveUser(data)) {
+      return false;
+    }
+    updateSearchIndex(userId, [&](SearchIndex &index) {
+      index.upsert(SearchKind::Post, post.id.toString(), QString(),
+                   post.content);
+    });
+    return true;
+  });
 }
 
-// 评论追加到动态所属用户的数据中。
+// 评论追加到该动态独立的评论串中，不再改写作者的数据文件。仍在作者的
+// 执行器上运行，使检索索引的增量更新与索引落盘时的指纹保持一致。
 bool LedgerService::addComment(const QString &userId,
                                const QString &postOwnerId,
-                               const QString &postId, const QString &content,
+                               const EntityId &postId, const QString &content,
                                QString &errorMessage) {
   if (content.trimmed().isEmpty()) {
     errorMessage = "评论不能为空";
     return false;
   }
 
-  UserData ownerData;
-  if (!loadUser(postOwnerId, ownerData)) {
-    errorMessage = "读取动态失败";
+  return serialized(postOwnerId, [&]() -> bool {
+    const auto ownerData = snapshot(postOwnerId);
+    if (!ownerData) {
+      errorMessage = "读取动态失败";
+      return false;
+    }
+    if (ownerData->findPost(postId) < 0) {
+      errorMessage = "未找到动态";
+      return false;
+    }
+
+    Comment comment;
+    comment.id = IdGenerator::next();
+    comment.authorId = userId;
+    comment.content = content;
+    comment.createdAt = QDateTime::currentDateTimeUtc();
+
+    if (!commentStore_.append(postId, comment)) {
+      errorMessage = "无法保存评论";
+      return false;
+    }
+    indexComment(postOwnerId, postId, comment);
+    return true;
+  });
+}
+
+// 读取用户档案的统一入口。
+std::optional<UserProfile> LedgerService::profile(const QString &userId) const {
+  const auto data = snapshot(userId);
+  if (!data) {
+    return std::nullopt;
+  }
+  return data->profile;
+}
+
+// 读路径只做原子加载；缓存未命中时从存储加载并尝试发布为当前快照。
+// 读盘前记下发布代数：读盘期间有提交发布过时，读到的可能是提交前的
+// 文件，放弃发布并重新加载。
+UserSnapshot LedgerService::snapshot(const QString &userId) const {
+  for (;;) {
+    if (auto current = snapshots_.current(userId)) {
+      return current;
+    }
+    const quint64 generation = snapshots_.generation(userId);
+    auto loaded = std::make_shared<UserData>();
+    if (!storage_.loadUser(userId, *loaded)) {
+      return nullptr;
+    }
+    migrateLegacyComments(*loaded);
+    if (auto published = snapshots_.publishIfAbsent(
+            userId, std::move(loaded), generation)) {
+      return published;
+    }
+  }
+}
+
+// 查询在快照上执行，不阻塞写入；表达式每次调用编译一次。
+bool LedgerService::queryBills(const QString &userId,
+                               const QString &expression,
+                               BillQueryResult &result,
+                               QString &errorMessage) const {
+  auto data = snapshot(userId);
+  if (!data) {
+    errorMessage = "读取用户失败";
+    return false;
+  }
+  BillQuery query;
+  if (!BillQuery::compile(expression, data->categories, query,
+                          errorMessage)) {
     return false;
   }
+  // 只解压与查询日期区间相交的归档段，与近期账单合并后统一求值。
+  QVector<Bill> archived;
+  if (!readArchived(userId, data, query.dateFrom(), query.dateTo(),
+                    archived)) {
+    errorMessage = "读取归档失败";
+    return false;
+  }
+  if (archived.isEmpty()) {
+    result = query.run(data->bills, *billTimeOrder(userId, data));
+    return true;
+  }
+  const QVector<Bill> bills = data->bills + archived;
+  result = query.run(bills, BillQuery::timeOrder(bills));
+  return true;
+}
 
-  Comment comment;
-  comment.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
-  comment.authorId = userId;
-  comment.content = content;
-  comment.createdAt = QDateTime::currentDateTimeUtc();
+// 检索在读锁下进行；索引首次使用时优先加载持久化文件，指纹不符则全量重建。
+// 用户存在才创建索引条目，加载后的占用记在快照上，随快照一同逐出。
+QVector<SearchHit> LedgerService::search(const QString &userId,
+                                         const QString &query,
+                                         int limit) const {
+  if (!snapshot(userId)) {
+    return {};
+  }
+  auto entry = searchIndexFor(userId);
+  {
+    QReadLocker locker(&entry->lock);
+    if (entry->ready) {
+      return entry->index.search(query, limit);
+    }
+  }
+  QWriteLocker locker(&entry->lock);
+  if (!entry->ready) {
+    const auto data = snapshot(userId);
+    if (!data) {
+      dropSearchIndex(userId, entry);
+      return {};
+    }
+    const quint64 fingerprint = SearchIndex::fingerprint(*data);
+    QByteArray bytes;
+    if (!storage_.loadBlob(userId, kSearchIndexSuffix, bytes) ||
+        !entry->index.deserialize(bytes, fingerprint)) {
+      entry->index = buildSearchIndex(*data);
+      storage_.saveBlob(userId, kSearchIndexSuffix,
+                        entry->index.serialize(fingerprint));
+    }
+    entry->ready = true;
+    entry->dirty = false;
+    // 加载期间快照已被逐出时逐出回调可能早于条目创建，这里补上。
+    if (!snapshots_.accountSearchIndex(userId,
+                                       entry->index.estimatedBytes())) {
+      dropSearchIndex(userId, entry);
+    }
+  }
+  return entry->index.search(query, limit);
+}
 
-  bool updated = false;
-  for (auto &post : ownerData.posts) {
-    if (post.id == postId) {
-      post.comments.push_back(comment);
-      updated = true;
-      break;
+// 在各用户执行器上写盘，保证指纹与索引内容对应同一版本的数据；增量
+// 修改后的占用在此时重新记入。
+void LedgerService::flushSearchIndexes() {
+  QList<QString> userIds;
+  {
+    QMutexLocker locker(&searchIndexesMutex_);
+    userIds = searchIndexes_.keys();
+  }
+  for (const auto &userId : userIds) {
+    const auto entry = findSearchIndex(userId);
+    if (!entry) {
+      continue;
     }
+    executors_.run(userId, [&] {
+      QWriteLocker locker(&entry->lock);
+      if (!entry->ready || !entry->dirty) {
+        return;
+      }
+      const auto data = snapshot(userId);
+      if (data &&
+          storage_.saveBlob(userId, kSearchIndexSuffix,
+                            entry->index.serialize(
+                                SearchIndex::fingerprint(*data)))) {
+        entry->dirty = false;
+        snapshots_.accountSearchIndex(userId, entry->index.estimatedBytes());
+      }
+    });
   }
+}
 
-  if (!updated) {
-    errorMessage = "未找到动态";
-    return false;
+// 事务在所有相关执行器的独占区内执行：加载一次、修改、校验、整批原子提交。
+bool LedgerService::transaction(const QStringList &userIds,
+                                const TransactionFn &fn,
+                                QString &errorMessage) {
+  QStringList ids = userIds;
+  ids.removeDuplicates();
+  return serializedAll(ids, [&]() -> bool {
+    QVector<UserData> batch(ids.size());
+    for (int i = 0; i < ids.size(); ++i) {
+      if (!loadUser(ids.at(i), batch[i])) {
+        errorMessage = "读取用户失败";
+        return false;
+      }
+    }
+    // 容器大小在事务期间固定，视图指针保持有效。
+    TransactionViews views;
+    for (int i = 0; i < ids.size(); ++i) {
+      views.insert(ids.at(i), &batch[i]);
+    }
+
+    if (!fn(views, errorMessage)) {
+      return false;
+    }
+    // 事务函数可任意改动容器，提交前统一重建汇总表与 ID 索引。
+    for (auto &data : batch) {
+      if (!validate(data, errorMessage)) {
+        return false;
+      }
+      data.rollups = CalendarRollups::build(data.bills);
+      data.reindex();
+    }
+    if (!saveUsers(batch)) {
+      errorMessage = "无法保存用户数据";
+      return false;
+    }
+    // 事务可能改动任意内容，检索索引在下次查询时按新快照重建。
+    for (const auto &id : ids) {
+      if (const auto entry = findSearchIndex(id)) {
+        QWriteLocker locker(&entry->lock);
+        entry->ready = false;
+        entry->dirty = false;
+      }
+    }
+    return true;
+  });
+}
+
+// 缓存按快照身份失效：写入发布新快照后，下一次查询重新排序。
+std::shared_ptr<const QVector<int>> LedgerService::billTimeOrder(
+    const QString &userId, const UserSnapshot &data) const {
+  {
+    QMutexLocker locker(&timeOrderMutex_);
+    const auto cached = timeOrders_.value(userId);
+    if (cached.order && cached.source.lock() == data) {
+      return cached.order;
+    }
   }
+  std::shared_ptr<const QVector<int>> order =
+      std::make_shared<QVector<int>>(BillQuery::timeOrder(data->bills));
+  QMutexLocker locker(&timeOrderMutex_);
+  timeOrders_.insert(userId, TimeOrderCache{data, order});
+  return order;
+}
 
-  return saveUser(ownerData);
+std::shared_ptr<LedgerService::UserSearchIndex> LedgerService::searchIndexFor(
+    const QString &userId) const {
+  QMutexLocker locker(&searchIndexesMutex_);
+  auto &entry = searchIndexes_[userId];
+  if (!entry) {
+    entry = std::make_shared<UserSearchIndex>();
+  }
+  return entry;
 }
 
-// 读取用户档案的统一入口。
-std::optional<UserProfile> LedgerService::profile(const QString &userId) const {
-  UserData data;
-  if (!loadUser(userId, data)) {
-    return std::nullopt;
+std::shared_ptr<LedgerService::UserSearchIndex>
+LedgerService::findSearchIndex(const QString &userId) const {
+  QMutexLocker locker(&searchIndexesMutex_);
+  return searchIndexes_.value(userId);
+}
+
+// 未落盘的增量修改随之丢弃：账单与动态的变化体现在数据指纹中，评论的
+// 变化已删除持久化的索引（见 indexComment），下次加载时都会全量重建。
+void LedgerService::dropSearchIndex(
+    const QString &userId,
+    const std::shared_ptr<UserSearchIndex> &only) const {
+  QMutexLocker locker(&searchIndexesMutex_);
+  const auto it = searchIndexes_.find(userId);
+  if (it != searchIndexes_.end() && (!only || it.value() == only)) {
+    searchIndexes_.erase(it);
+  }
+}
+
+// 索引尚未加载时跳过：首次查询会基于已包含本次提交的快照构建。
+void LedgerService::updateSearchIndex(
+    const QString &userId,
+    const std::function<void(SearchIndex &)> &update) const {
+  const auto entry = findSearchIndex(userId);
+  if (!entry) {
+    return;
+  }
+  QWriteLocker locker(&entry->lock);
+  if (entry->ready) {
+    update(entry->index);
+    entry->dirty = true;
   }
-  return data.profile;
 }
 
-// 封装存储层读取，方便统一错误处理。
+// 数据指纹不含评论库，评论只能由内存中的索引吸收：索引未加载，或这是它
+// 落盘后的第一处修改时，先删除持久化的索引，使下次加载（包括崩溃后）
+// 全量重建，而不必在每次加载与落盘时逐个读取评论串统计条数。
+void LedgerService::indexComment(const QString &ownerId,
+                                 const EntityId &postId,
+                                 const Comment &comment) const {
+  const auto entry = findSearchIndex(ownerId);
+  if (!entry) {
+    storage_.removeBlob(ownerId, kSearchIndexSuffix);
+    return;
+  }
+  QWriteLocker locker(&entry->lock);
+  if (!entry->ready || !entry->dirty) {
+    storage_.removeBlob(ownerId, kSearchIndexSuffix);
+  }
+  if (entry->ready) {
+    entry->index.upsert(SearchKind::Comment, comment.id.toString(),
+                        postId.toString(), comment.content);
+    entry->dirty = true;
+  }
+}
+
+// 在用户执行器上同步运行修改逻辑，同一用户的修改严格串行。
+bool LedgerService::serialized(const QString &userId,
+                               const std::function<bool()> &mutation) {
+  bool ok = false;
+  executors_.run(userId, [&] { ok = mutation(); });
+  return ok;
+}
+
+// 涉及多个用户的修改需同时独占所有相关执行器。
+bool LedgerService::serializedAll(const QStringList &userIds,
+                                  const std::function<bool()> &mutation) {
+  bool ok = false;
+  executors_.runExclusive(userIds, [&] { ok = mutation(); });
+  return ok;
+}
+
+// 修改路径从当前快照复制一份可变数据（容器隐式共享，写时才深拷贝）。
 bool LedgerService::loadUser(const QString &userId, UserData &data) const {
-  return storage_.loadUser(userId, data);
+  const auto current = snapshot(userId);
+  if (!current) {
+    return false;
+  }
+  data = *current;
+  return true;
 }
 
-// 持久化用户数据的便捷入口。
+// 落盘成功后发布新快照，读者随后即可看到本次提交。
 bool LedgerService::saveUser(const UserData &data) const {
-  return storage_.saveUser(data);
+  if (!storage_.saveUser(data)) {
+    return false;
+  }
+  snapshots_.publish(data.profile.id, std::make_shared<UserData>(data));
+  publishSocial(data);
+  return true;
+}
+
+// 整批写盘成功后再逐个发布快照，失败时读者仍看到事务前的状态。
+bool LedgerService::saveUsers(const QVector<UserData> &batch) const {
+  if (!storage_.saveUsers(batch)) {
+    return false;
+  }
+  for (const auto &data : batch) {
+    snapshots_.publish(data.profile.id, std::make_shared<UserData>(data));
+    publishSocial(data);
+  }
+  return true;
+}
+
+// 账单分类必须存在，分类与账单 ID 不得为空或重复。
+bool LedgerService::validate(const UserData &data, QString &errorMessage) {
+  if (data.profile.id.isEmpty()) {
+    errorMessage = "用户ID不能为空";
+    return false;
+  }
+  QSet<EntityId> categoryIds;
+  for (const auto &category : data.categories) {
+    if (category.id.isEmpty() || categoryIds.contains(category.id)) {
+      errorMessage = "分类ID无效或重复";
+      return false;
+    }
+    categoryIds.insert(category.id);
+  }
+  for (const auto &segment : data.archive) {
+    for (auto it = segment.byCategory.cbegin();
+         it != segment.byCategory.cend(); ++it) {
+      if (!categoryIds.contains(it.key())) {
+        errorMessage = "分类不存在";
+        return false;
+      }
+    }
+  }
+  QSet<EntityId> billIds;
+  for (const auto &bill : data.bills) {
+    if (bill.id.isEmpty() || billIds.contains(bill.id)) {
+      errorMessage = "账单ID无效或重复";
+      return false;
+    }
+    if (!categoryIds.contains(bill.categoryId)) {
+      errorMessage = "分类不存在";
+      return false;
+    }
+    billIds.insert(bill.id);
+  }
+  return true;
+}
+
+SearchIndex LedgerService::buildSearchIndex(const UserData &data) const {
+  SearchIndex index = SearchIndex::build(data);
+  for (const auto &post : data.posts) {
+    const QString postId = post.id.toString();
+    for (const auto &comment : commentStore_.read(post.id, 0, -1)) {
+      index.upsert(SearchKind::Comment, comment.id.toString(), postId,
+                   comment.content);
+    }
+  }
+  return index;
+}
+
+// 段文件不可变：取回账单时写出去掉这些账单的新版本，取空的段直接去掉。
+// 新版本在用户文件提交前不被引用，提交失败时旧版本仍然有效。编辑可能
+// 改了账单的时间，先查 months 中的段，仍未找到的 ID 再查其余各段。
+bool LedgerService::restoreArchivedBills(UserData &data,
+                                         const QSet<EntityId> &ids,
+                                         const QSet<QDate> &months,
+                                         QVector<ArchiveSegment> &stale,
+                                         QString &errorMessage) const {
+  QSet<EntityId> remaining = ids;
+  for (const bool hinted : {true, false}) {
+    if (remaining.isEmpty() || (hinted && months.isEmpty())) {
+      continue;
+    }
+    if (!restoreFromSegments(data, remaining, months, hinted, stale,
+                             errorMessage)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// inMonths 为 true 时只查 months 中的段，否则只查其余的段；取回的 ID
+// 从 remaining 中去掉，全部找到后提前结束。
+bool LedgerService::restoreFromSegments(UserData &data,
+                                        QSet<EntityId> &remaining,
+                                        const QSet<QDate> &months,
+                                        bool inMonths,
+                                        QVector<ArchiveSegment> &stale,
+                                        QString &errorMessage) const {
+  const QString &userId = data.profile.id;
+  for (int i = 0; i < data.archive.size() && !remaining.isEmpty();) {
+    const ArchiveSegment segment = data.archive[i];
+    if (months.contains(segment.month) != inMonths) {
+      ++i;
+      continue;
+    }
+    QVector<Bill> bills;
+    if (!archive_.read(userId, segment, bills)) {
+      errorMessage = "读取归档失败";
+      return false;
+    }
+    QVector<Bill> kept;
+    QVector<Bill> restored;
+    for (const auto &bill : bills) {
+      (remaining.contains(bill.id) ? restored : kept).push_back(bill);
+    }
+    if (restored.isEmpty()) {
+      ++i;
+      continue;
+    }
+    if (kept.isEmpty()) {
+      data.archive.removeAt(i);
+    } else {
+      if (!archive_.write(userId, segment.month, segment.version + 1, kept,
+                          data.archive[i])) {
+        errorMessage = "写入归档失败";
+        return false;
+      }
+      ++i;
+    }
+    stale.push_back(segment);
+    for (const auto &bill : restored) {
+      remaining.remove(bill.id);
+      data.putBill(bill);
+      data.rollups.add(bill);
+    }
+  }
+  return true;
+}
+
+// 提交成功后旧版本的段立即删除，仍持有旧快照的读者可能读不到它：读取
+// 失败且已有更新的快照时换用新快照重读，直到成功或快照不再变化。
+bool LedgerService::readArchived(const QString &userId, UserSnapshot &data,
+                                 const QDate &from, const QDate &to,
+                                 QVector<Bill> &outBills) const {
+  for (;;) {
+    QVector<Bill> bills;
+    if (archive_.readOverlapping(userId, data->archive, from, to, bills)) {
+      outBills = std::move(bills);
+      return true;
+    }
+    auto current = snapshot(userId);
+    if (!current || current == data) {
+      return false;
+    }
+    data = std::move(current);
+  }
+}
+
+void LedgerService::discardSegments(
+    const QString &userId, const QVector<ArchiveSegment> &stale) const {
+  for (const auto &segment : stale) {
+    archive_.discard(userId, segment);
+  }
+}
+
+// 导入是幂等的，并发加载同一用户时只有第一次真正写入；数据文件不在
+// 这里改写，而是在作者下一次保存时自然去掉内嵌的评论。导入失败的动态
+// 保留内嵌评论，下次加载时重试。
+void LedgerService::migrateLegacyComments(UserData &data) const {
+  for (auto &post : data.posts) {
+    if (!post.comments.isEmpty() &&
+        commentStore_.importThread(post.id, post.comments)) {
+      post.comments.clear();
+    }
+  }
+}
+
+// 投影与 UserData 共享动态数组（隐式共享），本身只多占一个好友列表。
+// 读文件得到的投影只在仍无投影时插入：期间若有提交，提交写入的投影更新。
+LedgerService::SocialProjectionPtr LedgerService::socialProjection(
+    const QString &userId) const {
+  {
+    QMutexLocker locker(&socialMutex_);
+    const auto it = social_.constFind(userId);
+    if (it != social_.constEnd()) {
+      return it.value();
+    }
+  }
+  UserData loaded;
+  const UserSnapshot cached = snapshots_.peek(userId);
+  const UserData *data = cached.get();
+  if (!data) {
+    if (!storage_.loadUser(userId, loaded)) {
+      return nullptr;
+    }
+    data = &loaded;
+  }
+  auto projection = std::make_shared<SocialProjection>();
+  projection->friendIds = data->profile.friendIds;
+  projection->posts = data->posts;
+  QMutexLocker locker(&socialMutex_);
+  auto it = social_.find(userId);
+  if (it == social_.end()) {
+    it = social_.insert(userId, std::move(projection));
+  }
+  return it.value();
+}
+
+void LedgerService::publishSocial(const UserData &data) const {
+  auto projection = std::make_shared<SocialProjection>();
+  projection->friendIds = data.profile.friendIds;
+  projection->posts = data.posts;
+  QMutexLocker locker(&socialMutex_);
+  social_.insert(data.profile.id, std::move(projection));
+}
+
+// 其他作者的投影在线程池上并行取得，各自筛出可见动态后合并；只有查看者
+// 本人的快照进入快照缓存。
+QVector<SocialPost> LedgerService::visiblePosts(const QString &userId) const {
+  const auto viewerData = snapshot(userId);
+  if (!viewerData) {
+    return {};
+  }
+
+  QVector<SocialPost> posts = viewerData->posts;
+  posts += mapReduce<QVector<SocialPost>>(
+      storage_.userIds(),
+      [&](const QString &authorId) {
+        QVector<SocialPost> visible;
+        if (authorId == userId) {
+          return visible;
+        }
+        const auto author = socialProjection(authorId);
+        if (!author) {
+          return visible;
+        }
+        const bool isFriend =
+            viewerData->profile.friendIds.contains(authorId) &&
+            author->friendIds.contains(userId);
+        for (const auto &post : author->posts) {
+          if (post.visibility == PostVisibility::Public ||
+              (post.visibility == PostVisibility::Friends && isFriend)) {
+            visible.push_back(post);
+          }
+        }
+        return visible;
+      },
+      [](QVector<SocialPost> &acc, QVector<SocialPost> &&visible) {
+        acc += visible;
+      },
+      [](QVector<SocialPost> &acc, QVector<SocialPost> &&partial) {
+        acc += partial;
+      });
+  return posts;
+}
+
+// 仍内嵌评论的动态（迁移失败的旧数据）直接沿用自身的评论。
+void LedgerService::attachComments(SocialPost &post) const {
+  if (!post.comments.isEmpty()) {
+    post.commentCount = post.comments.size();
+    return;
+  }
+  const auto summary = commentStore_.summary(post.id);
+  post.commentCount = summary.count;
+  post.comments = summary.recent;
 }
 
 // 根据用户名或邮箱查找用户档案。
@@ -6,27 +6,79 @@
 
 #pragma once
 
+#include "BillArchive.h"
+#include "BillQuery.h"
+#include "CommentStore.h"
 #include "Entities.h"
 #include "JsonStorage.h"
+#include "SearchIndex.h"
+#include "SnapshotStore.h"
+#include "UserExecutor.h"
 
+#include <QHash>
+#include <QIODevice>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSet>
+#include <QStringList>
+
+#include <functional>
 #include <optional>
 
 namespace core {
 
 // CategorySummary 用于统计界面展示分类收支汇总。
 struct CategorySummary {
-  QString categoryId;
+  EntityId categoryId;
   QString name;
   double income = 0.0;
   double expense = 0.0;
 };
 
+// ImportReport 汇总一次批量导入的结果与吞吐量。
+struct ImportReport {
+  int rows = 0;        // 输入行数
+  int inserted = 0;    // 新增账单数
+  int updated = 0;     // 按 ID 覆盖已有账单（含批内重复）的次数
+  int rejected = 0;    // 因分类不存在或解析失败而跳过的行数
+  QStringList errors;  // 被拒绝行的原因，最多保留 kMaxImportErrors 条
+  qint64 elapsedMs = 0;
+  double rowsPerSecond = 0.0;
+};
+
+// SystemReport 汇总全部用户的收支。各用户的分类 ID 互不相同，
+// 分类按名称合并，categoryId 为空，按支出降序排列。
+struct SystemReport {
+  int users = 0;
+  int bills = 0;
+  double income = 0.0;
+  double expense = 0.0;
+  QVector<CategorySummary> categories;
+  qint64 elapsedMs = 0;
+};
+
+// 导入报告中保留的错误条数上限，避免坏文件产生超大报告。
+constexpr int kMaxImportErrors = 100;
+
+// 事务中各用户的可变视图，键为用户 ID，指针在事务函数返回前有效。
+using TransactionViews = QHash<QString, UserData *>;
+// 事务函数：修改视图并返回 true 提交，返回 false（可附带错误信息）放弃。
+using TransactionFn =
+    std::function<bool(TransactionViews &users, QString &errorMessage)>;
+
 // LedgerService 处理业务逻辑，协调数据存储与 UI 请求。
+// 线程安全：每个用户的修改在其专属串行执行器上依次执行，不同用户互不阻塞；
+// 查询读取已发布的不可变快照，从不等待进行中的写入。
 class LedgerService {
  public:
-  // 注册新用户，自动生成默认分类。
+  // 默认使用 JsonStorage::defaultDataDir() 作为数据目录。
   LedgerService();
+  // 指定数据目录，供服务端等多用户进程使用。
+  explicit LedgerService(const QDir &dataDir,
+                         const DurabilityOptions &durability = {});
+  ~LedgerService();
 
+  // 注册新用户，自动生成默认分类。
   bool registerUser(const QString &username, const QString &email,
                     const QString &password, QString &outUserId,
                     QString &errorMessage);
@@ -48,46 +100,183 @@ class LedgerService {
   QVector<Category> categories(const QString &userId) const;
   bool upsertCategory(const QString &userId, const Category &category,
                       QString &errorMessage);
-  bool removeCategory(const QString &userId, const QString &categoryId,
+  bool removeCategory(const QString &userId, const EntityId &categoryId,
                       QString &errorMessage);
 
-  // 账单管理接口。
+  // 账单管理接口。bills 只返回未归档的账单；编辑或删除已归档的账单时
+  // 自动从归档中取回。
   QVector<Bill> bills(const QString &userId) const;
+  // 日期落在闭区间 [from, to] 内的全部账单，包括只解压相交月份得到的
+  // 归档账单；无效端点表示不限。归档读取失败时只返回未归档部分。
+  QVector<Bill> bills(const QString &userId, const QDate &from,
+                      const QDate &to) const;
+  // 最早一笔账单（含归档）的日期，归档部分取最早段的月初；没有账单时
+  // 返回无效日期。
+  QDate earliestBillDate(const QString &userId) const;
   bool upsertBill(const QString &userId, const Bill &bill,
                   QString &errorMessage);
-  bool removeBill(const QString &userId, const QString &billId,
+  bool removeBill(const QString &userId, const EntityId &billId,
                   QString &errorMessage);
+  // 批量导入账单：只加载一次、在内存中校验与去重、最后只写盘一次。
+  // 分类不存在的行被拒绝并记入报告，不影响其余行。
+  bool importBills(const QString &userId, const QVector<Bill> &rows,
+                   ImportReport &report, QString &errorMessage);
+  // 流式解析 CSV 并批量导入，格式见 CsvBillImporter。
+  bool importCsv(const QString &userId, QIODevice &device,
+                 ImportReport &report, QString &errorMessage);
 
   // 分类统计与全局收支。
   QVector<CategorySummary> summarizeByCategory(const QString &userId) const;
   double totalIncome(const QString &userId) const;
   double totalExpense(const QString &userId) const;
+  // 全系统报表：在线程池上并行读取所有用户。未缓存的用户直接读文件、
+  // 用完即弃，不进入快照缓存，内存占用与用户数无关。
+  SystemReport systemReport() const;
+  // 每个用户按分区估算的内存占用与磁盘占用，按内存降序。
+  QVector<UserFootprint> footprints() const;
+  // 快照缓存的全局内存计量。
+  MemoryGauge memoryGauge() const;
+  // 快照缓存的内存预算（字节），0 表示不限；超出时逐出最久未访问的用户，
+  // 被逐出的用户在下次访问时从磁盘重新加载。
+  void setMemoryBudget(qint64 bytes);
+  // 日历汇总序列：区间内每个桶一个点（含空桶），categoryId 为空表示全部分类。
+  QVector<RollupPoint> periodSeries(
+      const QString &userId, RollupPeriod period, const QDate &from,
+      const QDate &to, const EntityId &categoryId = EntityId()) const;
+  // 冷归档：把时间早于 before 的账单按月压缩进不可变的归档段，用户文件只
+  // 保留各段摘要，之后的加载不再解析这些账单。汇总与序列仍包含归档部分，
+  // 过滤查询与带区间的 bills 只解压日期区间涉及的段。
+  // archived 返回本次移入归档的账单数。
+  bool archiveBills(const QString &userId, const QDate &before, int &archived,
+                    QString &errorMessage);
+  // 对清单中的全部用户执行 archiveBills，返回归档的账单总数。
+  int archiveColdBills(const QDate &before);
 
   // 提醒管理与筛选。
   QVector<Reminder> reminders(const QString &userId) const;
   bool upsertReminder(const QString &userId, const Reminder &reminder,
                       QString &errorMessage);
-  bool removeReminder(const QString &userId, const QString &reminderId,
+  bool removeReminder(const QString &userId, const EntityId &reminderId,
                       QString &errorMessage);
   QVector<Reminder> upcomingReminders(const QString &userId,
                                       const QDateTime &from,
                                       const QDateTime &to) const;
 
-  // 动态与评论。
+  // 动态与评论。动态只附带评论总数与最近几条评论，完整评论串另行分页读取。
   QVector<SocialPost> timeline(const QString &userId) const;
+  // 时间线分页：跳过前 offset 条，最多返回 limit 条（负数表示不限）；
+  // total 返回可见动态总数。
+  QVector<SocialPost> timelinePage(const QString &userId, int offset,
+                                   int limit, int *total = nullptr) const;
+  // 按时间顺序分页读取一条动态的评论；viewer 看不到该动态时返回空。
+  QVector<Comment> postComments(const QString &viewerId,
+                                const QString &postOwnerId,
+                                const EntityId &postId, int offset = 0,
+                                int limit = -1, int *total = nullptr) const;
+  // visibility 取 "public" 或 "friends"。
   bool publishPost(const QString &userId, const QString &content,
                    const QString &visibility, QString &errorMessage);
   bool addComment(const QString &userId, const QString &postOwnerId,
-                  const QString &postId, const QString &content,
+                  const EntityId &postId, const QString &content,
                   QString &errorMessage);
 
   // 查询单个用户档案。
   std::optional<UserProfile> profile(const QString &userId) const;
 
+  // 多操作事务：独占并一次性加载相关用户，交由 fn 在内存中修改，
+  // 校验通过后每个用户只原子写入一次；fn 失败、校验失败或写盘失败均不留痕迹。
+  bool transaction(const QStringList &userIds, const TransactionFn &fn,
+                   QString &errorMessage);
+
+  // 按过滤表达式查询账单（语法见 BillQuery），可附带分组汇总。
+  bool queryBills(const QString &userId, const QString &expression,
+                  BillQueryResult &result, QString &errorMessage) const;
+
+  // 全文检索账单备注、本人动态及其评论，按相关度降序返回。已归档账单的
+  // 备注不在索引中，需按日期区间用 bills 或 queryBills 查找。
+  QVector<SearchHit> search(const QString &userId, const QString &query,
+                            int limit = 20) const;
+  // 将有增量修改的检索索引写盘；析构时自动调用。
+  void flushSearchIndexes();
+
+  // 获取用户当前的不可变快照，用户不存在时返回空指针。
+  UserSnapshot snapshot(const QString &userId) const;
+
  private:
+  // 在指定用户（或多个用户）的串行执行器上运行修改并返回结果。
+  bool serialized(const QString &userId,
+                  const std::function<bool()> &mutation);
+  bool serializedAll(const QStringList &userIds,
+                     const std::function<bool()> &mutation);
   // 底层读写封装。
   bool loadUser(const QString &userId, UserData &data) const;
   bool saveUser(const UserData &data) const;
+  bool saveUsers(const QVector<UserData> &batch) const;
+  // 提交前的一致性校验：账单与分类引用必须有效。
+  static bool validate(const UserData &data, QString &errorMessage);
+  // 单个用户的检索索引；ready 为 false 时在首次查询时加载或构建。
+  struct UserSearchIndex {
+    QReadWriteLock lock;
+    bool ready = false;
+    bool dirty = false;
+    SearchIndex index;
+  };
+  // 取得或创建索引条目，只在确认用户存在后调用。
+  std::shared_ptr<UserSearchIndex> searchIndexFor(const QString &userId) const;
+  // 不创建条目的查找，没有条目时返回空指针。
+  std::shared_ptr<UserSearchIndex> findSearchIndex(
+      const QString &userId) const;
+  // 快照被逐出时的回调；only 非空时仅当表中仍是该条目才删除。
+  void dropSearchIndex(
+      const QString &userId,
+      const std::shared_ptr<UserSearchIndex> &only = nullptr) const;
+  // 在写锁下对已加载的索引应用增量修改，必须在该用户的执行器内调用。
+  void updateSearchIndex(
+      const QString &userId,
+      const std::function<void(SearchIndex &)> &update) const;
+  // 新评论计入动态作者的索引，必须在作者的执行器内调用。
+  void indexComment(const QString &ownerId, const EntityId &postId,
+                    const Comment &comment) const;
+  // 快照对应的账单时间序下标，每个快照版本只排序一次。
+  std::shared_ptr<const QVector<int>> billTimeOrder(
+      const QString &userId, const UserSnapshot &data) const;
+  // 检索索引的全量构建，包含评论库中的评论。
+  SearchIndex buildSearchIndex(const UserData &data) const;
+  // 把归档中 ID 属于 ids 的账单取回 data（同时计入汇总表）；先查找
+  // months 中的段，未找到的再查其余各段。被改写的段的旧版本追加到
+  // stale，提交成功后删除。
+  bool restoreArchivedBills(UserData &data, const QSet<EntityId> &ids,
+                            const QSet<QDate> &months,
+                            QVector<ArchiveSegment> &stale,
+                            QString &errorMessage) const;
+  bool restoreFromSegments(UserData &data, QSet<EntityId> &remaining,
+                           const QSet<QDate> &months, bool inMonths,
+                           QVector<ArchiveSegment> &stale,
+                           QString &errorMessage) const;
+  // 读取 data 中与区间相交的归档账单；段已被新提交删除时换用当前快照
+  // 重读，data 随之更新。
+  bool readArchived(const QString &userId, UserSnapshot &data,
+                    const QDate &from, const QDate &to,
+                    QVector<Bill> &outBills) const;
+  void discardSegments(const QString &userId,
+                       const QVector<ArchiveSegment> &stale) const;
+  // 旧版数据的评论内嵌在动态中，加载时搬进评论库。
+  void migrateLegacyComments(UserData &data) const;
+  // 未排序的可见动态，不含评论。
+  QVector<SocialPost> visiblePosts(const QString &userId) const;
+  // 时间线所需的作者投影：好友列表与动态，不含账单。与快照缓存分开保存，
+  // 读取他人的动态不会把其完整账本发布进缓存。
+  struct SocialProjection {
+    QStringList friendIds;
+    QVector<SocialPost> posts;
+  };
+  using SocialProjectionPtr = std::shared_ptr<const SocialProjection>;
+  // 未缓存时取已缓存的快照，否则临时读文件，用完即弃。
+  SocialProjectionPtr socialProjection(const QString &userId) const;
+  // 提交后覆盖投影，保证之后的读者看到本次提交。
+  void publishSocial(const UserData &data) const;
+  // 用评论库的摘要填充动态的评论数与最近评论。
+  void attachComments(SocialPost &post) const;
   // 根据用户名或邮箱定位用户。
   std::optional<UserProfile> findUserByHandle(const QString &handle) const;
   // 密码哈希与校验。
@@ -95,6 +284,20 @@ class LedgerService {
   static bool verifyPassword(const QString &password, const QString &hash);
 
   JsonStorage storage_;
+  BillArchive archive_;
+  mutable SnapshotStore snapshots_;
+  mutable CommentStore commentStore_;
+  struct TimeOrderCache {
+    std::weak_ptr<const UserData> source;
+    std::shared_ptr<const QVector<int>> order;
+  };
+  mutable QMutex timeOrderMutex_;
+  mutable QHash<QString, TimeOrderCache> timeOrders_;
+  mutable QMutex socialMutex_;
+  mutable QHash<QString, SocialProjectionPtr> social_;
+  mutable QMutex searchIndexesMutex_;
+  mutable QHash<QString, std::shared_ptr<UserSearchIndex>> searchIndexes_;
+  UserExecutors executors_;
 };
 
 }  // namespace core
@@ -0,0 +1,62 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QFuture>
+#include <QThreadPool>
+#include <QVector>
+#include <QtConcurrent/QtConcurrentRun>
+
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+namespace core {
+
+// 在线程池上并行处理一组条目（通常是用户 ID 或数据文件名）：
+// 每个工作者循环领取下一个条目，map 的结果立即 reduce 进该工作者自己的
+// 累加器，全部完成后在调用线程 merge 各累加器。同一时刻只存在每个工作者
+// 一份中间结果，内存占用与条目数无关。调用线程自身也作为一个工作者，
+// 因此在线程池线程内调用也不会因等待而饿死。
+//
+//   map:    (const Item &) -> Mapped，须线程安全
+//   reduce: (Result &acc, Mapped &&value)
+//   merge:  (Result &acc, Result &&partial)
+template <typename Result, typename Sequence, typename Map, typename Reduce,
+          typename Merge>
+Result mapReduce(const Sequence &items, Map map, Reduce reduce, Merge merge,
+                 QThreadPool *pool = QThreadPool::globalInstance()) {
+  const int count = static_cast<int>(items.size());
+  const int workers =
+      std::max(1, std::min(count, pool ? pool->maxThreadCount() : 1));
+  QVector<Result> partials(workers);
+  std::atomic<int> next{0};
+  auto work = [&](Result &acc) {
+    for (int i = next.fetch_add(1); i < count; i = next.fetch_add(1)) {
+      reduce(acc, map(items.at(i)));
+    }
+  };
+
+  QVector<QFuture<void>> futures;
+  futures.reserve(workers - 1);
+  for (int w = 1; w < workers; ++w) {
+    Result *acc = &partials[w];
+    futures.push_back(QtConcurrent::run(pool, [&work, acc] { work(*acc); }));
+  }
+  work(partials[0]);
+  for (auto &future : futures) {
+    future.waitForFinished();
+  }
+
+  Result result = std::move(partials[0]);
+  for (int w = 1; w < workers; ++w) {
+    merge(result, std::move(partials[w]));
+  }
+  return result;
+}
+
+}  // namespace core
@@ -0,0 +1,465 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QLatin1String>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "EntityId.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+#include "TimestampCodec.h"
+
+namespace core {
+namespace reflect {
+
+// 编译期字段描述：键名与成员指针。
+template <typename Owner, typename T>
+struct Field {
+  using Type = T;
+  const char *name;
+  T Owner::*member;
+};
+
+template <typename Owner, typename T>
+constexpr Field<Owner, T> field(const char *name, T Owner::*member) {
+  return {name, member};
+}
+
+// 每个可反射的结构体特化 Describe，以 static constexpr fields 给出字段元组。
+// 字段必须按键名升序排列：JSON 写出顺序与 QJsonObject 一致，解码时与
+// QJsonObject 的有序遍历做一次归并，不再逐字段按名查找。
+template <typename T>
+struct Describe;
+
+template <typename T, typename = void>
+struct IsReflected : std::false_type {};
+
+template <typename T>
+struct IsReflected<T, std::void_t<decltype(Describe<T>::fields)>>
+    : std::true_type {};
+
+constexpr int compareNames(const char *a, const char *b) {
+  while (*a != '\0' && *a == *b) {
+    ++a;
+    ++b;
+  }
+  return static_cast<unsigned char>(*a) - static_cast<unsigned char>(*b);
+}
+
+template <typename Tuple, std::size_t... I>
+constexpr bool namesAscending(const Tuple &fields,
+                              std::index_sequence<I...>) {
+  return (true && ... &&
+          (compareNames(std::get<I>(fields).name,
+                        std::get<I + 1>(fields).name) < 0));
+}
+
+template <typename T>
+constexpr bool fieldsSorted() {
+  constexpr std::size_t count =
+      std::tuple_size<std::decay_t<decltype(Describe<T>::fields)>>::value;
+  if constexpr (count < 2) {
+    return true;
+  } else {
+    return namesAscending(Describe<T>::fields,
+                          std::make_index_sequence<count - 1>{});
+  }
+}
+
+template <typename T, typename F>
+void forEachField(F &&visit) {
+  static_assert(fieldsSorted<T>(), "reflected fields must be sorted by name");
+  std::apply([&visit](const auto &...fields) { (visit(fields), ...); },
+             Describe<T>::fields);
+}
+
+// 按下标访问单个字段：折叠表达式展开为一串整数比较，不比较键名。
+template <typename T, typename F>
+void visitField(std::size_t index, F &&visit) {
+  std::apply(
+      [index, &visit](const auto &...fields) {
+        std::size_t i = 0;
+        (void)((i++ == index && (visit(fields), true)) || ...);
+      },
+      Describe<T>::fields);
+}
+
+// 与字段表同序的键名表，供流式解码时按游标比较。
+template <typename T>
+const auto &fieldNames() {
+  static_assert(fieldsSorted<T>(), "reflected fields must be sorted by name");
+  static const auto names = std::apply(
+      [](const auto &...fields) {
+        return std::array<QLatin1String, sizeof...(fields)>{
+            QLatin1String(fields.name)...};
+      },
+      Describe<T>::fields);
+  return names;
+}
+
+// 单个字段值的编解码。fromJson 以成员当前值作为类型不符时的回退，
+// 因此解码前设置好的默认值会保留下来。
+template <typename T, typename = void>
+struct Codec;
+
+template <>
+struct Codec<QString> {
+  static QJsonValue toJson(const QString &value) { return value; }
+  static void write(JsonWriter &out, const QString &value) { out.value(value); }
+  static void fromJson(const QJsonValue &json, QString &value) {
+    value = json.toString(value);
+  }
+  static void read(JsonReader &in, QString &value) { in.readString(value); }
+  static void save(QDataStream &out, const QString &value) { out << value; }
+  static void load(QDataStream &in, QString &value) { in >> value; }
+};
+
+template <>
+struct Codec<double> {
+  static QJsonValue toJson(double value) { return value; }
+  static void write(JsonWriter &out, double value) { out.value(value); }
+  static void fromJson(const QJsonValue &json, double &value) {
+    value = json.toDouble(value);
+  }
+  static void read(JsonReader &in, double &value) { in.readDouble(value); }
+  static void save(QDataStream &out, double value) { out << value; }
+  static void load(QDataStream &in, double &value) { in >> value; }
+};
+
+template <>
+struct Codec<bool> {
+  static QJsonValue toJson(bool value) { return value; }
+  static void write(JsonWriter &out, bool value) { out.value(value); }
+  static void fromJson(const QJsonValue &json, bool &value) {
+    value = json.toBool(value);
+  }
+  static void read(JsonReader &in, bool &value) { in.readBool(value); }
+  static void save(QDataStream &out, bool value) { out << value; }
+  static void load(QDataStream &in, bool &value) { in >> value; }
+};
+
+// 二进制中 UUID 形式直接写两个 64 位分量；驻留 ID 的序号只在本进程有效，
+// 改写高位标记后跟原始文本。
+template <>
+struct Codec<EntityId> {
+  static QJsonValue toJson(const EntityId &value) { return value.toString(); }
+  static void write(JsonWriter &out, const EntityId &value) {
+    out.value(value);
+  }
+  static void fromJson(const QJsonValue &json, EntityId &value) {
+    value = json.toString();
+  }
+  static void read(JsonReader &in, EntityId &value) {
+    const char *data = nullptr;
+    int size = 0;
+    QString text;
+    if (in.readRawString(data, size)) {
+      value = EntityId::fromUtf8(data, size);
+    } else {
+      in.readString(text);
+      value = text;
+    }
+  }
+  static void save(QDataStream &out, const EntityId &value) {
+    if (value.isInterned()) {
+      out << value.high() << value.toString();
+    } else {
+      out << value.high() << value.low();
+    }
+  }
+  static void load(QDataStream &in, EntityId &value) {
+    quint64 high = 0;
+    in >> high;
+    if (high == ~quint64(0)) {
+      QString text;
+      in >> text;
+      value = text;
+      return;
+    }
+    quint64 low = 0;
+    in >> low;
+    value = EntityId::fromParts(high, low);
+  }
+};
+
+template <>
+struct Codec<QDateTime> {
+  static QJsonValue toJson(const QDateTime &value) {
+    return TimestampCodec::format(value);
+  }
+  static void write(JsonWriter &out, const QDateTime &value) {
+    out.value(value);
+  }
+  static void fromJson(const QJsonValue &json, QDateTime &value) {
+    value = TimestampCodec::parse(json.toString());
+  }
+  static void read(JsonReader &in, QDateTime &value) {
+    const char *data = nullptr;
+    int size = 0;
+    QString text;
+    if (in.readRawString(data, size)) {
+      value = TimestampCodec::parseUtf8(data, size);
+    } else {
+      in.readString(text);
+      value = TimestampCodec::parse(text);
+    }
+  }
+  static void save(QDataStream &out, const QDateTime &value) { out << value; }
+  static void load(QDataStream &in, QDateTime &value) { in >> value; }
+};
+
+template <>
+struct Codec<QStringList> {
+  static QJsonValue toJson(const QStringList &value) {
+    return QJsonArray::fromStringList(value);
+  }
+  static void write(JsonWriter &out, const QStringList &value) {
+    out.beginArray();
+    for (const auto &item : value) {
+      out.value(item);
+    }
+    out.endArray();
+  }
+  static void fromJson(const QJsonValue &json, QStringList &value) {
+    value.clear();
+    for (const auto &item : json.toArray()) {
+      value.append(item.toString());
+    }
+  }
+  static void read(JsonReader &in, QStringList &value) {
+    value.clear();
+    if (in.peek() != JsonReader::Type::Array) {
+      in.skipValue();
+      return;
+    }
+    in.beginArray();
+    while (in.nextElement()) {
+      QString item;
+      in.readString(item);
+      value.append(item);
+    }
+  }
+  static void save(QDataStream &out, const QStringList &value) {
+    out << value;
+  }
+  static void load(QDataStream &in, QStringList &value) { in >> value; }
+};
+
+template <typename T>
+void toJson(const T &object, QJsonObject &out);
+template <typename T>
+void writeJson(JsonWriter &out, const T &object);
+template <typename T>
+void fromJson(const QJsonObject &json, T &object);
+template <typename T>
+void read(JsonReader &in, T &object);
+template <typename T>
+void save(QDataStream &out, const T &object);
+template <typename T>
+void load(QDataStream &in, T &object);
+
+// 嵌套的可反射结构体。
+template <typename T>
+struct Codec<T, std::enable_if_t<IsReflected<T>::value>> {
+  static QJsonValue toJson(const T &value) {
+    QJsonObject obj;
+    reflect::toJson(value, obj);
+    return obj;
+  }
+  static void write(JsonWriter &out, const T &value) {
+    reflect::writeJson(out, value);
+  }
+  static void fromJson(const QJsonValue &json, T &value) {
+    reflect::fromJson(json.toObject(), value);
+  }
+  static void read(JsonReader &in, T &value) { reflect::read(in, value); }
+  static void save(QDataStream &out, const T &value) {
+    reflect::save(out, value);
+  }
+  static void load(QDataStream &in, T &value) { reflect::load(in, value); }
+};
+
+template <typename T>
+struct Codec<QVector<T>> {
+  static QJsonValue toJson(const QVector<T> &value) {
+    QJsonArray array;
+    for (const auto &item : value) {
+      array.append(Codec<T>::toJson(item));
+    }
+    return array;
+  }
+  static void write(JsonWriter &out, const QVector<T> &value) {
+    out.beginArray();
+    for (const auto &item : value) {
+      Codec<T>::write(out, item);
+    }
+    out.endArray();
+  }
+  static void fromJson(const QJsonValue &json, QVector<T> &value) {
+    const auto array = json.toArray();
+    value.clear();
+    value.reserve(array.size());
+    for (const auto &item : array) {
+      T element;
+      Codec<T>::fromJson(item, element);
+      value.push_back(std::move(element));
+    }
+  }
+  // 非数组与 fromJson 一样得到空容器。
+  static void read(JsonReader &in, QVector<T> &value) {
+    value.clear();
+    if (in.peek() != JsonReader::Type::Array) {
+      in.skipValue();
+      return;
+    }
+    in.beginArray();
+    while (in.nextElement()) {
+      T element;
+      Codec<T>::read(in, element);
+      value.push_back(std::move(element));
+    }
+  }
+  static void save(QDataStream &out, const QVector<T> &value) {
+    out << static_cast<qint32>(value.size());
+    for (const auto &item : value) {
+      Codec<T>::save(out, item);
+    }
+  }
+  // 数量为负或流已出错时停止，避免损坏的数据触发超大分配。
+  static void load(QDataStream &in, QVector<T> &value) {
+    qint32 count = 0;
+    in >> count;
+    value.clear();
+    if (count < 0) {
+      in.setStatus(QDataStream::ReadCorruptData);
+      return;
+    }
+    for (qint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+      T element;
+      Codec<T>::load(in, element);
+      value.push_back(std::move(element));
+    }
+  }
+};
+
+template <typename Member>
+using CodecFor = Codec<std::decay_t<Member>>;
+
+template <typename T>
+void toJson(const T &object, QJsonObject &out) {
+  forEachField<T>([&](const auto &field) {
+    out.insert(QString::fromLatin1(field.name),
+               CodecFor<decltype(object.*field.member)>::toJson(
+                   object.*field.member));
+  });
+}
+
+template <typename T>
+void writeJson(JsonWriter &out, const T &object) {
+  out.beginObject();
+  forEachField<T>([&](const auto &field) {
+    out.key(field.name);
+    CodecFor<decltype(object.*field.member)>::write(out,
+                                                    object.*field.member);
+  });
+  out.endObject();
+}
+
+// QJsonObject 按键名有序遍历，与有序字段表归并一次即可完成匹配；
+// 缺失的字段保持调用方预设的默认值，未知的键被跳过。
+template <typename T>
+void fromJson(const QJsonObject &json, T &object) {
+  auto it = json.constBegin();
+  const auto end = json.constEnd();
+  forEachField<T>([&](const auto &field) {
+    const QLatin1String name(field.name);
+    int order = 1;
+    while (it != end && (order = it.key().compare(name)) < 0) {
+      ++it;
+    }
+    if (it != end && order == 0) {
+      CodecFor<decltype(object.*field.member)>::fromJson(
+          it.value(), object.*field.member);
+      ++it;
+    }
+  });
+}
+
+// JsonStorage 按键名升序写出对象，流式读取与 fromJson 一样和有序字段表
+// 归并：游标只前进，缺失的字段被越过。键小于游标处的字段时只可能是未知
+// 键或乱序的键（如手工编辑过的文件），此时才回头扫描游标之前的字段。
+// 非对象的值与 fromJson 一样被跳过，对象保持调用方预设的默认值。
+template <typename T>
+void read(JsonReader &in, T &object) {
+  if (in.peek() != JsonReader::Type::Object) {
+    in.skipValue();
+    return;
+  }
+  const auto &names = fieldNames<T>();
+  auto readField = [&](std::size_t index) {
+    visitField<T>(index, [&](const auto &field) {
+      CodecFor<decltype(object.*field.member)>::read(in,
+                                                     object.*field.member);
+    });
+  };
+  in.beginObject();
+  std::size_t cursor = 0;
+  QLatin1String key;
+  while (in.nextKey(key)) {
+    while (cursor < names.size() && names[cursor] < key) {
+      ++cursor;
+    }
+    if (cursor < names.size() && names[cursor] == key) {
+      readField(cursor++);
+      continue;
+    }
+    std::size_t index = 0;
+    while (index < cursor && names[index] != key) {
+      ++index;
+    }
+    if (index < cursor) {
+      readField(index);
+    } else {
+      in.skipValue();
+    }
+  }
+}
+
+// 二进制按字段声明顺序紧凑写出，不含键名。
+template <typename T>
+void save(QDataStream &out, const T &object) {
+  forEachField<T>([&](const auto &field) {
+    CodecFor<decltype(object.*field.member)>::save(out, object.*field.member);
+  });
+}
+
+template <typename T>
+void load(QDataStream &in, T &object) {
+  forEachField<T>([&](const auto &field) {
+    if (in.status() == QDataStream::Ok) {
+      CodecFor<decltype(object.*field.member)>::load(in,
+                                                     object.*field.member);
+    }
+  });
+}
+
+}  // namespace reflect
+}  // namespace core
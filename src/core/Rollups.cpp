@@ -0,0 +1,410 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "Rollups.h"
+
+#include "Entities.h"
+#include "JsonReader.h"
+#include "JsonWriter.h"
+
+#include <QJsonArray>
+
+#include <algorithm>
+
+namespace core {
+
+namespace {
+
+constexpr int kRollupVersion = 1;
+
+int periodIndex(RollupPeriod period) { return static_cast<int>(period); }
+
+// QHash 的迭代顺序随进程的哈希种子变化；按键排序后输出，同样的数据每次
+// 都写出相同的字节。
+template <typename Key, typename Value>
+QList<Key> sortedKeys(const QHash<Key, Value> &hash) {
+  QList<Key> keys = hash.keys();
+  std::sort(keys.begin(), keys.end());
+  return keys;
+}
+
+void addTotals(RollupTotals &target, const RollupTotals &delta) {
+  target.income += delta.income;
+  target.expense += delta.expense;
+  target.count += delta.count;
+}
+
+QJsonObject totalsToJson(const EntityId &categoryId,
+                         const RollupTotals &totals) {
+  QJsonObject obj;
+  obj["c"] = categoryId.toString();
+  obj["i"] = totals.income;
+  obj["e"] = totals.expense;
+  obj["n"] = totals.count;
+  return obj;
+}
+
+// 字段顺序与 totalsToJson 经 QJsonObject 排序后的顺序一致；day 为空表示无日期。
+void writeTotals(JsonWriter &out, const EntityId &categoryId,
+                 const RollupTotals &totals, const qint64 *day) {
+  out.beginObject();
+  out.field("c", categoryId);
+  if (day) {
+    out.field("d", static_cast<double>(*day));
+  }
+  out.field("e", totals.expense);
+  out.field("i", totals.income);
+  out.field("n", totals.count);
+  out.endObject();
+}
+
+// writeTotals 输出的流式读取，缺失或类型不符的字段保持为零。
+RollupTotals readTotals(JsonReader &in, EntityId &categoryId) {
+  RollupTotals totals;
+  if (in.peek() != JsonReader::Type::Object) {
+    in.skipValue();
+    return totals;
+  }
+  in.beginObject();
+  QLatin1String key;
+  QString id;
+  double count = 0.0;
+  while (in.nextKey(key)) {
+    if (key == QLatin1String("c")) {
+      in.readString(id);
+    } else if (key == QLatin1String("e")) {
+      in.readDouble(totals.expense);
+    } else if (key == QLatin1String("i")) {
+      in.readDouble(totals.income);
+    } else if (key == QLatin1String("n")) {
+      in.readDouble(count);
+    } else {
+      in.skipValue();
+    }
+  }
+  categoryId = id;
+  totals.count = static_cast<int>(count);
+  return totals;
+}
+
+RollupTotals totalsFromJson(const QJsonObject &obj) {
+  RollupTotals totals;
+  totals.income = obj.value("i").toDouble();
+  totals.expense = obj.value("e").toDouble();
+  totals.count = obj.value("n").toInt();
+  return totals;
+}
+
+}  // namespace
+
+ArchiveSegment ArchiveSegment::summarize(const QDate &month, int version,
+                                         const QVector<Bill> &bills) {
+  ArchiveSegment segment;
+  segment.month = month;
+  segment.version = version;
+  segment.count = bills.size();
+  for (const auto &bill : bills) {
+    auto &totals = segment.byCategory[bill.categoryId];
+    ++totals.count;
+    if (bill.type == BillType::Income) {
+      totals.income += bill.amount;
+    } else {
+      totals.expense += bill.amount;
+    }
+  }
+  return segment;
+}
+
+RollupTotals ArchiveSegment::total() const {
+  RollupTotals total;
+  for (const auto &totals : byCategory) {
+    addTotals(total, totals);
+  }
+  return total;
+}
+
+bool ArchiveSegment::overlaps(const QDate &from, const QDate &to) const {
+  return (!to.isValid() || month <= to) &&
+         (!from.isValid() || month.addMonths(1) > from);
+}
+
+// 字段按名称排序，与其他实体的输出风格一致。
+void ArchiveSegment::writeJson(JsonWriter &out) const {
+  out.beginObject();
+  out.key("categories");
+  out.beginArray();
+  for (const auto &categoryId : sortedKeys(byCategory)) {
+    writeTotals(out, categoryId, byCategory[categoryId], nullptr);
+  }
+  out.endArray();
+  out.field("count", count);
+  out.field("month", month.toString("yyyy-MM"));
+  out.field("version", version);
+  out.endObject();
+}
+
+ArchiveSegment ArchiveSegment::readJson(JsonReader &in) {
+  ArchiveSegment segment;
+  if (in.peek() != JsonReader::Type::Object) {
+    in.skipValue();
+    return segment;
+  }
+  in.beginObject();
+  QLatin1String key;
+  QString month;
+  double count = 0.0;
+  double version = 0.0;
+  while (in.nextKey(key)) {
+    if (key == QLatin1String("categories") &&
+        in.peek() == JsonReader::Type::Array) {
+      in.beginArray();
+      while (in.nextElement()) {
+        EntityId categoryId;
+        const RollupTotals totals = readTotals(in, categoryId);
+        segment.byCategory.insert(categoryId, totals);
+      }
+    } else if (key == QLatin1String("count")) {
+      in.readDouble(count);
+    } else if (key == QLatin1String("month")) {
+      in.readString(month);
+    } else if (key == QLatin1String("version")) {
+      in.readDouble(version);
+    } else {
+      in.skipValue();
+    }
+  }
+  segment.month = QDate::fromString(month, "yyyy-MM");
+  segment.count = static_cast<int>(count);
+  segment.version = static_cast<int>(version);
+  return segment;
+}
+
+CalendarRollups CalendarRollups::build(const QVector<Bill> &bills) {
+  CalendarRollups rollups;
+  for (const auto &bill : bills) {
+    rollups.add(bill);
+  }
+  return rollups;
+}
+
+void CalendarRollups::add(const Bill &bill) { apply(bill, 1); }
+
+void CalendarRollups::remove(const Bill &bill) { apply(bill, -1); }
+
+// 逐桶遍历区间，代价与桶数成正比。
+QVector<RollupPoint> CalendarRollups::series(RollupPeriod period,
+                                             const QDate &from,
+                                             const QDate &to,
+                                             const EntityId &categoryId) const {
+  QVector<RollupPoint> points;
+  if (!from.isValid() || !to.isValid() || from > to) {
+    return points;
+  }
+  const auto &buckets = buckets_[periodIndex(period)];
+  for (QDate start = bucketStart(period, from); start <= to;
+       start = nextBucket(period, start)) {
+    RollupPoint point;
+    point.start = start;
+    const auto it = buckets.constFind(start.toJulianDay());
+    if (it != buckets.constEnd()) {
+      point.totals = categoryId.isEmpty()
+                         ? it->all
+                         : it->byCategory.value(categoryId);
+    }
+    points.push_back(point);
+  }
+  return points;
+}
+
+// 年桶数量很少，合并年桶与无日期桶即可得到全量分类合计。
+QHash<EntityId, RollupTotals> CalendarRollups::totalsByCategory() const {
+  QHash<EntityId, RollupTotals> totals = undated_.byCategory;
+  const auto &years = buckets_[periodIndex(RollupPeriod::Year)];
+  for (const auto &bucket : years) {
+    for (auto it = bucket.byCategory.constBegin();
+         it != bucket.byCategory.constEnd(); ++it) {
+      addTotals(totals[it.key()], it.value());
+    }
+  }
+  return totals;
+}
+
+RollupTotals CalendarRollups::grandTotal() const {
+  RollupTotals total = undated_.all;
+  for (const auto &bucket : buckets_[periodIndex(RollupPeriod::Year)]) {
+    addTotals(total, bucket.all);
+  }
+  return total;
+}
+
+// QHash 每个节点带 next 指针与缓存的哈希值，桶数组每项一个指针。
+qint64 CalendarRollups::estimatedBytes() const {
+  constexpr qint64 kNodeOverhead = sizeof(void *) + sizeof(uint);
+  constexpr qint64 kCategoryNode =
+      kNodeOverhead + sizeof(EntityId) + sizeof(RollupTotals);
+  qint64 bytes = undated_.byCategory.size() * kCategoryNode;
+  for (const auto &period : buckets_) {
+    bytes += period.capacity() * sizeof(void *) +
+             period.size() * (kNodeOverhead + sizeof(qint64) + sizeof(Bucket));
+    for (const auto &bucket : period) {
+      bytes += bucket.byCategory.capacity() * sizeof(void *) +
+               bucket.byCategory.size() * kCategoryNode;
+    }
+  }
+  return bytes;
+}
+
+QJsonObject CalendarRollups::toJson() const {
+  QJsonArray days;
+  const auto &dayBuckets = buckets_[periodIndex(RollupPeriod::Day)];
+  for (const qint64 day : sortedKeys(dayBuckets)) {
+    const auto &byCategory = dayBuckets.constFind(day)->byCategory;
+    for (const auto &categoryId : sortedKeys(byCategory)) {
+      auto entry = totalsToJson(categoryId, byCategory[categoryId]);
+      entry["d"] = day;
+      days.append(entry);
+    }
+  }
+  QJsonArray undated;
+  for (const auto &categoryId : sortedKeys(undated_.byCategory)) {
+    undated.append(totalsToJson(categoryId, undated_.byCategory[categoryId]));
+  }
+
+  QJsonObject obj;
+  obj["version"] = kRollupVersion;
+  obj["billCount"] = billCount_;
+  obj["days"] = days;
+  obj["undated"] = undated;
+  return obj;
+}
+
+void CalendarRollups::writeJson(JsonWriter &out) const {
+  out.beginObject();
+  out.field("billCount", billCount_);
+  out.key("days");
+  out.beginArray();
+  const auto &dayBuckets = buckets_[periodIndex(RollupPeriod::Day)];
+  for (const qint64 day : sortedKeys(dayBuckets)) {
+    const auto &byCategory = dayBuckets.constFind(day)->byCategory;
+    for (const auto &categoryId : sortedKeys(byCategory)) {
+      writeTotals(out, categoryId, byCategory[categoryId], &day);
+    }
+  }
+  out.endArray();
+  out.key("undated");
+  out.beginArray();
+  for (const auto &categoryId : sortedKeys(undated_.byCategory)) {
+    writeTotals(out, categoryId, undated_.byCategory[categoryId], nullptr);
+  }
+  out.endArray();
+  out.field("version", kRollupVersion);
+  out.endObject();
+}
+
+// 版本不符或字段缺失时返回 false，由调用方从账单重建。
+bool CalendarRollups::fromJson(const QJsonObject &obj, CalendarRollups &out) {
+  if (obj.value("version").toInt() != kRollupVersion) {
+    return false;
+  }
+  CalendarRollups rollups;
+  rollups.billCount_ = obj.value("billCount").toInt();
+  for (const auto &value : obj.value("days").toArray()) {
+    const auto entry = value.toObject();
+    const QDate day = QDate::fromJulianDay(
+        static_cast<qint64>(entry.value("d").toDouble()));
+    if (!day.isValid()) {
+      return false;
+    }
+    const EntityId categoryId = entry.value("c").toString();
+    const RollupTotals totals = totalsFromJson(entry);
+    for (int p = 0; p < kPeriodCount; ++p) {
+      const auto period = static_cast<RollupPeriod>(p);
+      accumulate(rollups.buckets_[p][bucketStart(period, day).toJulianDay()],
+                 categoryId, totals);
+    }
+  }
+  for (const auto &value : obj.value("undated").toArray()) {
+    const auto entry = value.toObject();
+    accumulate(rollups.undated_, EntityId(entry.value("c").toString()),
+               totalsFromJson(entry));
+  }
+  out = rollups;
+  return true;
+}
+
+QDate CalendarRollups::bucketStart(RollupPeriod period, const QDate &date) {
+  switch (period) {
+    case RollupPeriod::Day:
+      return date;
+    case RollupPeriod::Week:
+      return date.addDays(1 - date.dayOfWeek());
+    case RollupPeriod::Month:
+      return QDate(date.year(), date.month(), 1);
+    case RollupPeriod::Year:
+      return QDate(date.year(), 1, 1);
+  }
+  return date;
+}
+
+QDate CalendarRollups::nextBucket(RollupPeriod period, const QDate &start) {
+  switch (period) {
+    case RollupPeriod::Day:
+      return start.addDays(1);
+    case RollupPeriod::Week:
+      return start.addDays(7);
+    case RollupPeriod::Month:
+      return start.addMonths(1);
+    case RollupPeriod::Year:
+      return start.addYears(1);
+  }
+  return start.addDays(1);
+}
+
+// 账单按本地日期落入各粒度的桶；计数归零的桶与分类项被移除，避免残差累积。
+void CalendarRollups::apply(const Bill &bill, int sign) {
+  RollupTotals delta;
+  delta.count = sign;
+  if (bill.type == BillType::Income) {
+    delta.income = sign * bill.amount;
+  } else {
+    delta.expense = sign * bill.amount;
+  }
+  billCount_ += sign;
+
+  const QDate date = bill.timestamp.isValid() ? bill.timestamp.date() : QDate();
+  if (!date.isValid()) {
+    accumulate(undated_, bill.categoryId, delta);
+    return;
+  }
+  for (int p = 0; p < kPeriodCount; ++p) {
+    auto &buckets = buckets_[p];
+    const qint64 key =
+        bucketStart(static_cast<RollupPeriod>(p), date).toJulianDay();
+    auto it = buckets.find(key);
+    if (it == buckets.end()) {
+      it = buckets.insert(key, Bucket());
+    }
+    accumulate(it.value(), bill.categoryId, delta);
+    if (it->all.count <= 0) {
+      buckets.erase(it);
+    }
+  }
+}
+
+void CalendarRollups::accumulate(Bucket &bucket, const EntityId &categoryId,
+                                 const RollupTotals &delta) {
+  addTotals(bucket.all, delta);
+  auto &category = bucket.byCategory[categoryId];
+  addTotals(category, delta);
+  if (category.count <= 0) {
+    bucket.byCategory.remove(categoryId);
+  }
+  if (bucket.all.count <= 0) {
+    bucket.all = RollupTotals();
+  }
+}
+
+}  // namespace core
@@ -0,0 +1,107 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QDate>
+#include <QHash>
+#include <QJsonObject>
+#include <QString>
+#include <QVector>
+
+#include "EntityId.h"
+
+namespace core {
+
+struct Bill;
+class JsonReader;
+class JsonWriter;
+
+// 汇总粒度：日、周（以周一为起点）、月、年。
+enum class RollupPeriod { Day, Week, Month, Year };
+
+// 单个桶内的收支合计。
+struct RollupTotals {
+  double income = 0.0;
+  double expense = 0.0;
+  int count = 0;
+};
+
+// 时间序列中的一个点，start 为桶的起始日期。
+struct RollupPoint {
+  QDate start;
+  RollupTotals totals;
+};
+
+// 冷账单归档段的摘要：一个自然月内已归档账单的数量与按分类的收支合计。
+// 摘要随用户文件保存，账单本身压缩在独立的段文件中（见 BillArchive）。
+struct ArchiveSegment {
+  QDate month;      // 所在月的 1 日
+  int version = 0;  // 段文件每次重写时递增，旧版本在提交后删除
+  int count = 0;
+  QHash<EntityId, RollupTotals> byCategory;
+
+  // 由段内账单计算摘要。
+  static ArchiveSegment summarize(const QDate &month, int version,
+                                  const QVector<Bill> &bills);
+  RollupTotals total() const;
+  // 该月是否与闭区间 [from, to] 相交，无效端点表示不限。
+  bool overlaps(const QDate &from, const QDate &to) const;
+  void writeJson(JsonWriter &out) const;
+  static ArchiveSegment readJson(JsonReader &in);
+};
+
+// CalendarRollups 按日/周/月/年预聚合账单，并在每个桶内再按分类拆分。
+// 账单增删时增量维护，图表查询的代价只与桶数相关，与账单数无关。
+class CalendarRollups {
+ public:
+  // 从完整账单列表重建。
+  static CalendarRollups build(const QVector<Bill> &bills);
+
+  // 增量维护：新增或删除一笔账单的贡献。
+  void add(const Bill &bill);
+  void remove(const Bill &bill);
+
+  int billCount() const { return billCount_; }
+
+  // 区间 [from, to] 内逐桶的合计（包含空桶）；categoryId 为空表示全部分类。
+  QVector<RollupPoint> series(RollupPeriod period, const QDate &from,
+                              const QDate &to,
+                              const EntityId &categoryId = EntityId()) const;
+  // 全部账单按分类的合计（包括没有有效时间的账单）。
+  QHash<EntityId, RollupTotals> totalsByCategory() const;
+  RollupTotals grandTotal() const;
+  // 各粒度桶及其分类拆分的估算内存占用（字节）。
+  qint64 estimatedBytes() const;
+
+  // 只持久化日桶，周/月/年桶在加载时由日桶推导。
+  QJsonObject toJson() const;
+  void writeJson(JsonWriter &out) const;
+  static bool fromJson(const QJsonObject &obj, CalendarRollups &out);
+
+  // 日期所在桶的起始日期。
+  static QDate bucketStart(RollupPeriod period, const QDate &date);
+  // 下一个桶的起始日期。
+  static QDate nextBucket(RollupPeriod period, const QDate &start);
+
+ private:
+  struct Bucket {
+    RollupTotals all;
+    QHash<EntityId, RollupTotals> byCategory;
+  };
+  static constexpr int kPeriodCount = 4;
+
+  void apply(const Bill &bill, int sign);
+  static void accumulate(Bucket &bucket, const EntityId &categoryId,
+                         const RollupTotals &delta);
+
+  // 各粒度的桶，键为桶起始日期的儒略日。
+  QHash<qint64, Bucket> buckets_[kPeriodCount];
+  Bucket undated_;
+  int billCount_ = 0;
+};
+
+}  // namespace core
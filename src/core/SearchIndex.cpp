@@ -0,0 +1,418 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "SearchIndex.h"
+
+#include <QDataStream>
+#include <QIODevice>
+
+#include <algorithm>
+#include <cmath>
+
+namespace core {
+
+namespace {
+
+constexpr quint32 kIndexMagic = 0x424b5358;  // "BKSX"
+constexpr qint32 kIndexVersion = 1;
+constexpr double kBm25K1 = 1.2;
+constexpr double kBm25B = 0.75;
+// 墓碑超过该数量且多于存活文档时触发压缩。
+constexpr int kCompactThreshold = 1024;
+
+// 中日韩统一表意文字、假名与谚文按字切分。
+bool isCjk(uint ucs4) {
+  return (ucs4 >= 0x3400 && ucs4 <= 0x4DBF) ||
+         (ucs4 >= 0x4E00 && ucs4 <= 0x9FFF) ||
+         (ucs4 >= 0xF900 && ucs4 <= 0xFAFF) ||
+         (ucs4 >= 0x3040 && ucs4 <= 0x30FF) ||
+         (ucs4 >= 0xAC00 && ucs4 <= 0xD7AF) ||
+         (ucs4 >= 0x20000 && ucs4 <= 0x2FA1F);
+}
+
+// 把一段连续的中日韩字符切成二元组，单字片段保留为一元词项。
+void emitCjkRun(const QVector<uint> &run, QStringList &tokens) {
+  if (run.size() == 1) {
+    tokens << QString::fromUcs4(run.constData(), 1);
+    return;
+  }
+  for (int i = 0; i + 1 < run.size(); ++i) {
+    tokens << QString::fromUcs4(run.constData() + i, 2);
+  }
+}
+
+quint64 mixEntry(QChar kind, const QString &id, const QString &text) {
+  const quint64 high = qHash(QString(kind) + id, 0x9e3779b9U);
+  const quint64 low = qHash(text, 0x85ebca6bU);
+  return (high << 32) | low;
+}
+
+}  // namespace
+
+// 逐个码点扫描：字母数字累积成词，中日韩字符累积成片段，其余字符作为分隔。
+QStringList SearchIndex::tokenize(const QString &text) {
+  QStringList tokens;
+  QString word;
+  QVector<uint> cjkRun;
+  auto flushWord = [&] {
+    if (!word.isEmpty()) {
+      tokens << word;
+      word.clear();
+    }
+  };
+  auto flushRun = [&] {
+    if (!cjkRun.isEmpty()) {
+      emitCjkRun(cjkRun, tokens);
+      cjkRun.clear();
+    }
+  };
+
+  const QVector<uint> codepoints = text.toCaseFolded().toUcs4();
+  for (const uint ucs4 : codepoints) {
+    if (isCjk(ucs4)) {
+      flushWord();
+      cjkRun.push_back(ucs4);
+    } else if (QChar::isLetterOrNumber(ucs4)) {
+      flushRun();
+      word += QString::fromUcs4(&ucs4, 1);
+    } else {
+      flushWord();
+      flushRun();
+    }
+  }
+  flushWord();
+  flushRun();
+  return tokens;
+}
+
+SearchIndex SearchIndex::build(const UserData &data) {
+  SearchIndex index;
+  for (const auto &bill : data.bills) {
+    index.upsert(SearchKind::Bill, bill.id.toString(), QString(), bill.note);
+  }
+  for (const auto &post : data.posts) {
+    const QString postId = post.id.toString();
+    index.upsert(SearchKind::Post, postId, QString(), post.content);
+    for (const auto &comment : post.comments) {
+      index.upsert(SearchKind::Comment, comment.id.toString(), postId,
+                   comment.content);
+    }
+  }
+  return index;
+}
+
+// 各条目的哈希求和，与顺序无关；只需哈希文本，远比重新切词便宜。
+quint64 SearchIndex::fingerprint(const UserData &data) {
+  quint64 value = static_cast<quint64>(data.bills.size());
+  for (const auto &bill : data.bills) {
+    value += mixEntry(QLatin1Char('b'), bill.id.toString(), bill.note);
+  }
+  for (const auto &post : data.posts) {
+    value += mixEntry(QLatin1Char('p'), post.id.toString(), post.content);
+    for (const auto &comment : post.comments) {
+      value += mixEntry(QLatin1Char('c'), comment.id.toString(),
+                        comment.content);
+    }
+  }
+  return value;
+}
+
+// 替换时先给旧文档打墓碑，新文档追加到末尾以保持倒排表有序。
+void SearchIndex::upsert(SearchKind kind, const QString &id,
+                         const QString &parentId, const QString &text) {
+  remove(kind, id);
+  const QStringList tokens = tokenize(text);
+  if (tokens.isEmpty()) {
+    return;
+  }
+  QHash<int, int> frequencies;
+  for (const auto &token : tokens) {
+    ++frequencies[termId(token)];
+  }
+
+  Document document;
+  document.kind = kind;
+  document.id = id;
+  document.parentId = parentId;
+  document.length = tokens.size();
+  document.terms.reserve(frequencies.size());
+  for (auto it = frequencies.constBegin(); it != frequencies.constEnd(); ++it) {
+    document.terms.push_back({it.key(), it.value()});
+  }
+  addDocument(std::move(document));
+}
+
+void SearchIndex::remove(SearchKind kind, const QString &id) {
+  const auto it = documentByKey_.find(documentKey(kind, id));
+  if (it == documentByKey_.end()) {
+    return;
+  }
+  auto &document = documents_[it.value()];
+  document.alive = false;
+  for (const auto &term : document.terms) {
+    --documentFrequency_[term.first];
+  }
+  totalLength_ -= document.length;
+  --aliveCount_;
+  documentByKey_.erase(it);
+
+  const int dead = documents_.size() - aliveCount_;
+  if (dead > kCompactThreshold && dead > aliveCount_) {
+    compact();
+  }
+}
+
+// 以最短的倒排表为候选集，其余词项用二分查找求交，再按 BM25 打分。
+QVector<SearchHit> SearchIndex::search(const QString &query, int limit) const {
+  QVector<SearchHit> hits;
+  if (limit <= 0 || aliveCount_ == 0) {
+    return hits;
+  }
+  QVector<int> queryTerms;
+  for (const auto &token : tokenize(query)) {
+    const auto it = termIds_.constFind(token);
+    if (it == termIds_.constEnd()) {
+      return hits;
+    }
+    if (!queryTerms.contains(it.value())) {
+      queryTerms.push_back(it.value());
+    }
+  }
+  if (queryTerms.isEmpty()) {
+    return hits;
+  }
+  std::sort(queryTerms.begin(), queryTerms.end(), [this](int a, int b) {
+    return postings_[a].size() < postings_[b].size();
+  });
+
+  const double averageLength =
+      static_cast<double>(totalLength_) / std::max(1, aliveCount_);
+  auto termScore = [&](int tf, int df, int length) {
+    const double idf =
+        std::log(1.0 + (aliveCount_ - df + 0.5) / (df + 0.5));
+    const double norm =
+        kBm25K1 * (1.0 - kBm25B + kBm25B * length / averageLength);
+    return idf * tf * (kBm25K1 + 1.0) / (tf + norm);
+  };
+
+  struct Candidate {
+    int doc;
+    double score;
+  };
+  QVector<Candidate> candidates;
+  const auto &shortest = postings_[queryTerms.first()];
+  for (const auto &posting : shortest) {
+    const auto &document = documents_[posting.doc];
+    if (document.alive) {
+      candidates.push_back(
+          {posting.doc,
+           termScore(posting.tf, documentFrequency_[queryTerms.first()],
+                     document.length)});
+    }
+  }
+  for (int t = 1; t < queryTerms.size() && !candidates.isEmpty(); ++t) {
+    const auto &list = postings_[queryTerms[t]];
+    const int df = documentFrequency_[queryTerms[t]];
+    QVector<Candidate> next;
+    auto from = list.constBegin();
+    for (const auto &candidate : candidates) {
+      from = std::lower_bound(
+          from, list.constEnd(), candidate.doc,
+          [](const Posting &posting, int doc) { return posting.doc < doc; });
+      if (from == list.constEnd()) {
+        break;
+      }
+      if (from->doc == candidate.doc) {
+        next.push_back({candidate.doc,
+                        candidate.score +
+                            termScore(from->tf, df,
+                                      documents_[candidate.doc].length)});
+      }
+    }
+    candidates.swap(next);
+  }
+
+  // 同分时较新的文档（编号更大）排在前面。
+  const int count = std::min(limit, candidates.size());
+  std::partial_sort(candidates.begin(), candidates.begin() + count,
+                    candidates.end(),
+                    [](const Candidate &a, const Candidate &b) {
+                      return a.score != b.score ? a.score > b.score
+                                                : a.doc > b.doc;
+                    });
+  hits.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    const auto &document = documents_[candidates[i].doc];
+    hits.push_back(
+        {document.kind, document.id, document.parentId, candidates[i].score});
+  }
+  return hits;
+}
+
+// 只写入存活文档与词表，倒排表在加载时由文档词项重建。
+QByteArray SearchIndex::serialize(quint64 fingerprint) const {
+  QByteArray bytes;
+  QDataStream out(&bytes, QIODevice::WriteOnly);
+  out.setVersion(QDataStream::Qt_5_12);
+  out << kIndexMagic << kIndexVersion << fingerprint;
+  out << static_cast<qint32>(terms_.size());
+  for (const auto &term : terms_) {
+    out << term;
+  }
+  out << static_cast<qint32>(aliveCount_);
+  for (const auto &document : documents_) {
+    if (!document.alive) {
+      continue;
+    }
+    out << static_cast<quint8>(document.kind) << document.id
+        << document.parentId << static_cast<qint32>(document.length)
+        << static_cast<qint32>(document.terms.size());
+    for (const auto &term : document.terms) {
+      out << static_cast<qint32>(term.first)
+          << static_cast<qint32>(term.second);
+    }
+  }
+  return qCompress(bytes);
+}
+
+bool SearchIndex::deserialize(const QByteArray &bytes,
+                              quint64 expectedFingerprint) {
+  const QByteArray raw = qUncompress(bytes);
+  QDataStream in(raw);
+  in.setVersion(QDataStream::Qt_5_12);
+  quint32 magic = 0;
+  qint32 version = 0;
+  quint64 fingerprint = 0;
+  in >> magic >> version >> fingerprint;
+  if (magic != kIndexMagic || version != kIndexVersion ||
+      fingerprint != expectedFingerprint) {
+    return false;
+  }
+
+  SearchIndex index;
+  qint32 termCount = 0;
+  in >> termCount;
+  if (termCount < 0) {
+    return false;
+  }
+  for (qint32 i = 0; i < termCount && in.status() == QDataStream::Ok; ++i) {
+    QString term;
+    in >> term;
+    index.termId(term);
+  }
+  qint32 documentCount = 0;
+  in >> documentCount;
+  for (qint32 i = 0; i < documentCount && in.status() == QDataStream::Ok;
+       ++i) {
+    Document document;
+    quint8 kind = 0;
+    qint32 length = 0;
+    qint32 termsInDocument = 0;
+    in >> kind >> document.id >> document.parentId >> length >>
+        termsInDocument;
+    if (kind > static_cast<quint8>(SearchKind::Comment) ||
+        termsInDocument < 0) {
+      return false;
+    }
+    document.kind = static_cast<SearchKind>(kind);
+    document.length = length;
+    document.terms.reserve(termsInDocument);
+    for (qint32 t = 0; t < termsInDocument; ++t) {
+      qint32 term = 0;
+      qint32 tf = 0;
+      in >> term >> tf;
+      if (term < 0 || term >= index.terms_.size()) {
+        return false;
+      }
+      document.terms.push_back({term, tf});
+    }
+    index.addDocument(std::move(document));
+  }
+  if (in.status() != QDataStream::Ok) {
+    return false;
+  }
+  *this = std::move(index);
+  return true;
+}
+
+// 词表字符串与 termIds_ 的键隐式共享，只计一次；QHash 节点带 next 指针
+// 与缓存的哈希值。
+qint64 SearchIndex::estimatedBytes() const {
+  constexpr qint64 kHashNode =
+      sizeof(void *) + sizeof(uint) + sizeof(QString) + sizeof(int);
+  qint64 bytes = (termIds_.size() + documentByKey_.size()) * kHashNode +
+                 terms_.capacity() * sizeof(QString) +
+                 postings_.capacity() * sizeof(QVector<Posting>) +
+                 documentFrequency_.capacity() * sizeof(int) +
+                 documents_.capacity() * sizeof(Document);
+  for (const auto &term : terms_) {
+    bytes += (term.capacity() + 1) * sizeof(QChar);
+  }
+  for (const auto &list : postings_) {
+    bytes += list.capacity() * sizeof(Posting);
+  }
+  for (const auto &document : documents_) {
+    // 文档 ID 同时出现在 documentByKey_ 的键中。
+    bytes += document.terms.capacity() * sizeof(QPair<int, int>) +
+             (2 * document.id.size() + document.parentId.size() + 4) *
+                 sizeof(QChar);
+  }
+  return bytes;
+}
+
+QString SearchIndex::documentKey(SearchKind kind, const QString &id) {
+  return QString::number(static_cast<int>(kind)) + QLatin1Char(':') + id;
+}
+
+int SearchIndex::termId(const QString &term) {
+  const auto it = termIds_.constFind(term);
+  if (it != termIds_.constEnd()) {
+    return it.value();
+  }
+  const int id = terms_.size();
+  termIds_.insert(term, id);
+  terms_.push_back(term);
+  postings_.push_back({});
+  documentFrequency_.push_back(0);
+  return id;
+}
+
+void SearchIndex::addDocument(Document document) {
+  const int doc = documents_.size();
+  for (const auto &term : document.terms) {
+    postings_[term.first].push_back({doc, term.second});
+    ++documentFrequency_[term.first];
+  }
+  document.alive = true;
+  totalLength_ += document.length;
+  ++aliveCount_;
+  documentByKey_.insert(documentKey(document.kind, document.id), doc);
+  documents_.push_back(std::move(document));
+}
+
+// 丢弃墓碑并重新编号；词表保持不变，倒排表随文档顺序重建。
+void SearchIndex::compact() {
+  QVector<Document> alive;
+  alive.reserve(aliveCount_);
+  for (auto &document : documents_) {
+    if (document.alive) {
+      alive.push_back(std::move(document));
+    }
+  }
+  documents_.clear();
+  documentByKey_.clear();
+  for (auto &list : postings_) {
+    list.clear();
+  }
+  documentFrequency_.fill(0);
+  aliveCount_ = 0;
+  totalLength_ = 0;
+  for (auto &document : alive) {
+    addDocument(std::move(document));
+  }
+}
+
+}  // namespace core
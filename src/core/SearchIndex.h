@@ -0,0 +1,93 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include "Entities.h"
+
+#include <QByteArray>
+#include <QHash>
+#include <QPair>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace core {
+
+// 可被检索的文档类型。
+enum class SearchKind { Bill, Post, Comment };
+
+// 一条检索结果；评论的 parentId 为所属动态 ID。
+struct SearchHit {
+  SearchKind kind = SearchKind::Bill;
+  QString id;
+  QString parentId;
+  double score = 0.0;
+};
+
+// SearchIndex 是单个用户的倒排索引，覆盖账单备注、动态与评论正文。
+// 中日韩文字按相邻二字切分（单字独立成词），拉丁字母与数字按整词切分。
+// 查询要求命中全部词项，并按 BM25 排序。删除采用墓碑标记，
+// 失效文档过多时再整体压缩。本类不加锁，由调用方负责同步。
+class SearchIndex {
+ public:
+  // 将文本切分为小写词项，重复词项保留以便计算词频。
+  static QStringList tokenize(const QString &text);
+
+  // 从用户数据全量构建。
+  static SearchIndex build(const UserData &data);
+  // 用户可检索内容的指纹，用于判断持久化索引是否过期。
+  static quint64 fingerprint(const UserData &data);
+
+  // 新增或替换一篇文档；文本为空时等同于删除。
+  void upsert(SearchKind kind, const QString &id, const QString &parentId,
+              const QString &text);
+  void remove(SearchKind kind, const QString &id);
+
+  // 返回得分最高的至多 limit 条结果。
+  QVector<SearchHit> search(const QString &query, int limit) const;
+
+  int documentCount() const { return aliveCount_; }
+  // 按容器容量估算的内存占用（字节），含墓碑。
+  qint64 estimatedBytes() const;
+
+  // 紧凑的二进制格式（QDataStream + qCompress），附带数据指纹。
+  QByteArray serialize(quint64 fingerprint) const;
+  // 格式或指纹不匹配时返回 false。
+  bool deserialize(const QByteArray &bytes, quint64 expectedFingerprint);
+
+ private:
+  struct Document {
+    SearchKind kind = SearchKind::Bill;
+    QString id;
+    QString parentId;
+    int length = 0;
+    QVector<QPair<int, int>> terms;  // (词项编号, 词频)
+    bool alive = false;
+  };
+  struct Posting {
+    int doc = 0;
+    int tf = 0;
+  };
+
+  static QString documentKey(SearchKind kind, const QString &id);
+  int termId(const QString &term);
+  void addDocument(Document document);
+  void compact();
+
+  QHash<QString, int> termIds_;
+  QVector<QString> terms_;
+  // 倒排表按文档编号升序，便于求交；其中可能含有墓碑。
+  QVector<QVector<Posting>> postings_;
+  // 每个词项的存活文档数，BM25 的 df 取此值而非倒排表长度。
+  QVector<int> documentFrequency_;
+  QVector<Document> documents_;
+  QHash<QString, int> documentByKey_;
+  int aliveCount_ = 0;
+  qint64 totalLength_ = 0;
+};
+
+}  // namespace core
@@ -0,0 +1,261 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "SnapshotStore.h"
+
+#include <QMutexLocker>
+#include <QStringList>
+
+#include <algorithm>
+#include <chrono>
+
+namespace core {
+
+namespace {
+
+// 访问时刻的记录粒度：同一粒度内的重复访问不再写槽位，避免热点用户的
+// 槽位在多个读线程之间来回失效。
+constexpr qint64 kTouchGranularityNs = 1000000;
+// 超出预算时一次逐出到预算的该百分比，避免每次发布都扫描全部槽位。
+constexpr qint64 kEvictTargetPercent = 90;
+
+qint64 monotonicNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+SnapshotStore::SnapshotStore() : slots_(std::make_shared<SlotMap>()) {}
+
+// 读路径：两次原子加载，无互斥锁。
+UserSnapshot SnapshotStore::current(const QString &userId) const {
+  const auto slot = findSlot(userId);
+  if (!slot) {
+    return {};
+  }
+  auto snapshot = std::atomic_load(&slot->snapshot);
+  if (snapshot) {
+    touch(*slot);
+  }
+  return snapshot;
+}
+
+UserSnapshot SnapshotStore::peek(const QString &userId) const {
+  const auto slot = findSlot(userId);
+  return slot ? std::atomic_load(&slot->snapshot) : UserSnapshot();
+}
+
+// 估算在锁外进行，锁内只做替换与计数；先记录访问时刻，避免刚发布的
+// 快照被并发的逐出当作最久未访问。
+void SnapshotStore::publish(const QString &userId, UserSnapshot snapshot) {
+  const auto slot = slotFor(userId);
+  MemoryFootprint footprint =
+      snapshot ? MemoryFootprint::of(*snapshot) : MemoryFootprint();
+  touch(*slot);
+  {
+    QMutexLocker locker(&slot->accountMutex);
+    if (snapshot) {
+      footprint.search = slot->footprint.search;
+    }
+    std::atomic_store(&slot->snapshot, std::move(snapshot));
+    ++slot->generation;
+    account(*slot, footprint);
+  }
+  enforceBudget(slot.get());
+}
+
+// 尚无槽位时代数为 0；槽位在第一次发布时创建，代数随之变为 1。
+quint64 SnapshotStore::generation(const QString &userId) const {
+  const auto slot = findSlot(userId);
+  if (!slot) {
+    return 0;
+  }
+  QMutexLocker locker(&slot->accountMutex);
+  return slot->generation;
+}
+
+// 只检查槽位是否为空并不够：读盘期间提交的新快照可能已被逐出，槽位
+// 重新变空，此时读到的旧文件不能发布。代数在逐出时保持不变，据此识别。
+UserSnapshot SnapshotStore::publishIfAbsent(const QString &userId,
+                                            UserSnapshot snapshot,
+                                            quint64 generation) {
+  auto slot = slotFor(userId);
+  const MemoryFootprint footprint = MemoryFootprint::of(*snapshot);
+  touch(*slot);
+  {
+    QMutexLocker locker(&slot->accountMutex);
+    UserSnapshot current = std::atomic_load(&slot->snapshot);
+    if (current || slot->generation != generation) {
+      return current;
+    }
+    std::atomic_store(&slot->snapshot, snapshot);
+    account(*slot, footprint);
+  }
+  enforceBudget(slot.get());
+  return snapshot;
+}
+
+void SnapshotStore::invalidate(const QString &userId) {
+  const auto slot = findSlot(userId);
+  if (!slot) {
+    return;
+  }
+  {
+    QMutexLocker locker(&slot->accountMutex);
+    std::atomic_store(&slot->snapshot, UserSnapshot());
+    ++slot->generation;
+    account(*slot, MemoryFootprint());
+  }
+  notifyEvicted(userId);
+}
+
+bool SnapshotStore::accountSearchIndex(const QString &userId, qint64 bytes) {
+  const auto slot = findSlot(userId);
+  if (!slot) {
+    return false;
+  }
+  {
+    QMutexLocker locker(&slot->accountMutex);
+    if (!std::atomic_load(&slot->snapshot)) {
+      return false;
+    }
+    MemoryFootprint footprint = slot->footprint;
+    footprint.search = bytes;
+    account(*slot, footprint);
+  }
+  enforceBudget(slot.get());
+  return true;
+}
+
+void SnapshotStore::setEvictionHandler(EvictionHandler handler) {
+  evictionHandler_ = std::move(handler);
+}
+
+void SnapshotStore::setMemoryBudget(qint64 bytes) {
+  budgetBytes_.store(std::max<qint64>(0, bytes));
+  enforceBudget(nullptr);
+}
+
+MemoryGauge SnapshotStore::gauge() const {
+  MemoryGauge gauge;
+  gauge.cachedBytes = cachedBytes_.load();
+  gauge.budgetBytes = budgetBytes_.load();
+  gauge.evictions = evictions_.load();
+  const auto slots = std::atomic_load(&slots_);
+  for (const auto &slot : *slots) {
+    if (std::atomic_load(&slot->snapshot)) {
+      ++gauge.cachedUsers;
+    }
+  }
+  return gauge;
+}
+
+QVector<QPair<QString, MemoryFootprint>> SnapshotStore::footprints() const {
+  QVector<QPair<QString, MemoryFootprint>> result;
+  const auto slots = std::atomic_load(&slots_);
+  for (auto it = slots->constBegin(); it != slots->constEnd(); ++it) {
+    QMutexLocker locker(&it.value()->accountMutex);
+    if (std::atomic_load(&it.value()->snapshot)) {
+      result.push_back({it.key(), it.value()->footprint});
+    }
+  }
+  return result;
+}
+
+std::shared_ptr<SnapshotStore::Slot> SnapshotStore::findSlot(
+    const QString &userId) const {
+  const auto slots = std::atomic_load(&slots_);
+  return slots->value(userId);
+}
+
+// 新增槽位时复制槽位表并原子替换，已有读者继续使用旧表。
+std::shared_ptr<SnapshotStore::Slot> SnapshotStore::slotFor(
+    const QString &userId) {
+  if (auto slot = findSlot(userId)) {
+    return slot;
+  }
+  QMutexLocker locker(&slotsWriteMutex_);
+  const auto slots = std::atomic_load(&slots_);
+  auto slot = slots->value(userId);
+  if (!slot) {
+    auto updated = std::make_shared<SlotMap>(*slots);
+    slot = std::make_shared<Slot>();
+    updated->insert(userId, slot);
+    std::atomic_store(&slots_, std::shared_ptr<const SlotMap>(updated));
+  }
+  return slot;
+}
+
+void SnapshotStore::account(Slot &slot, const MemoryFootprint &footprint) {
+  cachedBytes_.fetch_add(footprint.total() - slot.footprint.total());
+  slot.footprint = footprint;
+}
+
+void SnapshotStore::touch(Slot &slot) {
+  const qint64 now = monotonicNs();
+  if (now - slot.lastUsed.load(std::memory_order_relaxed) >=
+      kTouchGranularityNs) {
+    slot.lastUsed.store(now, std::memory_order_relaxed);
+  }
+}
+
+// 同一时刻只需一个线程逐出，其余线程直接返回。逐出前在槽位锁内复查
+// 访问时刻，期间被再次访问或替换的快照保留。
+void SnapshotStore::enforceBudget(const Slot *keep) {
+  const qint64 budget = budgetBytes_.load();
+  if (budget <= 0 || cachedBytes_.load() <= budget ||
+      !evictMutex_.tryLock()) {
+    return;
+  }
+  const qint64 target = budget * kEvictTargetPercent / 100;
+  const auto slots = std::atomic_load(&slots_);
+  struct Candidate {
+    qint64 lastUsed;
+    QString userId;
+    std::shared_ptr<Slot> slot;
+  };
+  QVector<Candidate> candidates;
+  for (auto it = slots->constBegin(); it != slots->constEnd(); ++it) {
+    const auto &slot = it.value();
+    if (slot.get() != keep && std::atomic_load(&slot->snapshot)) {
+      candidates.push_back({slot->lastUsed.load(), it.key(), slot});
+    }
+  }
+  std::sort(candidates.begin(), candidates.end(),
+            [](const Candidate &a, const Candidate &b) {
+              return a.lastUsed < b.lastUsed;
+            });
+  QStringList evicted;
+  for (const auto &candidate : candidates) {
+    if (cachedBytes_.load() <= target) {
+      break;
+    }
+    Slot &slot = *candidate.slot;
+    QMutexLocker locker(&slot.accountMutex);
+    if (slot.lastUsed.load() != candidate.lastUsed ||
+        !std::atomic_load(&slot.snapshot)) {
+      continue;
+    }
+    std::atomic_store(&slot.snapshot, UserSnapshot());
+    account(slot, MemoryFootprint());
+    evictions_.fetch_add(1);
+    evicted.push_back(candidate.userId);
+  }
+  evictMutex_.unlock();
+  for (const auto &userId : evicted) {
+    notifyEvicted(userId);
+  }
+}
+
+void SnapshotStore::notifyEvicted(const QString &userId) const {
+  if (evictionHandler_) {
+    evictionHandler_(userId);
+  }
+}
+
+}  // namespace core
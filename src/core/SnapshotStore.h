@@ -0,0 +1,95 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include "Entities.h"
+#include "Footprint.h"
+
+#include <QHash>
+#include <QMutex>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+
+namespace core {
+
+// 用户数据的不可变快照，发布后任何线程都只读访问。
+using UserSnapshot = std::shared_ptr<const UserData>;
+
+// SnapshotStore 以 RCU 方式发布每个用户的当前快照：写方提交时原子替换，
+// 读方原子加载后即可无锁使用，旧快照在最后一个读者释放后自动回收。
+// 每次发布时估算快照的内存占用并计入全局计量；设置预算后，超出预算的
+// 发布会按最久未访问的顺序逐出其他用户的快照，下次读取时重新加载。
+// 依附于快照的缓存（如检索索引）可把占用记在槽位上，随快照一同逐出。
+class SnapshotStore {
+ public:
+  using EvictionHandler = std::function<void(const QString &userId)>;
+
+  SnapshotStore();
+
+  // 读取当前快照并记录访问时刻，未缓存时返回空指针。
+  UserSnapshot current(const QString &userId) const;
+  // 同 current，但不影响逐出顺序，供全量扫描类的读取使用。
+  UserSnapshot peek(const QString &userId) const;
+  // 提交后发布新快照，无条件覆盖旧值。
+  void publish(const QString &userId, UserSnapshot snapshot);
+  // 槽位的发布代数，每次 publish 或 invalidate 递增，逐出不改变代数。
+  // 缓存未命中时须在读磁盘之前取得，再交给 publishIfAbsent。
+  quint64 generation(const QString &userId) const;
+  // 仅在尚无快照且代数仍为 generation 时发布（供缓存未命中时的首次加载
+  // 使用），返回最终生效的快照。读盘期间有新提交发布过（即使随后被逐出）
+  // 时拒绝发布并返回当前快照，可能为空，调用方应重新加载。
+  UserSnapshot publishIfAbsent(const QString &userId, UserSnapshot snapshot,
+                               quint64 generation);
+  // 丢弃指定用户的快照，下次读取将重新从存储加载。
+  void invalidate(const QString &userId);
+  // 把检索索引的占用记在已缓存的快照上，之后的发布沿用该值；快照不在
+  // 缓存中时不记入并返回 false，调用方应丢弃索引。
+  bool accountSearchIndex(const QString &userId, qint64 bytes);
+  // 快照被逐出或作废后在锁外调用，须在并发使用前设置。
+  void setEvictionHandler(EvictionHandler handler);
+
+  // 内存预算（字节），0 表示不限。
+  void setMemoryBudget(qint64 bytes);
+  MemoryGauge gauge() const;
+  // 当前缓存中每个用户快照的占用估算。
+  QVector<QPair<QString, MemoryFootprint>> footprints() const;
+
+ private:
+  struct Slot {
+    UserSnapshot snapshot;  // 仅通过 std::atomic_load/atomic_store 访问
+    std::atomic<qint64> lastUsed{0};  // 最近访问的单调时钟读数
+    QMutex accountMutex;  // 串行化本槽位的替换与计量
+    quint64 generation = 0;  // 发布代数，受 accountMutex 保护
+    MemoryFootprint footprint;  // 当前快照的估算，受 accountMutex 保护
+  };
+  using SlotMap = QHash<QString, std::shared_ptr<Slot>>;
+
+  std::shared_ptr<Slot> findSlot(const QString &userId) const;
+  std::shared_ptr<Slot> slotFor(const QString &userId);
+  // 在 accountMutex 下调用：以新快照的估算替换旧值并更新总量。
+  void account(Slot &slot, const MemoryFootprint &footprint);
+  static void touch(Slot &slot);
+  // 超出预算时逐出最久未访问的快照，keep 指向刚发布的槽位，不参与逐出。
+  void enforceBudget(const Slot *keep);
+  void notifyEvicted(const QString &userId) const;
+
+  // 槽位表本身也是写时复制：读方原子加载整张表，新增用户时才复制并替换。
+  std::shared_ptr<const SlotMap> slots_;
+  QMutex slotsWriteMutex_;
+  std::atomic<qint64> cachedBytes_{0};
+  std::atomic<qint64> budgetBytes_{0};
+  std::atomic<quint64> evictions_{0};
+  QMutex evictMutex_;
+  EvictionHandler evictionHandler_;
+};
+
+}  // namespace core
@@ -0,0 +1,206 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "TimestampCodec.h"
+
+namespace core {
+
+namespace {
+
+// 偏移超过 14 小时已不是真实时区，交给 Qt 决定如何处理。
+constexpr int kMaxOffsetHours = 14;
+
+ushort code(QChar ch) { return ch.unicode(); }
+ushort code(char ch) { return static_cast<uchar>(ch); }
+
+template <typename Char>
+bool isDigit(Char ch) {
+  return code(ch) >= '0' && code(ch) <= '9';
+}
+
+// 读取定长十进制数字，遇到非数字返回 false。
+template <typename Char>
+bool readDigits(const Char *p, int count, int &value) {
+  value = 0;
+  for (int i = 0; i < count; ++i) {
+    if (!isDigit(p[i])) {
+      return false;
+    }
+    value = value * 10 + (code(p[i]) - '0');
+  }
+  return true;
+}
+
+// 以定长、补零的十进制写入。
+void writeDigits(QChar *p, int count, int value) {
+  for (int i = count - 1; i >= 0; --i) {
+    p[i] = QLatin1Char(static_cast<char>('0' + value % 10));
+    value /= 10;
+  }
+}
+
+// QString 与 UTF-8 字节共用同一份快速路径。
+template <typename Char>
+bool parseFast(const Char *p, int size, QDateTime &out) {
+  if (size < 10) {
+    return false;
+  }
+  int year = 0;
+  int month = 0;
+  int day = 0;
+  if (!readDigits(p, 4, year) || code(p[4]) != '-' ||
+      !readDigits(p + 5, 2, month) || code(p[7]) != '-' ||
+      !readDigits(p + 8, 2, day)) {
+    return false;
+  }
+  const QDate date(year, month, day);
+  if (!date.isValid()) {
+    return false;
+  }
+  if (size == 10) {
+    out = QDateTime(date, QTime(0, 0), Qt::LocalTime);
+    return true;
+  }
+
+  int hour = 0;
+  int minute = 0;
+  int second = 0;
+  if (size < 19 || code(p[10]) != 'T' || !readDigits(p + 11, 2, hour) ||
+      code(p[13]) != ':' || !readDigits(p + 14, 2, minute) ||
+      code(p[16]) != ':' || !readDigits(p + 17, 2, second)) {
+    return false;
+  }
+  int pos = 19;
+  int msec = 0;
+  if (pos < size && code(p[pos]) == '.') {
+    const int start = ++pos;
+    while (pos < size && isDigit(p[pos])) {
+      ++pos;
+    }
+    const int count = pos - start;
+    if (count < 1 || count > 3) {
+      return false;
+    }
+    readDigits(p + start, count, msec);
+    for (int i = count; i < 3; ++i) {
+      msec *= 10;
+    }
+  }
+  // 24:00:00 等 QTime 不接受的写法由 Qt 特殊处理。
+  const QTime time(hour, minute, second, msec);
+  if (!time.isValid()) {
+    return false;
+  }
+
+  if (pos == size) {
+    out = QDateTime(date, time, Qt::LocalTime);
+    return true;
+  }
+  if (code(p[pos]) == 'Z' && pos + 1 == size) {
+    out = QDateTime(date, time, Qt::UTC);
+    return true;
+  }
+  const ushort sign = code(p[pos]);
+  if ((sign != '+' && sign != '-') || pos + 6 != size ||
+      code(p[pos + 3]) != ':') {
+    return false;
+  }
+  int offsetHours = 0;
+  int offsetMinutes = 0;
+  if (!readDigits(p + pos + 1, 2, offsetHours) ||
+      !readDigits(p + pos + 4, 2, offsetMinutes) ||
+      offsetHours > kMaxOffsetHours || offsetMinutes > 59) {
+    return false;
+  }
+  int offset = (offsetHours * 60 + offsetMinutes) * 60;
+  if (sign == '-') {
+    offset = -offset;
+  }
+  out = QDateTime(date, time, Qt::OffsetFromUTC, offset);
+  return true;
+}
+
+}  // namespace
+
+QString TimestampCodec::format(const QDateTime &value) {
+  QString text;
+  if (tryFormatFast(value, text)) {
+    return text;
+  }
+  return value.toString(Qt::ISODate);
+}
+
+QDateTime TimestampCodec::parse(const QString &text) {
+  QDateTime value;
+  if (tryParseFast(text, value)) {
+    return value;
+  }
+  return QDateTime::fromString(text, Qt::ISODate);
+}
+
+QDateTime TimestampCodec::parseUtf8(const char *data, int size) {
+  QDateTime value;
+  if (parseFast(data, size, value)) {
+    return value;
+  }
+  return QDateTime::fromString(QString::fromUtf8(data, size), Qt::ISODate);
+}
+
+// 与 Qt 一致：秒以下不输出，UTC 写 Z，固定偏移写 ±HH:mm，本地时间不带后缀。
+bool TimestampCodec::tryFormatFast(const QDateTime &value, QString &out) {
+  if (!value.isValid()) {
+    return false;
+  }
+  const Qt::TimeSpec spec = value.timeSpec();
+  int offset = 0;
+  int suffix = 0;
+  if (spec == Qt::UTC) {
+    suffix = 1;
+  } else if (spec == Qt::OffsetFromUTC) {
+    offset = value.offsetFromUtc();
+    if (offset % 60 != 0) {
+      return false;
+    }
+    suffix = 6;
+  } else if (spec != Qt::LocalTime) {
+    return false;
+  }
+  const QDate date = value.date();
+  const QTime time = value.time();
+  if (date.year() < 1 || date.year() > 9999) {
+    return false;
+  }
+
+  out.resize(19 + suffix);
+  QChar *p = out.data();
+  writeDigits(p, 4, date.year());
+  p[4] = QLatin1Char('-');
+  writeDigits(p + 5, 2, date.month());
+  p[7] = QLatin1Char('-');
+  writeDigits(p + 8, 2, date.day());
+  p[10] = QLatin1Char('T');
+  writeDigits(p + 11, 2, time.hour());
+  p[13] = QLatin1Char(':');
+  writeDigits(p + 14, 2, time.minute());
+  p[16] = QLatin1Char(':');
+  writeDigits(p + 17, 2, time.second());
+  if (spec == Qt::UTC) {
+    p[19] = QLatin1Char('Z');
+  } else if (spec == Qt::OffsetFromUTC) {
+    p[19] = QLatin1Char(offset < 0 ? '-' : '+');
+    const int minutes = qAbs(offset) / 60;
+    writeDigits(p + 20, 2, minutes / 60);
+    p[22] = QLatin1Char(':');
+    writeDigits(p + 23, 2, minutes % 60);
+  }
+  return true;
+}
+
+bool TimestampCodec::tryParseFast(const QString &text, QDateTime &out) {
+  return parseFast(text.constData(), text.size(), out);
+}
+
+}  // namespace core
@@ -0,0 +1,33 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QDateTime>
+#include <QString>
+
+namespace core {
+
+// TimestampCodec 手写解析与生成 JsonStorage 使用的 ISO 8601 时间戳，
+// 结果与 QDateTime 的 Qt::ISODate 完全一致。快速路径覆盖
+//   yyyy-MM-dd、yyyy-MM-ddTHH:mm:ss[.z{1,3}][Z|±HH:mm]
+// 逐字符校验数字与分隔符，不经过格式串与区域设置；其余写法
+// （空格分隔、24:00、秒级偏移、QTimeZone 等）交给 Qt 处理。
+class TimestampCodec {
+ public:
+  // 等价于 value.toString(Qt::ISODate)。
+  static QString format(const QDateTime &value);
+  // 等价于 QDateTime::fromString(text, Qt::ISODate)。
+  static QDateTime parse(const QString &text);
+  // 同 parse，直接解析 UTF-8 字节，快速路径不构造 QString。
+  static QDateTime parseUtf8(const char *data, int size);
+
+  // 只走快速路径，无法处理时返回 false；供测试与基准区分两条路径。
+  static bool tryFormatFast(const QDateTime &value, QString &out);
+  static bool tryParseFast(const QString &text, QDateTime &out);
+};
+
+}  // namespace core
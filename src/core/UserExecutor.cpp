@@ -0,0 +1,217 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "UserExecutor.h"
+
+#include <QMutexLocker>
+#include <QRunnable>
+
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+namespace core {
+
+namespace {
+
+// 单次排空最多连续执行的任务数，超出后重新排队，避免繁忙用户长期占用线程。
+constexpr int kDrainBatch = 32;
+// 执行器表达到该大小后才开始回收空闲执行器。
+constexpr int kMinSweepSize = 64;
+
+// 记录当前线程正在执行或持有的执行器，用于可重入判断。
+thread_local std::vector<const SerialExecutor *> tlsHeldExecutors;
+
+}  // namespace
+
+// 线程池任务：持有执行器的共享所有权并排空其队列。
+class SerialExecutor::DrainTask : public QRunnable {
+ public:
+  explicit DrainTask(std::shared_ptr<SerialExecutor> executor)
+      : executor_(std::move(executor)) {}
+  void run() override { executor_->drain(); }
+
+ private:
+  std::shared_ptr<SerialExecutor> executor_;
+};
+
+SerialExecutor::SerialExecutor(QThreadPool *pool) : pool_(pool) {}
+
+// 入队后若执行器空闲且未暂停，则调度一次排空。
+void SerialExecutor::post(std::function<void()> task) {
+  QMutexLocker locker(&mutex_);
+  queue_.push_back(std::move(task));
+  if (!scheduled_ && !suspended_) {
+    scheduled_ = true;
+    schedule();
+  }
+}
+
+// 屏障任务在轮到自己时把执行器置为暂停，并通知等待方。
+std::future<void> SerialExecutor::acquire() {
+  auto promise = std::make_shared<std::promise<void>>();
+  auto future = promise->get_future();
+  post([this, promise] {
+    QMutexLocker locker(&mutex_);
+    suspended_ = true;
+    promise->set_value();
+  });
+  return future;
+}
+
+// 解除暂停，若期间有新任务则恢复排空。
+void SerialExecutor::release() {
+  QMutexLocker locker(&mutex_);
+  suspended_ = false;
+  if (!scheduled_ && !queue_.empty()) {
+    scheduled_ = true;
+    schedule();
+  }
+}
+
+bool SerialExecutor::heldByCurrentThread() const {
+  return std::find(tlsHeldExecutors.begin(), tlsHeldExecutors.end(), this) !=
+         tlsHeldExecutors.end();
+}
+
+void SerialExecutor::markHeldByCurrentThread(bool held) const {
+  if (held) {
+    tlsHeldExecutors.push_back(this);
+    return;
+  }
+  const auto it =
+      std::find(tlsHeldExecutors.rbegin(), tlsHeldExecutors.rend(), this);
+  if (it != tlsHeldExecutors.rend()) {
+    tlsHeldExecutors.erase(std::next(it).base());
+  }
+}
+
+void SerialExecutor::schedule() {
+  pool_->start(new DrainTask(shared_from_this()));
+}
+
+// 依次取出任务执行；队列为空或遇到屏障暂停时退出。
+void SerialExecutor::drain() {
+  for (int processed = 0;; ++processed) {
+    std::function<void()> task;
+    {
+      QMutexLocker locker(&mutex_);
+      if (queue_.empty() || suspended_) {
+        scheduled_ = false;
+        return;
+      }
+      if (processed == kDrainBatch) {
+        schedule();
+        return;
+      }
+      task = std::move(queue_.front());
+      queue_.pop_front();
+    }
+    markHeldByCurrentThread(true);
+    task();
+    markHeldByCurrentThread(false);
+  }
+}
+
+UserExecutors::UserExecutors(int maxThreads) : sweepAt_(kMinSweepSize) {
+  pool_.setMaxThreadCount(std::max(1, maxThreads));
+}
+
+// 析构前等待所有已提交任务完成。
+UserExecutors::~UserExecutors() { pool_.waitForDone(); }
+
+// 同步执行：任务在用户执行器上运行，调用方阻塞直至完成。
+void UserExecutors::run(const QString &userId,
+                        const std::function<void()> &task) {
+  auto executor = executorFor(userId);
+  if (executor->heldByCurrentThread()) {
+    task();
+    return;
+  }
+  std::promise<void> done;
+  auto future = done.get_future();
+  executor->post([&task, &done] {
+    try {
+      task();
+      done.set_value();
+    } catch (...) {
+      done.set_exception(std::current_exception());
+    }
+  });
+  future.get();
+}
+
+// 多用户操作：按排序后的 ID 逐个放置屏障，全部就绪后在调用线程执行。
+void UserExecutors::runExclusive(const QStringList &userIds,
+                                 const std::function<void()> &task) {
+  QStringList ids = userIds;
+  ids.removeDuplicates();
+  std::sort(ids.begin(), ids.end());
+
+  std::vector<std::shared_ptr<SerialExecutor>> acquired;
+  for (const auto &id : ids) {
+    auto executor = executorFor(id);
+    if (executor->heldByCurrentThread()) {
+      continue;
+    }
+    executor->acquire().wait();
+    executor->markHeldByCurrentThread(true);
+    acquired.push_back(executor);
+  }
+
+  auto releaseAll = [&acquired] {
+    for (auto it = acquired.rbegin(); it != acquired.rend(); ++it) {
+      (*it)->markHeldByCurrentThread(false);
+      (*it)->release();
+    }
+  };
+  try {
+    task();
+  } catch (...) {
+    releaseAll();
+    throw;
+  }
+  releaseAll();
+}
+
+void UserExecutors::post(const QString &userId, std::function<void()> task) {
+  executorFor(userId)->post(std::move(task));
+}
+
+int UserExecutors::size() const {
+  QMutexLocker locker(&mutex_);
+  return executors_.size();
+}
+
+// 执行器按需创建；表长达到上次回收后的两倍时回收一次，均摊 O(1)。
+std::shared_ptr<SerialExecutor> UserExecutors::executorFor(
+    const QString &userId) {
+  QMutexLocker locker(&mutex_);
+  auto it = executors_.find(userId);
+  if (it == executors_.end()) {
+    if (executors_.size() >= sweepAt_) {
+      sweepIdle();
+    }
+    it = executors_.insert(userId, std::make_shared<SerialExecutor>(&pool_));
+  }
+  return it.value();
+}
+
+// 调用方、排空任务与屏障持有者都持有执行器的共享指针，只被本表引用的
+// 执行器没有排队任务也没有人持有，可以丢弃，下次使用时重建。引用只在
+// mutex_ 下从表中取得，因此丢弃后不会有两个执行器服务同一用户。
+void UserExecutors::sweepIdle() {
+  for (auto it = executors_.begin(); it != executors_.end();) {
+    if (it.value().use_count() == 1) {
+      it = executors_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  sweepAt_ = std::max(kMinSweepSize, executors_.size() * 2);
+}
+
+}  // namespace core
@@ -0,0 +1,86 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+#include <QThreadPool>
+
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace core {
+
+// SerialExecutor 在共享线程池上按提交顺序逐个执行任务（actor 式邮箱），
+// 同一执行器的任务永不并发，不同执行器之间完全并行。
+class SerialExecutor : public std::enable_shared_from_this<SerialExecutor> {
+ public:
+  explicit SerialExecutor(QThreadPool *pool);
+
+  // 追加任务，必要时调度一次排空。
+  void post(std::function<void()> task);
+  // 排入屏障：此前的任务全部完成后 future 就绪，执行器随即暂停，
+  // 直到 release() 才继续处理后续任务。暂停期间不占用线程池线程。
+  std::future<void> acquire();
+  void release();
+
+  // 当前线程是否正在执行本执行器的任务或持有其屏障。
+  bool heldByCurrentThread() const;
+  void markHeldByCurrentThread(bool held) const;
+
+ private:
+  class DrainTask;
+
+  void schedule();
+  void drain();
+
+  QThreadPool *pool_ = nullptr;
+  QMutex mutex_;
+  std::deque<std::function<void()>> queue_;
+  bool scheduled_ = false;
+  bool suspended_ = false;
+};
+
+// UserExecutors 为每个用户维护一个 SerialExecutor，所有执行器共享同一线程池。
+// 同一用户的修改被串行化，从而消除“读取-修改-写回”之间的丢失更新。
+// 空闲的执行器会被回收，表的大小与近期活跃用户数相当，而非历史上出现过的
+// 全部 ID。
+class UserExecutors {
+ public:
+  explicit UserExecutors(int maxThreads = QThread::idealThreadCount());
+  ~UserExecutors();
+
+  UserExecutors(const UserExecutors &) = delete;
+  UserExecutors &operator=(const UserExecutors &) = delete;
+
+  // 在指定用户的执行器上运行任务并等待完成；若当前线程已持有该用户则直接执行。
+  void run(const QString &userId, const std::function<void()> &task);
+  // 同时独占多个用户（按 ID 排序依次获取，避免死锁），在调用线程上运行任务。
+  void runExclusive(const QStringList &userIds,
+                    const std::function<void()> &task);
+  // 异步提交，不等待结果。
+  void post(const QString &userId, std::function<void()> task);
+
+  // 当前保留的执行器数。
+  int size() const;
+
+ private:
+  std::shared_ptr<SerialExecutor> executorFor(const QString &userId);
+  void sweepIdle();
+
+  QThreadPool pool_;
+  mutable QMutex mutex_;
+  QHash<QString, std::shared_ptr<SerialExecutor>> executors_;
+  int sweepAt_ = 0;
+};
+
+}  // namespace core
@@ -0,0 +1,449 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "ApiRouter.h"
+
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QUrlQuery>
+
+namespace server {
+
+namespace {
+
+// 评论分页未指定 limit 时的每页条数。
+constexpr int kDefaultCommentPage = 50;
+
+// 对外返回的档案不包含密码哈希。
+QJsonObject publicProfile(const core::UserProfile &profile) {
+  auto obj = profile.toJson();
+  obj.remove("passwordHash");
+  return obj;
+}
+
+// 请求中的 ID 来自客户端，只做不登记的查找，避免任意文本撑大驻留表；
+// 查不到的 ID 不可能对应已有实体。
+bool isKnownId(const QString &text) {
+  core::EntityId id;
+  return core::EntityId::lookup(text, id);
+}
+
+bool isKnownId(const QJsonObject &body, const char *key) {
+  return isKnownId(body.value(key).toString());
+}
+
+}  // namespace
+
+ApiRouter::ApiRouter(core::LedgerService *service) : service_(service) {}
+
+// 顶层路由：注册、登录与以用户为前缀的资源。
+HttpResponse ApiRouter::handle(const HttpRequest &request) const {
+  HttpResponse response;
+  const auto segments = splitPath(request.path);
+  if (segments.size() < 2 || segments[0] != "api") {
+    response = error(404, "未知接口");
+  } else if (!request.body.isEmpty() &&
+             !QJsonDocument::fromJson(request.body).isObject()) {
+    response = error(400, "请求体必须是 JSON 对象");
+  } else if (segments[1] == "register" && segments.size() == 2) {
+    if (request.method != "POST") {
+      response = error(405, "仅支持 POST");
+    } else {
+      const auto body = QJsonDocument::fromJson(request.body).object();
+      QString userId;
+      QString message;
+      if (service_->registerUser(body.value("username").toString(),
+                                 body.value("email").toString(),
+                                 body.value("password").toString(), userId,
+                                 message)) {
+        QJsonObject obj;
+        obj["userId"] = userId;
+        obj["token"] = issueToken(userId);
+        response = json(obj);
+      } else {
+        response = error(400, message);
+      }
+    }
+  } else if (segments[1] == "login" && segments.size() == 2) {
+    if (request.method != "POST") {
+      response = error(405, "仅支持 POST");
+    } else {
+      const auto body = QJsonDocument::fromJson(request.body).object();
+      QString message;
+      const auto profile = service_->authenticate(
+          body.value("login").toString(), body.value("password").toString(),
+          message);
+      if (profile) {
+        auto obj = publicProfile(*profile);
+        obj["token"] = issueToken(profile->id);
+        response = json(obj);
+      } else {
+        response = error(400, message);
+      }
+    }
+  } else if (segments[1] == "report" && segments.size() == 2) {
+    response = request.method == "GET" ? systemReport()
+                                       : error(405, "仅支持 GET");
+  } else if (segments[1] == "users" && segments.size() >= 4) {
+    response = authorized(request, segments[2])
+                   ? handleUser(request, segments)
+                   : error(401, "未登录或令牌无效");
+  } else {
+    response = error(404, "未知接口");
+  }
+  response.keepAlive = request.keepAlive;
+  return response;
+}
+
+// 用户资源路由，形如 /api/users/<userId>/<resource>[/<itemId>]。
+HttpResponse ApiRouter::handleUser(const HttpRequest &request,
+                                   const QStringList &segments) const {
+  const auto &userId = segments[2];
+  const auto &resource = segments[3];
+  const auto itemId = segments.value(4);
+  const auto &method = request.method;
+  const auto body = QJsonDocument::fromJson(request.body).object();
+  QString message;
+  if (!isKnownId(itemId)) {
+    return error(404, "条目不存在");
+  }
+
+  if (resource == "profile" && method == "GET") {
+    const auto profile = service_->profile(userId);
+    return profile ? json(publicProfile(*profile)) : error(404, "用户不存在");
+  }
+  if (resource == "settings" && (method == "PUT" || method == "POST")) {
+    const bool ok = service_->updateSettings(
+        userId, body.value("notificationsEnabled").toBool(true),
+        body.value("privacyLevel").toString("friends"), message);
+    return result(ok, message);
+  }
+  if (resource == "friends" && method == "POST") {
+    return result(
+        service_->addFriend(userId, body.value("handle").toString(), message),
+        message);
+  }
+
+  if (resource == "categories") {
+    if (method == "GET") {
+      QJsonArray array;
+      for (const auto &category : service_->categories(userId)) {
+        array.append(category.toJson());
+      }
+      return jsonArray(array);
+    }
+    if (method == "POST" || method == "PUT") {
+      if (!isKnownId(body, "id")) {
+        return error(400, "ID 无效");
+      }
+      return result(service_->upsertCategory(
+                        userId, core::Category::fromJson(body), message),
+                    message);
+    }
+    if (method == "DELETE" && !itemId.isEmpty()) {
+      return result(service_->removeCategory(userId, itemId, message),
+                    message);
+    }
+    return error(405, "不支持的方法");
+  }
+
+  if (resource == "bills") {
+    if (method == "GET") {
+      // 带 ?from=&to=（yyyy-MM-dd，可只给一端）时包含区间内的归档账单。
+      const QUrlQuery query(request.query);
+      const bool ranged =
+          query.hasQueryItem("from") || query.hasQueryItem("to");
+      const QDate from =
+          QDate::fromString(query.queryItemValue("from"), Qt::ISODate);
+      const QDate to =
+          QDate::fromString(query.queryItemValue("to"), Qt::ISODate);
+      QJsonArray array;
+      for (const auto &bill : ranged ? service_->bills(userId, from, to)
+                                     : service_->bills(userId)) {
+        array.append(bill.toJson());
+      }
+      return jsonArray(array);
+    }
+    if (method == "POST" || method == "PUT") {
+      if (!isKnownId(body, "id")) {
+        return error(400, "ID 无效");
+      }
+      if (!isKnownId(body, "categoryId")) {
+        return error(400, "分类不存在");
+      }
+      return result(
+          service_->upsertBill(userId, core::Bill::fromJson(body), message),
+          message);
+    }
+    if (method == "DELETE" && !itemId.isEmpty()) {
+      return result(service_->removeBill(userId, itemId, message), message);
+    }
+    return error(405, "不支持的方法");
+  }
+
+  if (resource == "summary" && method == "GET") {
+    QJsonArray categories;
+    for (const auto &summary : service_->summarizeByCategory(userId)) {
+      QJsonObject obj;
+      obj["categoryId"] = summary.categoryId.toString();
+      obj["name"] = summary.name;
+      obj["income"] = summary.income;
+      obj["expense"] = summary.expense;
+      categories.append(obj);
+    }
+    QJsonObject obj;
+    obj["income"] = service_->totalIncome(userId);
+    obj["expense"] = service_->totalExpense(userId);
+    obj["categories"] = categories;
+    return json(obj);
+  }
+
+  if (resource == "series" && method == "GET") {
+    // ?period=day|week|month|year&from=yyyy-MM-dd&to=yyyy-MM-dd[&category=id]
+    const QUrlQuery query(request.query);
+    static const QHash<QString, core::RollupPeriod> kPeriods = {
+        {"day", core::RollupPeriod::Day},
+        {"week", core::RollupPeriod::Week},
+        {"month", core::RollupPeriod::Month},
+        {"year", core::RollupPeriod::Year}};
+    const QString periodName = query.queryItemValue("period");
+    const QDate to = query.hasQueryItem("to")
+                         ? QDate::fromString(query.queryItemValue("to"),
+                                             Qt::ISODate)
+                         : QDate::currentDate();
+    const QDate from = query.hasQueryItem("from")
+                           ? QDate::fromString(query.queryItemValue("from"),
+                                               Qt::ISODate)
+                           : to.addDays(-6);
+    if (!kPeriods.contains(periodName.isEmpty() ? "day" : periodName) ||
+        !from.isValid() || !to.isValid() || from.daysTo(to) > 366 * 100) {
+      return error(400, "参数无效");
+    }
+    if (!isKnownId(query.queryItemValue("category"))) {
+      return error(404, "分类不存在");
+    }
+    QJsonArray points;
+    for (const auto &point : service_->periodSeries(
+             userId, kPeriods.value(periodName, core::RollupPeriod::Day),
+             from, to, query.queryItemValue("category"))) {
+      QJsonObject obj;
+      obj["start"] = point.start.toString(Qt::ISODate);
+      obj["income"] = point.totals.income;
+      obj["expense"] = point.totals.expense;
+      obj["count"] = point.totals.count;
+      points.append(obj);
+    }
+    return jsonArray(points);
+  }
+
+  if (resource == "query" && method == "GET") {
+    // ?q=过滤表达式，语法见 core::BillQuery。
+    const QUrlQuery query(request.query);
+    core::BillQueryResult queryResult;
+    if (!service_->queryBills(userId,
+                              query.queryItemValue("q", QUrl::FullyDecoded),
+                              queryResult, message)) {
+      return error(400, message);
+    }
+    auto totalsJson = [](const core::RollupTotals &totals) {
+      QJsonObject obj;
+      obj["income"] = totals.income;
+      obj["expense"] = totals.expense;
+      obj["count"] = totals.count;
+      return obj;
+    };
+    QJsonArray bills;
+    for (const auto &bill : queryResult.bills) {
+      bills.append(bill.toJson());
+    }
+    QJsonArray groups;
+    for (const auto &group : queryResult.groups) {
+      auto obj = totalsJson(group.totals);
+      obj["key"] = group.key;
+      groups.append(obj);
+    }
+    QJsonObject obj;
+    obj["bills"] = bills;
+    obj["totals"] = totalsJson(queryResult.totals);
+    obj["groups"] = groups;
+    return json(obj);
+  }
+
+  if (resource == "search" && method == "GET") {
+    const QUrlQuery query(request.query);
+    static const char *const kKinds[] = {"bill", "post", "comment"};
+    const int limit = query.hasQueryItem("limit")
+                          ? query.queryItemValue("limit").toInt()
+                          : 20;
+    QJsonArray hits;
+    for (const auto &hit : service_->search(
+             userId, query.queryItemValue("q", QUrl::FullyDecoded),
+             qBound(1, limit, 200))) {
+      QJsonObject obj;
+      obj["kind"] = kKinds[static_cast<int>(hit.kind)];
+      obj["id"] = hit.id;
+      if (!hit.parentId.isEmpty()) {
+        obj["postId"] = hit.parentId;
+      }
+      obj["score"] = hit.score;
+      hits.append(obj);
+    }
+    return jsonArray(hits);
+  }
+
+  if (resource == "reminders") {
+    if (method == "GET") {
+      QJsonArray array;
+      for (const auto &reminder : service_->reminders(userId)) {
+        array.append(reminder.toJson());
+      }
+      return jsonArray(array);
+    }
+    if (method == "POST" || method == "PUT") {
+      if (!isKnownId(body, "id")) {
+        return error(400, "ID 无效");
+      }
+      return result(service_->upsertReminder(
+                        userId, core::Reminder::fromJson(body), message),
+                    message);
+    }
+    if (method == "DELETE" && !itemId.isEmpty()) {
+      return result(service_->removeReminder(userId, itemId, message),
+                    message);
+    }
+    return error(405, "不支持的方法");
+  }
+
+  if (resource == "timeline" && method == "GET") {
+    QJsonArray array;
+    for (const auto &post : service_->timeline(userId)) {
+      auto obj = post.toJson();
+      obj["commentCount"] = post.commentCount;
+      array.append(obj);
+    }
+    return jsonArray(array);
+  }
+  if (resource == "comments" && method == "GET") {
+    // ?ownerId=作者&postId=动态[&offset=0&limit=50]，完整评论串分页读取。
+    const QUrlQuery query(request.query);
+    if (!isKnownId(query.queryItemValue("postId"))) {
+      return error(404, "动态不存在");
+    }
+    const int offset = query.queryItemValue("offset").toInt();
+    const int limit = query.hasQueryItem("limit")
+                          ? query.queryItemValue("limit").toInt()
+                          : kDefaultCommentPage;
+    int total = 0;
+    QJsonArray array;
+    for (const auto &comment : service_->postComments(
+             userId, query.queryItemValue("ownerId"),
+             query.queryItemValue("postId"), offset, qMax(limit, 0),
+             &total)) {
+      array.append(comment.toJson());
+    }
+    QJsonObject obj;
+    obj["comments"] = array;
+    obj["total"] = total;
+    return json(obj);
+  }
+  if (resource == "posts" && method == "POST") {
+    return result(service_->publishPost(
+                      userId, body.value("content").toString(),
+                      body.value("visibility").toString("public"), message),
+                  message);
+  }
+  if (resource == "comments" && method == "POST") {
+    if (!isKnownId(body, "postId")) {
+      return error(404, "动态不存在");
+    }
+    return result(service_->addComment(userId,
+                                       body.value("ownerId").toString(),
+                                       body.value("postId").toString(),
+                                       body.value("content").toString(),
+                                       message),
+                  message);
+  }
+  return error(404, "未知接口");
+}
+
+QString ApiRouter::issueToken(const QString &userId) const {
+  QMutexLocker locker(&tokensMutex_);
+  auto &token = tokens_[userId];
+  if (token.isEmpty()) {
+    quint32 words[8];
+    QRandomGenerator::system()->fillRange(words);
+    token = QByteArray(reinterpret_cast<const char *>(words), sizeof(words))
+                .toHex();
+  }
+  return QString::fromLatin1(token);
+}
+
+bool ApiRouter::authorized(const HttpRequest &request,
+                           const QString &userId) const {
+  static const QByteArray kBearer = "Bearer ";
+  const auto header = request.headers.value("authorization");
+  if (!header.startsWith(kBearer)) {
+    return false;
+  }
+  QMutexLocker locker(&tokensMutex_);
+  const auto it = tokens_.constFind(userId);
+  return it != tokens_.constEnd() && header.mid(kBearer.size()) == it.value();
+}
+
+// 全系统收支报表，分类按名称跨用户合并。
+HttpResponse ApiRouter::systemReport() const {
+  const auto report = service_->systemReport();
+  QJsonArray categories;
+  for (const auto &summary : report.categories) {
+    QJsonObject obj;
+    obj["name"] = summary.name;
+    obj["income"] = summary.income;
+    obj["expense"] = summary.expense;
+    categories.append(obj);
+  }
+  QJsonObject obj;
+  obj["users"] = report.users;
+  obj["bills"] = report.bills;
+  obj["income"] = report.income;
+  obj["expense"] = report.expense;
+  obj["categories"] = categories;
+  obj["elapsedMs"] = static_cast<double>(report.elapsedMs);
+  return json(obj);
+}
+
+HttpResponse ApiRouter::json(const QJsonObject &obj, int status) {
+  HttpResponse response;
+  response.status = status;
+  response.body = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+  return response;
+}
+
+HttpResponse ApiRouter::jsonArray(const QJsonArray &array) {
+  HttpResponse response;
+  response.body = QJsonDocument(array).toJson(QJsonDocument::Compact);
+  return response;
+}
+
+// 错误统一以 {"error": "..."} 形式返回。
+HttpResponse ApiRouter::error(int status, const QString &message) {
+  QJsonObject obj;
+  obj["error"] = message;
+  return json(obj, status);
+}
+
+// 业务接口返回布尔值时的通用应答。
+HttpResponse ApiRouter::result(bool ok, const QString &errorMessage) {
+  if (!ok) {
+    return error(400, errorMessage);
+  }
+  QJsonObject obj;
+  obj["ok"] = true;
+  return json(obj);
+}
+
+}  // namespace server
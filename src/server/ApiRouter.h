@@ -0,0 +1,49 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QMutex>
+#include <QStringList>
+
+#include "core/LedgerService.h"
+#include "server/HttpMessage.h"
+
+namespace server {
+
+// ApiRouter 将 HTTP/JSON 请求映射到 LedgerService 的业务接口。
+// 注册与登录时为用户签发令牌，/api/users/<userId>/… 须携带
+// “Authorization: Bearer <令牌>”且令牌属于路径中的用户；
+// 令牌表由互斥锁保护，路由可被多个工作线程同时调用。
+class ApiRouter {
+ public:
+  explicit ApiRouter(core::LedgerService *service);
+
+  // 处理一条请求并生成应答，连接保持策略沿用请求中的设置。
+  HttpResponse handle(const HttpRequest &request) const;
+
+ private:
+  HttpResponse handleUser(const HttpRequest &request,
+                          const QStringList &segments) const;
+  HttpResponse systemReport() const;
+  // 每个用户只持有一个令牌，重复登录沿用同一个，令牌表大小以用户数为界。
+  QString issueToken(const QString &userId) const;
+  bool authorized(const HttpRequest &request, const QString &userId) const;
+
+  static HttpResponse json(const QJsonObject &obj, int status = 200);
+  static HttpResponse jsonArray(const QJsonArray &array);
+  static HttpResponse error(int status, const QString &message);
+  static HttpResponse result(bool ok, const QString &errorMessage);
+
+  core::LedgerService *service_ = nullptr;
+  mutable QMutex tokensMutex_;
+  mutable QHash<QString, QByteArray> tokens_;
+};
+
+}  // namespace server
@@ -0,0 +1,225 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "HttpMessage.h"
+
+#include <QList>
+#include <QUrl>
+
+namespace server {
+
+namespace {
+
+// 解析头部行，键转为小写便于查找；格式错误返回 false。
+bool parseHeaderLines(const QList<QByteArray> &lines, int firstLine,
+                      QHash<QByteArray, QByteArray> &headers) {
+  for (int i = firstLine; i < lines.size(); ++i) {
+    const auto &line = lines[i];
+    if (line.isEmpty()) {
+      continue;
+    }
+    const int colon = line.indexOf(':');
+    if (colon <= 0) {
+      return false;
+    }
+    headers.insert(line.left(colon).trimmed().toLower(),
+                   line.mid(colon + 1).trimmed());
+  }
+  return true;
+}
+
+// 读取 Content-Length，缺省为 0，非法值返回 -1。
+int contentLength(const QHash<QByteArray, QByteArray> &headers) {
+  const auto it = headers.constFind("content-length");
+  if (it == headers.constEnd()) {
+    return 0;
+  }
+  bool ok = false;
+  const int length = it.value().toInt(&ok);
+  return ok && length >= 0 ? length : -1;
+}
+
+}  // namespace
+
+// 生成带长度与连接头的完整应答报文。
+QByteArray HttpResponse::serialize() const {
+  QByteArray out;
+  out.reserve(128 + body.size());
+  out.append("HTTP/1.1 ");
+  out.append(QByteArray::number(status));
+  out.append(' ');
+  out.append(reasonPhrase(status));
+  out.append("\r\nContent-Type: ");
+  out.append(contentType);
+  out.append("\r\nContent-Length: ");
+  out.append(QByteArray::number(body.size()));
+  out.append(keepAlive ? "\r\nConnection: keep-alive\r\n\r\n"
+                       : "\r\nConnection: close\r\n\r\n");
+  out.append(body);
+  return out;
+}
+
+// 仅覆盖服务端实际会返回的状态码。
+QByteArray HttpResponse::reasonPhrase(int status) {
+  switch (status) {
+    case 200:
+      return "OK";
+    case 400:
+      return "Bad Request";
+    case 401:
+      return "Unauthorized";
+    case 404:
+      return "Not Found";
+    case 405:
+      return "Method Not Allowed";
+    case 413:
+      return "Payload Too Large";
+    case 500:
+      return "Internal Server Error";
+    case 501:
+      return "Not Implemented";
+    default:
+      return "Unknown";
+  }
+}
+
+void HttpRequestParser::feed(const QByteArray &bytes) { buffer_.append(bytes); }
+
+// 每次只消费一条请求，剩余字节留给下一次调用，从而支持流水线。
+bool HttpRequestParser::next(HttpRequest &outRequest) {
+  if (error_) {
+    return false;
+  }
+  const int headerEnd = buffer_.indexOf("\r\n\r\n");
+  if (headerEnd < 0) {
+    if (buffer_.size() > kMaxHeaderBytes) {
+      error_ = true;
+    }
+    return false;
+  }
+
+  const auto lines = buffer_.left(headerEnd).split('\n');
+  QList<QByteArray> trimmed;
+  trimmed.reserve(lines.size());
+  for (const auto &line : lines) {
+    trimmed.append(line.endsWith('\r') ? line.left(line.size() - 1) : line);
+  }
+  const auto requestLine = trimmed.value(0).split(' ');
+  if (requestLine.size() != 3) {
+    error_ = true;
+    return false;
+  }
+
+  HttpRequest request;
+  request.method = requestLine[0].toUpper();
+  request.version = requestLine[2];
+  if (!parseHeaderLines(trimmed, 1, request.headers)) {
+    error_ = true;
+    return false;
+  }
+  // 仅支持 Content-Length 形式的请求体。
+  if (request.headers.contains("transfer-encoding")) {
+    error_ = true;
+    return false;
+  }
+  const int length = contentLength(request.headers);
+  if (length < 0 || length > kMaxBodyBytes) {
+    error_ = true;
+    return false;
+  }
+  const int bodyStart = headerEnd + 4;
+  if (buffer_.size() - bodyStart < length) {
+    return false;
+  }
+  request.body = buffer_.mid(bodyStart, length);
+  buffer_.remove(0, bodyStart + length);
+
+  const auto target = requestLine[1];
+  const int queryPos = target.indexOf('?');
+  request.path = QUrl::fromPercentEncoding(
+      queryPos < 0 ? target : target.left(queryPos));
+  if (queryPos >= 0) {
+    request.query = QString::fromUtf8(target.mid(queryPos + 1));
+  }
+
+  // HTTP/1.1 默认长连接，HTTP/1.0 需要显式声明 keep-alive。
+  const auto connection = request.headers.value("connection").toLower();
+  if (request.version == "HTTP/1.0") {
+    request.keepAlive = connection == "keep-alive";
+  } else {
+    request.keepAlive = connection != "close";
+  }
+
+  outRequest = request;
+  return true;
+}
+
+void HttpResponseParser::feed(const QByteArray &bytes) {
+  buffer_.append(bytes);
+}
+
+// 客户端解析逻辑与请求解析对称，只关心状态码与正文。
+bool HttpResponseParser::next(int &outStatus, QByteArray &outBody) {
+  if (error_) {
+    return false;
+  }
+  const int headerEnd = buffer_.indexOf("\r\n\r\n");
+  if (headerEnd < 0) {
+    return false;
+  }
+  const auto lines = buffer_.left(headerEnd).split('\n');
+  const auto statusLine = lines.value(0).trimmed().split(' ');
+  if (statusLine.size() < 2) {
+    error_ = true;
+    return false;
+  }
+  QList<QByteArray> trimmed;
+  for (const auto &line : lines) {
+    trimmed.append(line.trimmed());
+  }
+  QHash<QByteArray, QByteArray> headers;
+  if (!parseHeaderLines(trimmed, 1, headers)) {
+    error_ = true;
+    return false;
+  }
+  const int length = contentLength(headers);
+  if (length < 0) {
+    error_ = true;
+    return false;
+  }
+  const int bodyStart = headerEnd + 4;
+  if (buffer_.size() - bodyStart < length) {
+    return false;
+  }
+  outStatus = statusLine[1].toInt();
+  outBody = buffer_.mid(bodyStart, length);
+  buffer_.remove(0, bodyStart + length);
+  return true;
+}
+
+QStringList splitPath(const QString &path) {
+  QStringList segments;
+  for (const auto &part : path.split('/')) {
+    if (!part.isEmpty()) {
+      segments.append(part);
+    }
+  }
+  return segments;
+}
+
+QString endpointName(const QByteArray &method, const QString &path) {
+  auto segments = splitPath(path);
+  if (segments.size() >= 3 && segments[1] == "users") {
+    segments[2] = ":id";
+    if (segments.size() >= 5) {
+      segments[4] = ":itemId";
+    }
+  }
+  return QString("%1 /%2").arg(QString::fromLatin1(method),
+                               segments.join('/'));
+}
+
+}  // namespace server
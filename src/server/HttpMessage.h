@@ -0,0 +1,79 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+namespace server {
+
+// HttpRequest 保存一次已完整解析的 HTTP 请求。
+struct HttpRequest {
+  QByteArray method;
+  QString path;
+  QString query;
+  QByteArray version;
+  QHash<QByteArray, QByteArray> headers;  // 键统一为小写
+  QByteArray body;
+  bool keepAlive = true;
+};
+
+// HttpResponse 描述待发送的应答，序列化时自动补齐长度与连接头。
+struct HttpResponse {
+  int status = 200;
+  QByteArray contentType = "application/json; charset=utf-8";
+  QByteArray body;
+  bool keepAlive = true;
+
+  QByteArray serialize() const;
+  static QByteArray reasonPhrase(int status);
+};
+
+// HttpRequestParser 以增量方式解析字节流，支持同一连接上的流水线请求。
+class HttpRequestParser {
+ public:
+  // 单个请求头与请求体的上限，超出视为非法请求。
+  static constexpr int kMaxHeaderBytes = 64 * 1024;
+  static constexpr int kMaxBodyBytes = 8 * 1024 * 1024;
+
+  // 追加新收到的字节。
+  void feed(const QByteArray &bytes);
+  // 取出下一条完整请求；数据不足时返回 false。
+  bool next(HttpRequest &outRequest);
+  // 解析出错后连接应直接关闭。
+  bool hasError() const { return error_; }
+  // 缓冲区中尚未消费的字节数，便于测试流水线边界。
+  int pendingBytes() const { return buffer_.size(); }
+
+ private:
+  QByteArray buffer_;
+  bool error_ = false;
+};
+
+// HttpResponseParser 供压测客户端解析服务端应答。
+class HttpResponseParser {
+ public:
+  void feed(const QByteArray &bytes);
+  bool next(int &outStatus, QByteArray &outBody);
+  bool hasError() const { return error_; }
+
+ private:
+  QByteArray buffer_;
+  bool error_ = false;
+};
+
+// 按斜杠拆分路径并去掉空段。
+QStringList splitPath(const QString &path);
+
+// 将用户 ID 与条目 ID 折叠为占位符，便于按端点聚合统计，
+// 例如 "GET /api/users/:id/bills"。
+QString endpointName(const QByteArray &method, const QString &path);
+
+}  // namespace server
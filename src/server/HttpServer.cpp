@@ -0,0 +1,107 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "HttpServer.h"
+
+#include <QMetaObject>
+
+#include <algorithm>
+
+namespace server {
+
+// 连接对象随套接字断开而自行销毁。
+HttpConnection::HttpConnection(qintptr socketDescriptor,
+                               const ApiRouter *router, QObject *parent)
+    : QObject(parent), socket_(new QTcpSocket(this)), router_(router) {
+  if (!socket_->setSocketDescriptor(socketDescriptor)) {
+    deleteLater();
+    return;
+  }
+  socket_->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+  connect(socket_, &QTcpSocket::readyRead, this,
+          &HttpConnection::handleReadyRead);
+  connect(socket_, &QTcpSocket::disconnected, this, &QObject::deleteLater);
+}
+
+// 一次读取可能包含多条流水线请求，应答合并后一次写出并保持顺序。
+void HttpConnection::handleReadyRead() {
+  if (closing_) {
+    socket_->readAll();
+    return;
+  }
+  parser_.feed(socket_->readAll());
+
+  QByteArray out;
+  HttpRequest request;
+  while (parser_.next(request)) {
+    const auto response = router_->handle(request);
+    out.append(response.serialize());
+    if (!response.keepAlive) {
+      closing_ = true;
+      break;
+    }
+  }
+  if (!closing_ && parser_.hasError()) {
+    HttpResponse response;
+    response.status = 400;
+    response.body = "{\"error\":\"bad request\"}";
+    response.keepAlive = false;
+    out.append(response.serialize());
+    closing_ = true;
+  }
+
+  if (!out.isEmpty()) {
+    socket_->write(out);
+  }
+  if (closing_) {
+    socket_->disconnectFromHost();
+  }
+}
+
+HttpWorker::HttpWorker(const ApiRouter *router) : router_(router) {}
+
+void HttpWorker::adopt(qintptr socketDescriptor) {
+  new HttpConnection(socketDescriptor, router_, this);
+}
+
+// 工作线程在构造时全部启动，数量至少为 1。
+HttpServer::HttpServer(const ApiRouter *router, int workerCount,
+                       QObject *parent)
+    : QTcpServer(parent) {
+  const int count = std::max(1, workerCount);
+  for (int i = 0; i < count; ++i) {
+    auto *thread = new QThread(this);
+    thread->setObjectName(QString("http-worker-%1").arg(i));
+    auto *worker = new HttpWorker(router);
+    worker->moveToThread(thread);
+    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
+    thread->start();
+    threads_.push_back(thread);
+    workers_.push_back(worker);
+  }
+}
+
+// 析构时先停止监听，再等待工作线程退出。
+HttpServer::~HttpServer() {
+  close();
+  for (auto *thread : threads_) {
+    thread->quit();
+  }
+  for (auto *thread : threads_) {
+    thread->wait();
+  }
+}
+
+// 新连接以轮询方式分配，套接字在目标线程内创建。
+void HttpServer::incomingConnection(qintptr socketDescriptor) {
+  auto *worker = workers_[nextWorker_];
+  nextWorker_ = (nextWorker_ + 1) % workers_.size();
+  QMetaObject::invokeMethod(
+      worker, [worker, socketDescriptor] { worker->adopt(socketDescriptor); },
+      Qt::QueuedConnection);
+}
+
+}  // namespace server
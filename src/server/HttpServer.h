@@ -0,0 +1,65 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QObject>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QVector>
+
+#include "server/ApiRouter.h"
+#include "server/HttpMessage.h"
+
+namespace server {
+
+// HttpConnection 负责单个长连接：按到达顺序解析并应答流水线请求。
+class HttpConnection : public QObject {
+ public:
+  HttpConnection(qintptr socketDescriptor, const ApiRouter *router,
+                 QObject *parent = nullptr);
+
+ private:
+  void handleReadyRead();
+
+  QTcpSocket *socket_ = nullptr;
+  HttpRequestParser parser_;
+  const ApiRouter *router_ = nullptr;
+  bool closing_ = false;
+};
+
+// HttpWorker 运行在独立线程的事件循环中，托管分配给它的连接。
+class HttpWorker : public QObject {
+ public:
+  explicit HttpWorker(const ApiRouter *router);
+
+  // 必须在工作线程内调用，接管已接受的套接字。
+  void adopt(qintptr socketDescriptor);
+
+ private:
+  const ApiRouter *router_ = nullptr;
+};
+
+// HttpServer 在主线程接受连接，并轮询分发给固定数量的工作线程。
+class HttpServer : public QTcpServer {
+ public:
+  HttpServer(const ApiRouter *router, int workerCount,
+             QObject *parent = nullptr);
+  ~HttpServer() override;
+
+  int workerCount() const { return workers_.size(); }
+
+ protected:
+  void incomingConnection(qintptr socketDescriptor) override;
+
+ private:
+  QVector<QThread *> threads_;
+  QVector<HttpWorker *> workers_;
+  int nextWorker_ = 0;
+};
+
+}  // namespace server
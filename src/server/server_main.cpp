@@ -0,0 +1,145 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDate>
+#include <QDir>
+#include <QHostAddress>
+#include <QTextStream>
+#include <QThread>
+
+#include "core/LedgerService.h"
+#include "server/ApiRouter.h"
+#include "server/HttpServer.h"
+
+namespace {
+
+double kib(qint64 bytes) { return bytes / 1024.0; }
+
+// 打印每个用户的内存估算与磁盘占用（KiB），按内存降序。
+void printMemoryReport(const core::LedgerService &service, QTextStream &out) {
+  const auto footprints = service.footprints();
+  out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9\n")
+             .arg("user", -38)
+             .arg("memory", 10)
+             .arg("bills", 10)
+             .arg("notes", 10)
+             .arg("posts", 10)
+             .arg("comments", 10)
+             .arg("other", 10)
+             .arg("search", 10)
+             .arg("disk", 10);
+  qint64 memory = 0;
+  qint64 disk = 0;
+  for (const auto &footprint : footprints) {
+    const auto &m = footprint.memory;
+    out << QString("%1 %2 %3 %4 %5 %6 %7 %8 %9\n")
+               .arg(footprint.userId, -38)
+               .arg(kib(m.total()), 10, 'f', 1)
+               .arg(kib(m.bills), 10, 'f', 1)
+               .arg(kib(m.notes), 10, 'f', 1)
+               .arg(kib(m.posts), 10, 'f', 1)
+               .arg(kib(m.comments), 10, 'f', 1)
+               .arg(kib(m.other), 10, 'f', 1)
+               .arg(kib(m.search), 10, 'f', 1)
+               .arg(kib(footprint.diskBytes), 10, 'f', 1);
+    memory += m.total();
+    disk += footprint.diskBytes;
+  }
+  out << QString("%1 users, memory %2 KiB, disk %3 KiB\n")
+             .arg(footprints.size())
+             .arg(kib(memory), 0, 'f', 1)
+             .arg(kib(disk), 0, 'f', 1);
+}
+
+}  // namespace
+
+// 服务端入口：单进程托管多用户，通过本地 HTTP/JSON 暴露 LedgerService。
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setOrganizationName("BookeeperLab");
+  QCoreApplication::setApplicationName("Bookeeper");
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Bookeeper HTTP/JSON server");
+  parser.addHelpOption();
+  QCommandLineOption hostOption("host", "监听地址（仅限本机回环地址）",
+                                "address", "127.0.0.1");
+  QCommandLineOption portOption("port", "监听端口", "port", "8080");
+  QCommandLineOption workersOption(
+      "workers", "工作线程数量", "count",
+      QString::number(QThread::idealThreadCount()));
+  QCommandLineOption dataDirOption("data-dir", "数据目录", "path");
+  QCommandLineOption noFsyncOption("no-fsync",
+                                   "只 flush 不 fsync（掉电可能丢失最近提交）");
+  QCommandLineOption groupWindowOption(
+      "group-window-us", "组提交攒批等待时间（微秒）", "micros", "0");
+  parser.addOption(hostOption);
+  parser.addOption(portOption);
+  parser.addOption(workersOption);
+  parser.addOption(dataDirOption);
+  parser.addOption(noFsyncOption);
+  QCommandLineOption memoryBudgetOption(
+      "memory-budget-mb", "快照缓存内存预算（MiB），0 表示不限", "mib", "0");
+  QCommandLineOption memoryReportOption(
+      "memory-report", "打印各用户的内存与磁盘占用后退出");
+  QCommandLineOption archiveOption(
+      "archive-after-months",
+      "启动时把早于该月数的账单移入压缩归档，0 表示不归档", "months", "0");
+  parser.addOption(groupWindowOption);
+  parser.addOption(memoryBudgetOption);
+  parser.addOption(memoryReportOption);
+  parser.addOption(archiveOption);
+  parser.process(app);
+
+  // 令牌经明文 HTTP 传输，只允许监听本机地址。
+  const QHostAddress address(parser.value(hostOption));
+  if (!address.isLoopback()) {
+    QTextStream(stderr) << "只允许监听本机回环地址，拒绝 "
+                        << parser.value(hostOption) << "\n";
+    return 1;
+  }
+
+  QTextStream out(stdout);
+  const QDir dataDir = parser.isSet(dataDirOption)
+                           ? QDir(parser.value(dataDirOption))
+                           : core::JsonStorage::defaultDataDir();
+  core::DurabilityOptions durability;
+  durability.fsync = !parser.isSet(noFsyncOption);
+  durability.groupWindowMicros = parser.value(groupWindowOption).toInt();
+  core::LedgerService service(dataDir, durability);
+  if (parser.isSet(memoryReportOption)) {
+    printMemoryReport(service, out);
+    return 0;
+  }
+  service.setMemoryBudget(parser.value(memoryBudgetOption).toLongLong() *
+                          1024 * 1024);
+  // 按整月归档：早于“当前月往前若干个月的 1 日”的账单移入归档。
+  const int archiveMonths = parser.value(archiveOption).toInt();
+  if (archiveMonths > 0) {
+    const QDate today = QDate::currentDate();
+    const QDate before =
+        QDate(today.year(), today.month(), 1).addMonths(-archiveMonths);
+    out << "archived " << service.archiveColdBills(before)
+        << " bills dated before " << before.toString(Qt::ISODate) << "\n";
+  }
+  server::ApiRouter router(&service);
+  server::HttpServer httpServer(&router,
+                                parser.value(workersOption).toInt());
+
+  const auto port = static_cast<quint16>(parser.value(portOption).toUInt());
+  if (!httpServer.listen(address, port)) {
+    QTextStream(stderr) << "无法监听 " << address.toString() << ":" << port
+                        << " - " << httpServer.errorString() << "\n";
+    return 1;
+  }
+  out << "bookeeper_server listening on " << address.toString() << ":"
+      << httpServer.serverPort() << " with " << httpServer.workerCount()
+      << " workers, data dir " << dataDir.absolutePath() << "\n";
+  out.flush();
+  return app.exec();
+}
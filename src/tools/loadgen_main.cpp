@@ -0,0 +1,270 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <QPair>
+#include <QTcpSocket>
+#include <QTextStream>
+#include <QThread>
+#include <QUuid>
+#include <QVector>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+#include "server/HttpMessage.h"
+
+// 压测客户端：每个连接独占一个线程，按固定比例混合调用各端点，
+// 支持流水线深度配置，最后输出吞吐与每个端点的 p50/p99 延迟。
+
+namespace {
+
+struct LoadOptions {
+  QString host;
+  quint16 port = 8080;
+  int requests = 1000;
+  int pipeline = 1;
+};
+
+// 单个连接线程的采样结果，键为端点名称，值为微秒级延迟。
+struct ConnectionResult {
+  QHash<QString, QVector<qint64>> latencies;
+  int errors = 0;
+  QString failure;
+};
+
+// 构造一条带 JSON 正文的请求报文，token 非空时附带认证头。
+QByteArray buildRequest(const QByteArray &method, const QString &path,
+                        const QJsonObject &body = {},
+                        const QByteArray &token = {}) {
+  const QByteArray payload =
+      body.isEmpty() ? QByteArray()
+                     : QJsonDocument(body).toJson(QJsonDocument::Compact);
+  QByteArray out;
+  out.append(method);
+  out.append(' ');
+  out.append(path.toUtf8());
+  out.append(" HTTP/1.1\r\nHost: localhost\r\n");
+  if (!token.isEmpty()) {
+    out.append("Authorization: Bearer " + token + "\r\n");
+  }
+  out.append("Content-Type: application/json\r\nContent-Length: ");
+  out.append(QByteArray::number(payload.size()));
+  out.append("\r\n\r\n");
+  out.append(payload);
+  return out;
+}
+
+// 阻塞读取下一条应答，超时视为失败。
+bool readResponse(QTcpSocket &socket, server::HttpResponseParser &parser,
+                  int &status, QByteArray &body) {
+  while (!parser.next(status, body)) {
+    if (parser.hasError() || !socket.waitForReadyRead(10000)) {
+      return false;
+    }
+    parser.feed(socket.readAll());
+  }
+  return true;
+}
+
+// 同步发送单条请求并等待应答，用于压测前的准备阶段。
+bool roundTrip(QTcpSocket &socket, server::HttpResponseParser &parser,
+               const QByteArray &request, QJsonDocument &outDoc) {
+  socket.write(request);
+  int status = 0;
+  QByteArray body;
+  if (!readResponse(socket, parser, status, body) || status != 200) {
+    return false;
+  }
+  outDoc = QJsonDocument::fromJson(body);
+  return true;
+}
+
+// 单个连接的完整压测流程：注册独立用户、取分类、按比例发请求。
+ConnectionResult runConnection(const LoadOptions &options, int index) {
+  ConnectionResult result;
+  QTcpSocket socket;
+  socket.connectToHost(options.host, options.port);
+  if (!socket.waitForConnected(5000)) {
+    result.failure = socket.errorString();
+    return result;
+  }
+  socket.setSocketOption(QAbstractSocket::LowDelayOption, 1);
+  server::HttpResponseParser parser;
+
+  const auto tag = QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QJsonObject registerBody;
+  registerBody["username"] = QString("load-%1-%2").arg(index).arg(tag);
+  registerBody["email"] = QString("load-%1-%2@example.com").arg(index).arg(tag);
+  registerBody["password"] = "load";
+  QJsonDocument doc;
+  if (!roundTrip(socket, parser,
+                 buildRequest("POST", "/api/register", registerBody), doc)) {
+    result.failure = "注册压测用户失败";
+    return result;
+  }
+  const auto userPath =
+      QString("/api/users/%1").arg(doc.object().value("userId").toString());
+  const auto token = doc.object().value("token").toString().toLatin1();
+  if (!roundTrip(socket, parser,
+                 buildRequest("GET", userPath + "/categories", {}, token),
+                 doc) ||
+      doc.array().isEmpty()) {
+    result.failure = "读取分类失败";
+    return result;
+  }
+  const auto categoryId =
+      doc.array().first().toObject().value("id").toString();
+
+  // 请求混合：写账单、读账单、分类汇总、分类列表、时间线。
+  const QVector<QPair<QByteArray, QString>> mix = {
+      {"POST", userPath + "/bills"},
+      {"GET", userPath + "/bills"},
+      {"GET", userPath + "/summary"},
+      {"GET", userPath + "/categories"},
+      {"GET", userPath + "/timeline"}};
+
+  QVector<QPair<QString, qint64>> inFlight;
+  QElapsedTimer clock;
+  clock.start();
+  int sent = 0;
+  while (sent < options.requests) {
+    const int batch = std::min(options.pipeline, options.requests - sent);
+    QByteArray payload;
+    inFlight.clear();
+    for (int i = 0; i < batch; ++i, ++sent) {
+      const auto &entry = mix[sent % mix.size()];
+      QJsonObject body;
+      if (entry.first == "POST") {
+        body["categoryId"] = categoryId;
+        body["amount"] = 1.0 + (sent % 100);
+        body["note"] = QString("load %1").arg(sent);
+        body["type"] = "expense";
+      }
+      payload.append(buildRequest(entry.first, entry.second, body, token));
+      inFlight.push_back(
+          {server::endpointName(entry.first, entry.second), 0});
+    }
+    const qint64 sendTime = clock.nsecsElapsed();
+    socket.write(payload);
+    for (auto &pending : inFlight) {
+      int status = 0;
+      QByteArray body;
+      if (!readResponse(socket, parser, status, body)) {
+        result.failure = "读取应答超时";
+        return result;
+      }
+      if (status != 200) {
+        ++result.errors;
+      }
+      result.latencies[pending.first].push_back(
+          (clock.nsecsElapsed() - sendTime) / 1000);
+    }
+  }
+  socket.disconnectFromHost();
+  return result;
+}
+
+// 计算已排序样本的百分位数（最近秩法）。
+double percentileMs(const QVector<qint64> &sorted, double p) {
+  if (sorted.isEmpty()) {
+    return 0.0;
+  }
+  const int rank = static_cast<int>(std::ceil(p * sorted.size())) - 1;
+  return sorted[std::max(0, rank)] / 1000.0;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Bookeeper server load generator");
+  parser.addHelpOption();
+  QCommandLineOption hostOption("host", "服务端地址", "address", "127.0.0.1");
+  QCommandLineOption portOption("port", "服务端端口", "port", "8080");
+  QCommandLineOption connectionsOption("connections", "并发连接数", "count",
+                                       "8");
+  QCommandLineOption requestsOption("requests", "每个连接的请求数", "count",
+                                    "1000");
+  QCommandLineOption pipelineOption("pipeline", "流水线深度", "depth", "1");
+  parser.addOption(hostOption);
+  parser.addOption(portOption);
+  parser.addOption(connectionsOption);
+  parser.addOption(requestsOption);
+  parser.addOption(pipelineOption);
+  parser.process(app);
+
+  LoadOptions options;
+  options.host = parser.value(hostOption);
+  options.port = static_cast<quint16>(parser.value(portOption).toUInt());
+  options.requests = std::max(1, parser.value(requestsOption).toInt());
+  options.pipeline = std::max(1, parser.value(pipelineOption).toInt());
+  const int connections = std::max(1, parser.value(connectionsOption).toInt());
+
+  std::vector<ConnectionResult> results(connections);
+  std::vector<std::unique_ptr<QThread>> threads;
+  QElapsedTimer wall;
+  wall.start();
+  for (int i = 0; i < connections; ++i) {
+    threads.emplace_back(QThread::create(
+        [&options, &results, i] { results[i] = runConnection(options, i); }));
+    threads.back()->start();
+  }
+  for (auto &thread : threads) {
+    thread->wait();
+  }
+  const double seconds = wall.nsecsElapsed() / 1e9;
+
+  QMap<QString, QVector<qint64>> merged;
+  int errors = 0;
+  QTextStream out(stdout);
+  for (const auto &result : results) {
+    if (!result.failure.isEmpty()) {
+      out << "connection failed: " << result.failure << "\n";
+    }
+    errors += result.errors;
+    for (auto it = result.latencies.constBegin();
+         it != result.latencies.constEnd(); ++it) {
+      merged[it.key()] += it.value();
+    }
+  }
+
+  qint64 total = 0;
+  out << QString("%1 %2 %3 %4 %5\n")
+             .arg(QStringLiteral("endpoint"), -36)
+             .arg(QStringLiteral("count"), 8)
+             .arg(QStringLiteral("req/s"), 10)
+             .arg(QStringLiteral("p50(ms)"), 10)
+             .arg(QStringLiteral("p99(ms)"), 10);
+  for (auto it = merged.begin(); it != merged.end(); ++it) {
+    auto &samples = it.value();
+    std::sort(samples.begin(), samples.end());
+    total += samples.size();
+    out << QString("%1 %2 %3 %4 %5\n")
+               .arg(it.key(), -36)
+               .arg(samples.size(), 8)
+               .arg(samples.size() / seconds, 10, 'f', 1)
+               .arg(percentileMs(samples, 0.50), 10, 'f', 3)
+               .arg(percentileMs(samples, 0.99), 10, 'f', 3);
+  }
+  out << QString("total %1 requests in %2 s, %3 req/s, %4 non-200\n")
+             .arg(total)
+             .arg(seconds, 0, 'f', 2)
+             .arg(total / seconds, 0, 'f', 1)
+             .arg(errors);
+  return 0;
+}
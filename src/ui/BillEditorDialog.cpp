@@ -60,11 +60,11 @@ void BillEditorDialog::buildUi() {
 
 // 刷新分类下拉框，必要时定位默认选项。
 void BillEditorDialog::setCategories(const QVector<core::Category> &categories,
-                                     const QString &selectedId) {
+                                     const core::EntityId &selectedId) {
   categoryCombo_->clear();
   int selectedIndex = -1;
   for (int i = 0; i < categories.size(); ++i) {
-    categoryCombo_->addItem(categories[i].name, categories[i].id);
+    categoryCombo_->addItem(categories[i].name, categories[i].id.toString());
     if (!selectedId.isEmpty() && categories[i].id == selectedId) {
       selectedIndex = i;
     }
@@ -79,7 +79,8 @@ void BillEditorDialog::setBill(const core::Bill &bill) {
   bill_ = bill;
   amountSpin_->setValue(bill.amount);
   typeCombo_->setCurrentIndex(bill.type == core::BillType::Expense ? 0 : 1);
-  categoryCombo_->setCurrentIndex(categoryCombo_->findData(bill.categoryId));
+  categoryCombo_->setCurrentIndex(
+      categoryCombo_->findData(bill.categoryId.toString()));
   timeEdit_->setDateTime(
       bill.timestamp.isValid() ? bill.timestamp : QDateTime::currentDateTime());
   noteEdit_->setPlainText(bill.note);
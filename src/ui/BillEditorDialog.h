@@ -25,7 +25,7 @@ class BillEditorDialog : public QDialog {
   explicit BillEditorDialog(QWidget *parent = nullptr);
 
   void setCategories(const QVector<core::Category> &categories,
-                     const QString &selectedId = QString());
+                     const core::EntityId &selectedId = core::EntityId());
   void setBill(const core::Bill &bill);
   core::Bill bill() const;
 
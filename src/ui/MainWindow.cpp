@@ -9,6 +9,8 @@
 #include <QAbstractItemView>
 #include <QDate>
 #include <QDateTime>
+#include <QFile>
+#include <QFileDialog>
 #include <QFormLayout>
 #include <QHBoxLayout>
 #include <QHash>
@@ -18,28 +20,56 @@
 #include <QMessageBox>
 #include <QPainter>
 #include <QPushButton>
+#include <QSignalBlocker>
 #include <QSplitter>
 #include <QTimer>
 #include <QVBoxLayout>
 #include <QVariantMap>
 #include <QtCharts>
+#include <QtConcurrent>
 
 #include <algorithm>
 
+#include "core/Downsampler.h"
+
 namespace ui {
 
-// 构造器初始化主界面并立即加载业务数据。
+namespace {
+
+// 首屏绘制后再开始预取，之后每个空闲周期加载一页。
+constexpr int kPrefetchDelayMs = 200;
+// 该时间窗口内的多次变更合并为一次仪表盘刷新。
+constexpr int kDashboardCoalesceMs = 50;
+// 趋势图降采样的最少点数，窗口尚未布局时绘图区宽度为 0。
+constexpr int kMinTrendPoints = 100;
+// 没有支出时的占位切片。
+const char *const kEmptyPieLabel = "暂无线下支出";
+
+}  // namespace
+
+// 构造器只加载首屏可见的页面，其余页面在空闲时后台预取。
 MainWindow::MainWindow(core::LedgerService *service,
                        const core::UserProfile &profile, QWidget *parent)
     : QMainWindow(parent), service_(service), profile_(profile) {
   setWindowTitle(QString("Bookeeper - %1").arg(profile.username));
   resize(1080, 720);
+
+  prefetchTimer_ = new QTimer(this);
+  prefetchTimer_->setSingleShot(true);
+  connect(prefetchTimer_, &QTimer::timeout, this,
+          &MainWindow::prefetchNextPage);
+  dashboardTimer_ = new QTimer(this);
+  dashboardTimer_->setSingleShot(true);
+  dashboardTimer_->setInterval(kDashboardCoalesceMs);
+  connect(dashboardTimer_, &QTimer::timeout, this,
+          &MainWindow::refreshDashboard);
+  timelineWatcher_ = new QFutureWatcher<TimelineModel::Page>(this);
+  connect(timelineWatcher_, &QFutureWatcherBase::finished, this,
+          &MainWindow::showTimeline);
+
   buildUi();
-  refreshDashboard();
-  refreshBills();
-  refreshCategories();
-  refreshReminders();
-  refreshTimeline();
+  ensurePageLoaded(stacked_->currentIndex());
+  prefetchTimer_->start(kPrefetchDelayMs);
 
   reminderTimer_ = new QTimer(this);
   reminderTimer_->setInterval(60 * 1000);
@@ -51,6 +81,9 @@ MainWindow::MainWindow(core::LedgerService *service,
   refreshReminderNotifications();
 }
 
+// 后台任务引用服务对象，析构前等待其结束。
+MainWindow::~MainWindow() { timelineWatcher_->waitForFinished(); }
+
 // 构建左侧导航与右侧堆叠页面。
 void MainWindow::buildUi() {
   auto *central = new QWidget(this);
@@ -97,13 +130,90 @@ void MainWindow::setupDashboardPage() {
   layout->addWidget(totalIncomeLabel_);
   layout->addWidget(totalExpenseLabel_);
 
-  pieChartView_ = new QtCharts::QChartView(dashboardPage_);
+  pieSeries_ = new QtCharts::QPieSeries();
+  auto *pieChart = new QtCharts::QChart();
+  pieChart->addSeries(pieSeries_);
+  pieChart->setTitle("分类支出占比");
+  pieChart->legend()->setAlignment(Qt::AlignRight);
+  pieChartView_ = new QtCharts::QChartView(pieChart, dashboardPage_);
   pieChartView_->setRenderHint(QPainter::Antialiasing);
   layout->addWidget(pieChartView_, 1);
 
-  barChartView_ = new QtCharts::QChartView(dashboardPage_);
+  // 趋势图的时间粒度，数据均来自服务层的日历汇总表。
+  trendPeriodCombo_ = new QComboBox(dashboardPage_);
+  trendPeriodCombo_->addItem("近7天",
+                             static_cast<int>(core::RollupPeriod::Day));
+  trendPeriodCombo_->addItem("近12周",
+                             static_cast<int>(core::RollupPeriod::Week));
+  trendPeriodCombo_->addItem("近12个月",
+                             static_cast<int>(core::RollupPeriod::Month));
+  trendPeriodCombo_->addItem("近5年",
+                             static_cast<int>(core::RollupPeriod::Year));
+  layout->addWidget(trendPeriodCombo_, 0, Qt::AlignRight);
+  connect(trendPeriodCombo_,
+          QOverload<int>::of(&QComboBox::currentIndexChanged), this,
+          [this](int) { dashboardTimer_->start(); });
+
+  barSet_ = new QtCharts::QBarSet("支出");
+  auto *barSeries = new QtCharts::QBarSeries();
+  barSeries->append(barSet_);
+  barChart_ = new QtCharts::QChart();
+  barChart_->addSeries(barSeries);
+  barAxisX_ = new QtCharts::QBarCategoryAxis();
+  barChart_->addAxis(barAxisX_, Qt::AlignBottom);
+  barSeries->attachAxis(barAxisX_);
+  barAxisY_ = new QtCharts::QValueAxis();
+  barAxisY_->setLabelFormat("%.2f");
+  barChart_->addAxis(barAxisY_, Qt::AlignLeft);
+  barSeries->attachAxis(barAxisY_);
+  barChartView_ = new QtCharts::QChartView(barChart_, dashboardPage_);
   barChartView_->setRenderHint(QPainter::Antialiasing);
   layout->addWidget(barChartView_, 1);
+
+  // 长区间趋势：选择起止日期，或在图上框选缩放、右键缩小。
+  auto *trendRow = new QHBoxLayout();
+  trendFromEdit_ = new QDateEdit(QDate::currentDate().addYears(-1),
+                                 dashboardPage_);
+  trendToEdit_ = new QDateEdit(QDate::currentDate(), dashboardPage_);
+  trendFromEdit_->setCalendarPopup(true);
+  trendToEdit_->setCalendarPopup(true);
+  trendFromEdit_->setDisplayFormat("yyyy-MM-dd");
+  trendToEdit_->setDisplayFormat("yyyy-MM-dd");
+  auto *trendResetBtn = new QPushButton("全部", dashboardPage_);
+  trendRow->addWidget(new QLabel("每日支出趋势", dashboardPage_));
+  trendRow->addStretch();
+  trendRow->addWidget(trendFromEdit_);
+  trendRow->addWidget(new QLabel("至", dashboardPage_));
+  trendRow->addWidget(trendToEdit_);
+  trendRow->addWidget(trendResetBtn);
+  layout->addLayout(trendRow);
+
+  trendSeries_ = new QtCharts::QLineSeries();
+  trendSeries_->setName("支出");
+  auto *trendChart = new QtCharts::QChart();
+  trendChart->addSeries(trendSeries_);
+  trendChart->legend()->hide();
+  trendAxisX_ = new QtCharts::QDateTimeAxis();
+  trendChart->addAxis(trendAxisX_, Qt::AlignBottom);
+  trendSeries_->attachAxis(trendAxisX_);
+  trendAxisY_ = new QtCharts::QValueAxis();
+  trendAxisY_->setLabelFormat("%.2f");
+  trendChart->addAxis(trendAxisY_, Qt::AlignLeft);
+  trendSeries_->attachAxis(trendAxisY_);
+  trendView_ = new QtCharts::QChartView(trendChart, dashboardPage_);
+  trendView_->setRenderHint(QPainter::Antialiasing);
+  trendView_->setRubberBand(QtCharts::QChartView::HorizontalRubberBand);
+  layout->addWidget(trendView_, 1);
+
+  connect(trendFromEdit_, &QDateEdit::dateChanged, this,
+          [this](const QDate &) { refreshTrend(); });
+  connect(trendToEdit_, &QDateEdit::dateChanged, this,
+          [this](const QDate &) { refreshTrend(); });
+  connect(trendResetBtn, &QPushButton::clicked, this,
+          &MainWindow::resetTrendRange);
+  // 缩放发生在图表内部的事件处理中，排队后再重新取数。
+  connect(trendAxisX_, &QtCharts::QDateTimeAxis::rangeChanged, this,
+          &MainWindow::handleTrendZoom, Qt::QueuedConnection);
 }
 
 // 账单页面用于列表展示与增删改。
@@ -111,6 +221,22 @@ void MainWindow::setupBillsPage() {
   billsPage_ = new QWidget(stacked_);
   auto *layout = new QVBoxLayout(billsPage_);
 
+  // 输入关键词后回车检索账单备注，清空后恢复全部账单。
+  billSearchEdit_ = new QLineEdit(billsPage_);
+  billSearchEdit_->setPlaceholderText(
+      "搜索备注（不含已归档账单）或输入过滤条件"
+      "（如 amount > 100 and date in this_month）");
+  billSearchEdit_->setClearButtonEnabled(true);
+  layout->addWidget(billSearchEdit_);
+  connect(billSearchEdit_, &QLineEdit::returnPressed, this,
+          &MainWindow::refreshBills);
+  connect(billSearchEdit_, &QLineEdit::textChanged, this,
+          [this](const QString &text) {
+            if (text.isEmpty()) {
+              refreshBills();
+            }
+          });
+
   billTable_ = new QTableWidget(billsPage_);
   billTable_->setColumnCount(5);
   billTable_->setHorizontalHeaderLabels(
@@ -125,9 +251,11 @@ void MainWindow::setupBillsPage() {
   auto *addBtn = new QPushButton("新增", billsPage_);
   auto *editBtn = new QPushButton("编辑", billsPage_);
   auto *deleteBtn = new QPushButton("删除", billsPage_);
+  auto *importBtn = new QPushButton("导入CSV", billsPage_);
   buttonRow->addWidget(addBtn);
   buttonRow->addWidget(editBtn);
   buttonRow->addWidget(deleteBtn);
+  buttonRow->addWidget(importBtn);
   buttonRow->addStretch();
   layout->addLayout(buttonRow);
 
@@ -135,6 +263,8 @@ void MainWindow::setupBillsPage() {
   connect(editBtn, &QPushButton::clicked, this, &MainWindow::handleEditBill);
   connect(deleteBtn, &QPushButton::clicked, this,
           &MainWindow::handleDeleteBill);
+  connect(importBtn, &QPushButton::clicked, this,
+          &MainWindow::handleImportBills);
 }
 
 // 分类页面支持新增与删除自定义分类。
@@ -223,8 +353,14 @@ void MainWindow::setupSocialPage() {
   postRow->addStretch();
   layout->addLayout(postRow);
 
-  timelineList_ = new QListWidget(socialPage_);
-  layout->addWidget(timelineList_, 2);
+  // 行高随内容变化，按项目滚动；模型在滚动到底时追加下一页。
+  timelineModel_ = new TimelineModel(service_, profile_.id, this);
+  timelineView_ = new QListView(socialPage_);
+  timelineView_->setModel(timelineModel_);
+  timelineView_->setWordWrap(true);
+  timelineView_->setAlternatingRowColors(true);
+  timelineView_->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+  layout->addWidget(timelineView_, 2);
 
   connect(publishBtn, &QPushButton::clicked, this,
           &MainWindow::handlePublishPost);
@@ -232,12 +368,84 @@ void MainWindow::setupSocialPage() {
           &MainWindow::handleRefreshTimeline);
   connect(friendBtn, &QPushButton::clicked, this, &MainWindow::handleAddFriend);
   connect(commentBtn, &QPushButton::clicked, this, &MainWindow::handleComment);
+  connect(timelineView_, &QListView::doubleClicked, this,
+          &MainWindow::handleTimelineActivated);
 }
 
-// 切换堆叠页面索引。
+// 切换堆叠页面索引，尚未加载或已过期的页面在此时加载。
 void MainWindow::handleNavigation(int row) {
   if (row >= 0 && row < stacked_->count()) {
     stacked_->setCurrentIndex(row);
+    ensurePageLoaded(row);
+  }
+}
+
+void MainWindow::ensurePageLoaded(int page) {
+  if (page >= 0 && page < kPageCount && pageDirty_[page]) {
+    loadPage(page);
+  }
+}
+
+// 可见页立即重载；不可见页只标脏，留给空闲预取或下次切换。
+void MainWindow::invalidatePage(Page page) {
+  pageDirty_[page] = true;
+  if (stacked_->currentIndex() == page) {
+    if (page == kDashboardPage) {
+      // 计时器运行期间的后续变更并入同一次刷新。
+      if (!dashboardTimer_->isActive()) {
+        dashboardTimer_->start();
+      }
+    } else {
+      loadPage(page);
+    }
+    return;
+  }
+  if (page == kSocialPage && timelineWatcher_->isRunning()) {
+    timelineReloadPending_ = true;
+  }
+  schedulePrefetch();
+}
+
+void MainWindow::loadPage(int page) {
+  switch (page) {
+    case kDashboardPage:
+      refreshDashboard();
+      break;
+    case kBillsPage:
+      refreshBills();
+      break;
+    case kCategoryPage:
+      refreshCategories();
+      break;
+    case kReminderPage:
+      refreshReminders();
+      break;
+    case kSocialPage:
+      refreshTimeline();
+      break;
+    default:
+      break;
+  }
+}
+
+void MainWindow::schedulePrefetch() {
+  if (!prefetchTimer_->isActive()) {
+    prefetchTimer_->start(0);
+  }
+}
+
+// 每次只加载一页，避免长时间占用界面线程；时间线在后台线程读取。
+void MainWindow::prefetchNextPage() {
+  for (int page = 0; page < kPageCount; ++page) {
+    if (!pageDirty_[page]) {
+      continue;
+    }
+    if (page == kSocialPage && timelineWatcher_->isRunning()) {
+      continue;
+    }
+    loadPage(page);
+    schedulePrefetch();
+    return;
   }
 }
 
@@ -261,7 +469,7 @@ void MainWindow::handleAddBill() {
       return;
     }
     refreshBills();
-    refreshDashboard();
+    invalidatePage(kDashboardPage);
   }
 }
 
@@ -271,7 +479,7 @@ void MainWindow::handleEditBill() {
   if (selected < 0) {
     return;
   }
-  const auto billId =
+  const core::EntityId billId =
       billTable_->item(selected, 0)->data(Qt::UserRole).toString();
   const auto billsData = service_->bills(profile_.id);
   auto it =
@@ -291,7 +499,7 @@ void MainWindow::handleEditBill() {
       return;
     }
     refreshBills();
-    refreshDashboard();
+    invalidatePage(kDashboardPage);
   }
 }
 
@@ -313,7 +521,37 @@ void MainWindow::handleDeleteBill() {
     return;
   }
   refreshBills();
-  refreshDashboard();
+  invalidatePage(kDashboardPage);
+}
+
+// 从 CSV 文件批量导入账单，完成后汇报导入结果。
+void MainWindow::handleImportBills() {
+  const QString path = QFileDialog::getOpenFileName(
+      this, "导入账单", QString(), "CSV 文件 (*.csv);;所有文件 (*)");
+  if (path.isEmpty()) {
+    return;
+  }
+  QFile file(path);
+  if (!file.open(QIODevice::ReadOnly)) {
+    QMessageBox::warning(this, "失败", "无法打开文件");
+    return;
+  }
+  core::ImportReport report;
+  QString message;
+  if (!service_->importCsv(profile_.id, file, report, message)) {
+    QMessageBox::warning(this, "失败", message);
+    return;
+  }
+  QString summary = QString("新增 %1 条，更新 %2 条，跳过 %3 条")
+                        .arg(report.inserted)
+                        .arg(report.updated)
+                        .arg(report.rejected);
+  if (!report.errors.isEmpty()) {
+    summary += "\n\n" + report.errors.mid(0, 10).join("\n");
+  }
+  QMessageBox::information(this, "导入完成", summary);
+  refreshBills();
+  invalidatePage(kDashboardPage);
 }
 
 // 新增分类时校验名称非空。
@@ -372,7 +610,7 @@ void MainWindow::handleEditReminder() {
   if (!item) {
     return;
   }
-  const auto reminderId = item->data(Qt::UserRole).toString();
+  const core::EntityId reminderId = item->data(Qt::UserRole).toString();
   const auto remindersData = service_->reminders(profile_.id);
   auto it = std::find_if(remindersData.begin(), remindersData.end(),
                          [&](const core::Reminder &reminder) {
@@ -452,13 +690,12 @@ void MainWindow::handleAddFriend() {
 
 // 对选中动态添加评论。
 void MainWindow::handleComment() {
-  const auto *item = timelineList_->currentItem();
-  if (!item) {
+  const QPersistentModelIndex index = timelineView_->currentIndex();
+  if (!index.isValid()) {
     return;
   }
-  const auto payload = item->data(Qt::UserRole).toMap();
-  const auto ownerId = payload.value("ownerId").toString();
-  const auto postId = payload.value("postId").toString();
+  const auto ownerId = index.data(TimelineModel::OwnerIdRole).toString();
+  const auto postId = index.data(TimelineModel::PostIdRole).toString();
   const auto text =
       QInputDialog::getMultiLineText(this, "发表评论", "评论内容");
   if (text.trimmed().isEmpty()) {
@@ -469,103 +706,240 @@ void MainWindow::handleComment() {
     QMessageBox::warning(this, "失败", message);
     return;
   }
-  refreshTimeline();
+  // 评论不改变时间线顺序，只更新这一行，不重新加载整页。
+  timelineModel_->commentAdded(index);
 }
 
-// 更新仪表盘的汇总文本与图表。
+// 双击动态展开或收起评论。
+void MainWindow::handleTimelineActivated(const QModelIndex &index) {
+  timelineModel_->toggleExpanded(index);
+}
+
+// 更新仪表盘的汇总文本，并原地更新常驻图表的数据。
 void MainWindow::refreshDashboard() {
+  pageDirty_[kDashboardPage] = false;
+  dashboardTimer_->stop();
   const auto income = service_->totalIncome(profile_.id);
   const auto expense = service_->totalExpense(profile_.id);
   totalIncomeLabel_->setText(QString("总收入：￥%1").arg(income, 0, 'f', 2));
   totalExpenseLabel_->setText(QString("总支出：￥%1").arg(expense, 0, 'f', 2));
 
-  const auto summaries = service_->summarizeByCategory(profile_.id);
+  updatePieSlices(service_->summarizeByCategory(profile_.id));
+
+  const auto period =
+      static_cast<core::RollupPeriod>(trendPeriodCombo_->currentData().toInt());
+  const QDate today = QDate::currentDate();
+  QDate startDate;
+  QString labelFormat;
+  QString title;
+  switch (period) {
+    case core::RollupPeriod::Day:
+      startDate = today.addDays(-6);
+      labelFormat = "MM-dd";
+      title = "近7天支出";
+      break;
+    case core::RollupPeriod::Week:
+      startDate = today.addDays(-7 * 11);
+      labelFormat = "MM-dd";
+      title = "近12周支出";
+      break;
+    case core::RollupPeriod::Month:
+      startDate = today.addMonths(-11);
+      labelFormat = "yyyy-MM";
+      title = "近12个月支出";
+      break;
+    case core::RollupPeriod::Year:
+      startDate = today.addYears(-4);
+      labelFormat = "yyyy";
+      title = "近5年支出";
+      break;
+  }
+  const auto points =
+      service_->periodSeries(profile_.id, period, startDate, today);
+
+  QStringList bucketLabels;
+  double maxValue = 0.0;
+  for (int i = 0; i < points.size(); ++i) {
+    const double value = points[i].totals.expense;
+    bucketLabels << points[i].start.toString(labelFormat);
+    maxValue = std::max(maxValue, value);
+    if (i < barSet_->count()) {
+      if (barSet_->at(i) != value) {
+        barSet_->replace(i, value);
+      }
+    } else {
+      barSet_->append(value);
+    }
+  }
+  if (barSet_->count() > points.size()) {
+    barSet_->remove(points.size(), barSet_->count() - points.size());
+  }
+  // 只有粒度或日期跨越桶边界时分类标签才会变化。
+  if (barAxisX_->categories() != bucketLabels) {
+    barAxisX_->setCategories(bucketLabels);
+  }
+  if (barChart_->title() != title) {
+    barChart_->setTitle(title);
+  }
+  barAxisY_->setRange(0.0, maxValue > 0.0 ? maxValue * 1.2 : 1.0);
+
+  refreshTrend();
+}
+
+// 区间内每天一个点，数年的数据也只绘制与绘图区像素宽度相当的点数。
+void MainWindow::refreshTrend() {
+  QDate from = trendFromEdit_->date();
+  QDate to = trendToEdit_->date();
+  if (from > to) {
+    std::swap(from, to);
+  }
+  const auto points =
+      service_->periodSeries(profile_.id, core::RollupPeriod::Day, from, to);
+  QVector<QPointF> raw;
+  raw.reserve(points.size());
+  double maxValue = 0.0;
+  for (const auto &point : points) {
+    raw.push_back(QPointF(
+        QDateTime(point.start, QTime(12, 0)).toMSecsSinceEpoch(),
+        point.totals.expense));
+    maxValue = std::max(maxValue, point.totals.expense);
+  }
+  const int width = std::max(
+      kMinTrendPoints,
+      static_cast<int>(trendView_->chart()->plotArea().width()));
+  trendSeries_->replace(core::Downsampler::lttb(raw, width));
+
+  trendAxisX_->setFormat(from.daysTo(to) > 90 ? "yyyy-MM" : "MM-dd");
+  trendAxisX_->setRange(QDateTime(from, QTime(0, 0)),
+                        QDateTime(to, QTime(23, 59, 59)));
+  trendAxisY_->setRange(0.0, maxValue > 0.0 ? maxValue * 1.1 : 1.0);
+}
+
+// 框选或右键缩放后以新的可见区间重新取数，放大时细节随之增加。
+// refreshTrend 自己设置的范围与日期框一致，会在这里直接返回。
+void MainWindow::handleTrendZoom(const QDateTime &min, const QDateTime &max) {
+  if (!min.isValid() || !max.isValid()) {
+    return;
+  }
+  const QDate from = min.date();
+  const QDate to = std::max(from, max.date());
+  if (from == trendFromEdit_->date() && to == trendToEdit_->date()) {
+    return;
+  }
+  {
+    const QSignalBlocker fromBlocker(trendFromEdit_);
+    const QSignalBlocker toBlocker(trendToEdit_);
+    trendFromEdit_->setDate(from);
+    trendToEdit_->setDate(to);
+  }
+  refreshTrend();
+}
 
-  auto *pieSeries = new QtCharts::QPieSeries();
+// 恢复为从最早一笔账单到今天的完整区间。
+void MainWindow::resetTrendRange() {
+  QDate earliest = QDate::currentDate().addYears(-1);
+  const QDate first = service_->earliestBillDate(profile_.id);
+  if (first.isValid() && first < earliest) {
+    earliest = first;
+  }
+  {
+    const QSignalBlocker fromBlocker(trendFromEdit_);
+    const QSignalBlocker toBlocker(trendToEdit_);
+    trendFromEdit_->setDate(earliest);
+    trendToEdit_->setDate(QDate::currentDate());
+  }
+  refreshTrend();
+}
+
+// 按分类名称对齐已有切片：数值变化的就地修改，新增分类追加，消失的分类移除。
+void MainWindow::updatePieSlices(
+    const QVector<core::CategorySummary> &summaries) {
+  QHash<QString, double> expenses;
+  QStringList order;
   for (const auto &summary : summaries) {
     if (summary.expense > 0.0) {
-      pieSeries->append(summary.name, summary.expense);
+      if (!expenses.contains(summary.name)) {
+        order << summary.name;
+      }
+      expenses[summary.name] += summary.expense;
     }
   }
-  if (pieSeries->isEmpty()) {
-    pieSeries->append("暂无线下支出", 1.0);
+  if (expenses.isEmpty()) {
+    expenses.insert(kEmptyPieLabel, 1.0);
+    order << kEmptyPieLabel;
   }
-  auto *pieChart = new QtCharts::QChart();
-  pieChart->addSeries(pieSeries);
-  pieChart->setTitle("分类支出占比");
-  pieChart->legend()->setAlignment(Qt::AlignRight);
-  pieChartView_->setChart(pieChart);
 
-  const auto billsData = service_->bills(profile_.id);
-  const QDate today = QDate::currentDate();
-  const QDate startDate = today.addDays(-6);
-  QVector<double> dailyExpense(7, 0.0);
-  for (const auto &bill : billsData) {
-    if (bill.type != core::BillType::Expense || !bill.timestamp.isValid()) {
-      continue;
-    }
-    const QDate billDate = bill.timestamp.date();
-    if (billDate < startDate || billDate > today) {
+  QHash<QString, QtCharts::QPieSlice *> existing;
+  for (auto *slice : pieSeries_->slices()) {
+    if (!expenses.contains(slice->label())) {
+      pieSeries_->remove(slice);
       continue;
     }
-    const int index = startDate.daysTo(billDate);
-    if (index >= 0 && index < dailyExpense.size()) {
-      dailyExpense[index] += bill.amount;
-    }
-  }
-
-  QStringList dayLabels;
-  auto *dailySet = new QtCharts::QBarSet("支出");
-  for (int i = 0; i < dailyExpense.size(); ++i) {
-    const QDate day = startDate.addDays(i);
-    dayLabels << day.toString("MM-dd");
-    dailySet->append(dailyExpense[i]);
+    existing.insert(slice->label(), slice);
   }
-
-  auto *barSeries = new QtCharts::QBarSeries();
-  barSeries->append(dailySet);
-
-  auto *barChart = new QtCharts::QChart();
-  barChart->addSeries(barSeries);
-  barChart->setTitle("近7天支出");
-  auto *axisX = new QtCharts::QBarCategoryAxis();
-  axisX->append(dayLabels);
-  barChart->addAxis(axisX, Qt::AlignBottom);
-  barSeries->attachAxis(axisX);
-  auto *axisY = new QtCharts::QValueAxis();
-  axisY->setLabelFormat("%.2f");
-  double maxValue = 0.0;
-  for (const auto value : dailyExpense) {
-    if (value > maxValue) {
-      maxValue = value;
+  for (const auto &name : order) {
+    const double value = expenses.value(name);
+    if (auto *slice = existing.value(name)) {
+      if (slice->value() != value) {
+        slice->setValue(value);
+      }
+    } else {
+      pieSeries_->append(name, value);
     }
   }
-  axisY->setRange(0.0, maxValue > 0.0 ? maxValue * 1.2 : 1.0);
-  barChart->addAxis(axisY, Qt::AlignLeft);
-  barSeries->attachAxis(axisY);
-  barChartView_->setChart(barChart);
 }
 
 // 刷新账单表格并按时间降序排列。
 void MainWindow::refreshBills() {
+  pageDirty_[kBillsPage] = false;
   const auto categoriesData = service_->categories(profile_.id);
-  QHash<QString, QString> categoryNames;
+  QHash<core::EntityId, QString> categoryNames;
   for (const auto &category : categoriesData) {
     categoryNames.insert(category.id, category.name);
   }
 
   auto billsData = service_->bills(profile_.id);
-  std::sort(billsData.begin(), billsData.end(),
-            [](const core::Bill &a, const core::Bill &b) {
-              return a.timestamp > b.timestamp;
-            });
+  const QString query = billSearchEdit_->text().trimmed();
+  // 输入先按过滤表达式执行（如 "amount > 100 and date in this_month"），
+  // 无法解析时退回全文检索，结果按相关度排序。
+  core::BillQueryResult filtered;
+  QString queryError;
+  if (query.isEmpty()) {
+    std::sort(billsData.begin(), billsData.end(),
+              [](const core::Bill &a, const core::Bill &b) {
+                return a.timestamp > b.timestamp;
+              });
+  } else if (service_->queryBills(profile_.id, query, filtered, queryError)) {
+    billsData = filtered.bills;
+    std::reverse(billsData.begin(), billsData.end());
+  } else {
+    QHash<core::EntityId, int> billRows;
+    for (int i = 0; i < billsData.size(); ++i) {
+      billRows.insert(billsData[i].id, i);
+    }
+    QVector<core::Bill> matched;
+    for (const auto &hit : service_->search(profile_.id, query, 200)) {
+      const auto it = billRows.constFind(hit.id);
+      if (hit.kind == core::SearchKind::Bill && it != billRows.constEnd()) {
+        matched.push_back(billsData[it.value()]);
+      }
+    }
+    billsData = matched;
+  }
 
+  fillBillTable(billsData, categoryNames);
+}
+
+// 按给定顺序填充账单表格。
+void MainWindow::fillBillTable(
+    const QVector<core::Bill> &billsData,
+    const QHash<core::EntityId, QString> &categoryNames) {
   billTable_->setRowCount(billsData.size());
   for (int row = 0; row < billsData.size(); ++row) {
     const auto &bill = billsData[row];
     auto *timeItem =
         new QTableWidgetItem(bill.timestamp.toString("yyyy-MM-dd HH:mm"));
-    timeItem->setData(Qt::UserRole, bill.id);
+    timeItem->setData(Qt::UserRole, bill.id.toString());
     billTable_->setItem(row, 0, timeItem);
 
     billTable_->setItem(
@@ -584,18 +958,20 @@ void MainWindow::refreshBills() {
 
 // 更新分类列表展示。
 void MainWindow::refreshCategories() {
+  pageDirty_[kCategoryPage] = false;
   categoryList_->clear();
   const auto categoriesData = service_->categories(profile_.id);
   for (const auto &category : categoriesData) {
     auto *item = new QListWidgetItem(QString("%1 (%2)").arg(
         category.name, category.type == "income" ? "收入" : "支出"));
-    item->setData(Qt::UserRole, category.id);
+    item->setData(Qt::UserRole, category.id.toString());
     categoryList_->addItem(item);
   }
 }
 
 // 以时间排序刷新提醒列表。
 void MainWindow::refreshReminders() {
+  pageDirty_[kReminderPage] = false;
   reminderList_->clear();
   auto remindersData = service_->reminders(profile_.id);
   std::sort(remindersData.begin(), remindersData.end(),
@@ -608,36 +984,30 @@ void MainWindow::refreshReminders() {
                     .arg(reminder.enabled ? "启用" : "停用")
                     .arg(reminder.message);
     auto *item = new QListWidgetItem(text);
-    item->setData(Qt::UserRole, reminder.id);
+    item->setData(Qt::UserRole, reminder.id.toString());
     reminderList_->addItem(item);
   }
 }
 
-// 重新生成时间线文本内容。
+// 在后台线程重新读取时间线首页；进行中时只记下需要再加载一次。
 void MainWindow::refreshTimeline() {
-  timelineList_->clear();
-  const auto posts = service_->timeline(profile_.id);
-  for (const auto &post : posts) {
-    const auto profileOpt = service_->profile(post.authorId);
-    const auto authorName = profileOpt ? profileOpt->username : post.authorId;
-    QString text =
-        QString("%1 (%2) [%3]\n%4\n评论:")
-            .arg(authorName, post.visibility == "public" ? "公开" : "好友")
-            .arg(post.createdAt.toLocalTime().toString("yyyy-MM-dd HH:mm"))
-            .arg(post.content);
-    for (const auto &comment : post.comments) {
-      const auto commenter = service_->profile(comment.authorId);
-      text.append(QString("\n - %1: %2")
-                      .arg(commenter ? commenter->username : comment.authorId,
-                           comment.content));
-    }
-    auto *item = new QListWidgetItem(text);
-    QVariantMap payload;
-    payload.insert("postId", post.id);
-    payload.insert("ownerId", post.authorId);
-    item->setData(Qt::UserRole, payload);
-    timelineList_->addItem(item);
+  if (timelineWatcher_->isRunning()) {
+    timelineReloadPending_ = true;
+    return;
+  }
+  timelineWatcher_->setFuture(QtConcurrent::run(&TimelineModel::loadPage,
+                                                service_, profile_.id, 0));
+}
+
+// 后台结果回到界面线程后重置模型；期间数据又有变化则丢弃本次结果重新加载。
+void MainWindow::showTimeline() {
+  if (timelineReloadPending_) {
+    timelineReloadPending_ = false;
+    refreshTimeline();
+    return;
   }
+  pageDirty_[kSocialPage] = false;
+  timelineModel_->resetWith(timelineWatcher_->result());
 }
 
 // 轮询提醒并通过弹窗提示即将到期项目。
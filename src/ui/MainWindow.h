@@ -7,9 +7,12 @@
 #pragma once
 
 #include <QComboBox>
+#include <QDateEdit>
 #include <QDateTime>
+#include <QFutureWatcher>
 #include <QLabel>
 #include <QLineEdit>
+#include <QListView>
 #include <QListWidget>
 #include <QMainWindow>
 #include <QPlainTextEdit>
@@ -17,11 +20,18 @@
 #include <QTableWidget>
 #include <QTimer>
 
+#include <QtCharts/QBarCategoryAxis>
+#include <QtCharts/QBarSet>
 #include <QtCharts/QChartView>
+#include <QtCharts/QDateTimeAxis>
+#include <QtCharts/QLineSeries>
+#include <QtCharts/QPieSeries>
+#include <QtCharts/QValueAxis>
 
 #include "core/LedgerService.h"
 #include "ui/BillEditorDialog.h"
 #include "ui/ReminderDialog.h"
+#include "ui/TimelineModel.h"
 
 namespace ui {
 
@@ -32,12 +42,14 @@ class MainWindow : public QMainWindow {
  public:
   MainWindow(core::LedgerService *service, const core::UserProfile &profile,
              QWidget *parent = nullptr);
+  ~MainWindow() override;
 
  private slots:
   void handleNavigation(int row);
   void handleAddBill();
   void handleEditBill();
   void handleDeleteBill();
+  void handleImportBills();
   void handleAddCategory();
   void handleDeleteCategory();
   void handleAddReminder();
@@ -49,6 +61,16 @@ class MainWindow : public QMainWindow {
   void handleComment();
 
  private:
+  // 页面序号与导航列表、堆叠窗口中的顺序一致。
+  enum Page {
+    kDashboardPage = 0,
+    kBillsPage,
+    kCategoryPage,
+    kReminderPage,
+    kSocialPage,
+    kPageCount
+  };
+
   void buildUi();
   void setupDashboardPage();
   void setupBillsPage();
@@ -56,11 +78,29 @@ class MainWindow : public QMainWindow {
   void setupReminderPage();
   void setupSocialPage();
 
+  // 页面按需加载：首次显示时才读取数据，数据变化只标脏，
+  // 可见页立即重载，其余页在空闲时预取或下次切换时加载。
+  void ensurePageLoaded(int page);
+  void invalidatePage(Page page);
+  void loadPage(int page);
+  void schedulePrefetch();
+  void prefetchNextPage();
+
   void refreshDashboard();
+  void updatePieSlices(const QVector<core::CategorySummary> &summaries);
+  // 趋势图：任意日期区间的逐日支出，按绘图区宽度降采样后绘制。
+  void refreshTrend();
+  void handleTrendZoom(const QDateTime &min, const QDateTime &max);
+  void resetTrendRange();
   void refreshBills();
+  void fillBillTable(const QVector<core::Bill> &billsData,
+                     const QHash<core::EntityId, QString> &categoryNames);
   void refreshCategories();
   void refreshReminders();
+  // 时间线需要读取好友的数据文件，首页在后台线程读取再交给模型。
   void refreshTimeline();
+  void showTimeline();
+  void handleTimelineActivated(const QModelIndex &index);
   void refreshReminderNotifications();
 
   core::LedgerService *service_ = nullptr;
@@ -79,8 +119,24 @@ class MainWindow : public QMainWindow {
   QLabel *totalExpenseLabel_ = nullptr;
   QtCharts::QChartView *pieChartView_ = nullptr;
   QtCharts::QChartView *barChartView_ = nullptr;
+  QComboBox *trendPeriodCombo_ = nullptr;
+  // 图表对象常驻，刷新时只原地更新切片、柱值与坐标轴。
+  QtCharts::QPieSeries *pieSeries_ = nullptr;
+  QtCharts::QChart *barChart_ = nullptr;
+  QtCharts::QBarSet *barSet_ = nullptr;
+  QtCharts::QBarCategoryAxis *barAxisX_ = nullptr;
+  QtCharts::QValueAxis *barAxisY_ = nullptr;
+  QDateEdit *trendFromEdit_ = nullptr;
+  QDateEdit *trendToEdit_ = nullptr;
+  QtCharts::QChartView *trendView_ = nullptr;
+  QtCharts::QLineSeries *trendSeries_ = nullptr;
+  QtCharts::QDateTimeAxis *trendAxisX_ = nullptr;
+  QtCharts::QValueAxis *trendAxisY_ = nullptr;
+  // 连续多次变更只触发一次仪表盘重绘。
+  QTimer *dashboardTimer_ = nullptr;
 
   QTableWidget *billTable_ = nullptr;
+  QLineEdit *billSearchEdit_ = nullptr;
 
   QListWidget *categoryList_ = nullptr;
   QLineEdit *categoryNameEdit_ = nullptr;
@@ -90,9 +146,16 @@ class MainWindow : public QMainWindow {
 
   QPlainTextEdit *postEdit_ = nullptr;
   QComboBox *visibilityCombo_ = nullptr;
-  QListWidget *timelineList_ = nullptr;
+  QListView *timelineView_ = nullptr;
+  TimelineModel *timelineModel_ = nullptr;
   QLineEdit *friendEdit_ = nullptr;
 
+  bool pageDirty_[kPageCount] = {true, true, true, true, true};
+  QTimer *prefetchTimer_ = nullptr;
+  QFutureWatcher<TimelineModel::Page> *timelineWatcher_ = nullptr;
+  // 加载进行中又有新的刷新请求时，结束后再加载一次。
+  bool timelineReloadPending_ = false;
+
   QTimer *reminderTimer_ = nullptr;
   QDateTime lastReminderCheck_;
 };
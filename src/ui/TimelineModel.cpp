@@ -0,0 +1,221 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#include "TimelineModel.h"
+
+#include <QtConcurrent>
+
+namespace ui {
+
+TimelineModel::TimelineModel(core::LedgerService *service,
+                             const QString &viewerId, QObject *parent)
+    : QAbstractListModel(parent), service_(service), viewerId_(viewerId) {
+  pageWatcher_ = new QFutureWatcher<Page>(this);
+  connect(pageWatcher_, &QFutureWatcherBase::finished, this,
+          &TimelineModel::appendPage);
+}
+
+TimelineModel::~TimelineModel() { pageWatcher_->waitForFinished(); }
+
+TimelineModel::Page TimelineModel::loadPage(core::LedgerService *service,
+                                            const QString &viewerId,
+                                            int offset) {
+  Page page;
+  page.posts =
+      service->timelinePage(viewerId, offset, kPageSize, &page.total);
+  QVector<core::EntityId> authors;
+  authors.reserve(page.posts.size());
+  for (const auto &post : page.posts) {
+    authors.push_back(post.authorId);
+  }
+  resolveNames(service, authors, page.names);
+  return page;
+}
+
+void TimelineModel::resetWith(const Page &firstPage) {
+  beginResetModel();
+  ++generation_;
+  rows_.clear();
+  loadedIds_.clear();
+  // 作者可能改过用户名，重新加载时一并刷新。
+  names_ = firstPage.names;
+  total_ = firstPage.total;
+  for (const auto &post : firstPage.posts) {
+    if (!loadedIds_.contains(post.id)) {
+      loadedIds_.insert(post.id);
+      rows_.push_back({post, false});
+    }
+  }
+  endResetModel();
+}
+
+// 行高随展开状态变化，通知布局变化让视图重新计算尺寸。
+void TimelineModel::toggleExpanded(const QModelIndex &index) {
+  if (!index.isValid() || index.row() >= rows_.size()) {
+    return;
+  }
+  emit layoutAboutToBeChanged();
+  auto &row = rows_[index.row()];
+  row.expanded = !row.expanded;
+  if (row.expanded) {
+    loadComments(row);
+  } else {
+    row.post.comments.clear();
+    row.post.comments.squeeze();
+  }
+  emit layoutChanged();
+}
+
+void TimelineModel::commentAdded(const QModelIndex &index) {
+  if (!index.isValid() || index.row() >= rows_.size()) {
+    return;
+  }
+  auto &row = rows_[index.row()];
+  if (!row.expanded) {
+    ++row.post.commentCount;
+    emit dataChanged(index, index, {Qt::DisplayRole});
+    return;
+  }
+  emit layoutAboutToBeChanged();
+  loadComments(row);
+  emit layoutChanged();
+}
+
+int TimelineModel::rowCount(const QModelIndex &parent) const {
+  return parent.isValid() ? 0 : rows_.size();
+}
+
+QVariant TimelineModel::data(const QModelIndex &index, int role) const {
+  if (!index.isValid() || index.row() >= rows_.size()) {
+    return {};
+  }
+  const auto &row = rows_[index.row()];
+  switch (role) {
+    case Qt::DisplayRole:
+      return rowText(row);
+    case PostIdRole:
+      return row.post.id.toString();
+    case OwnerIdRole:
+      return row.post.authorId.toString();
+    case ExpandedRole:
+      return row.expanded;
+    default:
+      return {};
+  }
+}
+
+bool TimelineModel::canFetchMore(const QModelIndex &parent) const {
+  return !parent.isValid() && rows_.size() < total_;
+}
+
+// 以已加载行数作为偏移在后台取下一页；同一时间只有一次翻页在进行。
+void TimelineModel::fetchMore(const QModelIndex &parent) {
+  if (parent.isValid() || pageWatcher_->isRunning()) {
+    return;
+  }
+  pageGeneration_ = generation_;
+  pageWatcher_->setFuture(QtConcurrent::run(
+      &TimelineModel::loadPage, service_, viewerId_, rows_.size()));
+}
+
+// 翻页期间模型被重置时偏移已失效，丢弃结果按新的行数重新取；
+// 取不到时以当前行数为准停止翻页。
+void TimelineModel::appendPage() {
+  if (pageGeneration_ != generation_) {
+    if (canFetchMore(QModelIndex())) {
+      fetchMore(QModelIndex());
+    }
+    return;
+  }
+  const auto page = pageWatcher_->result();
+  for (auto it = page.names.constBegin(); it != page.names.constEnd(); ++it) {
+    names_.insert(it.key(), it.value());
+  }
+  total_ = page.total;
+  appendPosts(page.posts);
+  if (page.posts.isEmpty()) {
+    total_ = rows_.size();
+  }
+}
+
+void TimelineModel::appendPosts(const QVector<core::SocialPost> &posts) {
+  QVector<core::SocialPost> fresh;
+  fresh.reserve(posts.size());
+  for (const auto &post : posts) {
+    if (!loadedIds_.contains(post.id)) {
+      loadedIds_.insert(post.id);
+      fresh.push_back(post);
+    }
+  }
+  if (fresh.isEmpty()) {
+    return;
+  }
+  beginInsertRows(QModelIndex(), rows_.size(),
+                  rows_.size() + fresh.size() - 1);
+  for (const auto &post : fresh) {
+    rows_.push_back({post, false});
+  }
+  endInsertRows();
+}
+
+// 评论者的用户名随评论一起解析，绘制时不再访问服务。
+void TimelineModel::loadComments(Row &row) {
+  int total = 0;
+  row.post.comments = service_->postComments(
+      viewerId_, row.post.authorId.toString(), row.post.id, 0,
+      kCommentPageSize, &total);
+  row.post.commentCount = total;
+  QVector<core::EntityId> authors;
+  authors.reserve(row.post.comments.size());
+  for (const auto &comment : row.post.comments) {
+    authors.push_back(comment.authorId);
+  }
+  resolveNames(service_, authors, names_);
+}
+
+// 同一作者的资料只查询一次；查不到资料时以 ID 显示。
+void TimelineModel::resolveNames(core::LedgerService *service,
+                                 const QVector<core::EntityId> &ids,
+                                 QHash<core::EntityId, QString> &names) {
+  for (const auto &userId : ids) {
+    if (names.contains(userId)) {
+      continue;
+    }
+    const auto profileOpt = service->profile(userId.toString());
+    names.insert(userId,
+                 profileOpt ? profileOpt->username : userId.toString());
+  }
+}
+
+QString TimelineModel::displayName(const core::EntityId &userId) const {
+  return names_.value(userId, userId.toString());
+}
+
+QString TimelineModel::rowText(const Row &row) const {
+  const auto &post = row.post;
+  QString text =
+      QString("%1 (%2) [%3]\n%4\n")
+          .arg(displayName(post.authorId),
+               post.visibility == core::PostVisibility::Public ? "公开"
+                                                               : "好友")
+          .arg(post.createdAt.toLocalTime().toString("yyyy-MM-dd HH:mm"))
+          .arg(post.content);
+  if (!row.expanded) {
+    text.append(QString("评论 %1 条（双击展开）").arg(post.commentCount));
+    return text;
+  }
+  text.append(QString("评论 %1 条（双击收起）:").arg(post.commentCount));
+  for (const auto &comment : post.comments) {
+    text.append(QString("\n - %1: %2")
+                    .arg(displayName(comment.authorId), comment.content));
+  }
+  if (post.commentCount > post.comments.size()) {
+    text.append(QString("\n（仅显示前 %1 条）").arg(post.comments.size()));
+  }
+  return text;
+}
+
+}  // namespace ui
@@ -0,0 +1,88 @@
+// Copyright (c) 2025 Yuning Wang. All rights reserved.
+//
+// Bookkeeper - Personal Finance Management System
+// Software Engineering Lab 3, Nanjing University
+// Student ID: 231220063
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
+#include <QVector>
+
+#include "core/LedgerService.h"
+
+namespace ui {
+
+// TimelineModel 为社交页提供分页的时间线：视图滚动到底时才在后台取下一页，
+// 评论只为展开的动态读取，收起后释放；作者名在读取页面时解析，绘制时只查表。
+class TimelineModel : public QAbstractListModel {
+  Q_OBJECT
+
+ public:
+  enum Role { PostIdRole = Qt::UserRole, OwnerIdRole, ExpandedRole };
+
+  static constexpr int kPageSize = 20;
+  // 展开时最多读取的评论条数。
+  static constexpr int kCommentPageSize = 50;
+
+  // 后台读取的一页动态及其作者名，total 为可见动态总数。
+  struct Page {
+    QVector<core::SocialPost> posts;
+    int total = 0;
+    QHash<core::EntityId, QString> names;
+  };
+
+  TimelineModel(core::LedgerService *service, const QString &viewerId,
+                QObject *parent = nullptr);
+  ~TimelineModel() override;
+
+  // 读取 offset 起的一页并解析作者名；只访问线程安全的服务接口。
+  static Page loadPage(core::LedgerService *service, const QString &viewerId,
+                       int offset);
+
+  // 以首页结果替换全部行，进行中的翻页结果随之作废。
+  void resetWith(const Page &firstPage);
+  // 展开时读取该动态的评论，再次调用收起。
+  void toggleExpanded(const QModelIndex &index);
+  // 当前用户评论后只更新该行的评论数与已展开的评论。
+  void commentAdded(const QModelIndex &index);
+
+  int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+  QVariant data(const QModelIndex &index,
+                int role = Qt::DisplayRole) const override;
+  bool canFetchMore(const QModelIndex &parent) const override;
+  void fetchMore(const QModelIndex &parent) override;
+
+ private:
+  struct Row {
+    core::SocialPost post;
+    bool expanded = false;
+  };
+
+  void appendPage();
+  void appendPosts(const QVector<core::SocialPost> &posts);
+  void loadComments(Row &row);
+  // 为 ids 中尚未解析的用户查询用户名并写入 names。
+  static void resolveNames(core::LedgerService *service,
+                           const QVector<core::EntityId> &ids,
+                           QHash<core::EntityId, QString> &names);
+  QString displayName(const core::EntityId &userId) const;
+  QString rowText(const Row &row) const;
+
+  core::LedgerService *service_ = nullptr;
+  QString viewerId_;
+  QVector<Row> rows_;
+  // 翻页期间有新动态时偏移会后移，按 ID 去掉重复的行。
+  QSet<core::EntityId> loadedIds_;
+  int total_ = 0;
+  QHash<core::EntityId, QString> names_;
+  QFutureWatcher<Page> *pageWatcher_ = nullptr;
+  // 每次重置加一，翻页结果回来时代数不同则丢弃。
+  int generation_ = 0;
+  int pageGeneration_ = 0;
+};
+
+}  // namespace ui
@@ -0,0 +1,73 @@
+// 批量导入基准：对比逐行 upsertBill 与 importCsv 的吞吐（行/秒）。
+// 用法：bench_import [行数]，默认 10000 行；逐行路径只取前 500 行估算。
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QUuid>
+
+#include <cstdio>
+
+#include "core/LedgerService.h"
+
+using namespace core;
+
+namespace {
+
+QByteArray makeCsv(int rows) {
+  QByteArray csv = "timestamp,amount,type,category,note\n";
+  csv.reserve(rows * 48);
+  for (int i = 0; i < rows; ++i) {
+    csv += QString("2025-01-%1T08:00:00,%2,expense,餐饮,row %3\n")
+               .arg(1 + i % 28, 2, 10, QLatin1Char('0'))
+               .arg(1 + i % 100)
+               .arg(i)
+               .toUtf8();
+  }
+  return csv;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  const int rows = argc > 1 ? QString(argv[1]).toInt() : 10000;
+  const int slowRows = qMin(rows, 500);
+
+  const QString dataDir = QDir::tempPath() + "/bk_bench_import_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  LedgerService service{QDir(dataDir)};
+  QString slowUser;
+  QString fastUser;
+  QString err;
+  service.registerUser("slow", "slow@example.com", "p", slowUser, err);
+  service.registerUser("fast", "fast@example.com", "p", fastUser, err);
+  const QString catId = service.categories(slowUser).at(1).id.toString();
+
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < slowRows; ++i) {
+    Bill bill;
+    bill.categoryId = catId;
+    bill.amount = 1.0 + i % 100;
+    service.upsertBill(slowUser, bill, err);
+  }
+  const double slowRate = slowRows * 1e9 / qMax<qint64>(1, timer.nsecsElapsed());
+  std::printf("upsertBill x%d: %.0f rows/s\n", slowRows, slowRate);
+
+  QByteArray csv = makeCsv(rows);
+  QBuffer buffer(&csv);
+  ImportReport report;
+  if (!service.importCsv(fastUser, buffer, report, err)) {
+    std::printf("importCsv failed: %s\n", qPrintable(err));
+    return 1;
+  }
+  std::printf("importCsv x%d: %.0f rows/s (%lld ms, %d inserted, %d rejected)\n",
+              report.rows, report.rowsPerSecond,
+              static_cast<long long>(report.elapsedMs), report.inserted,
+              report.rejected);
+  std::printf("speedup: %.1fx\n", report.rowsPerSecond / slowRate);
+
+  QDir(dataDir).removeRecursively();
+  return 0;
+}
@@ -0,0 +1,143 @@
+// 用户数据解码基准：对比 QJsonDocument + 逐实体 fromJson 与流式 JsonReader，
+// 同时统计每次加载的堆分配次数（仅 glibc 下可用）。
+// 用法：bench_load [账单数] [轮数]
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+
+#include "core/IdGenerator.h"
+#include "core/JsonStorage.h"
+
+using namespace core;
+
+#if defined(__GLIBC__)
+// 替换 malloc 系列并转发给 glibc 的实现，只增加一次原子计数。
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+static std::atomic<long long> gAllocations{0};
+
+void *malloc(size_t size) {
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size) {
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size) {
+  gAllocations.fetch_add(1, std::memory_order_relaxed);
+  return __libc_realloc(ptr, size);
+}
+}
+
+static long long allocations() { return gAllocations.load(); }
+constexpr bool kCountsAllocations = true;
+#else
+static long long allocations() { return 0; }
+constexpr bool kCountsAllocations = false;
+#endif
+
+namespace {
+
+// 改造前 JsonStorage 的解码方式。
+UserData decodeViaTree(const QByteArray &bytes) {
+  const QJsonObject obj = QJsonDocument::fromJson(bytes).object();
+  UserData data;
+  data.profile = UserProfile::fromJson(obj.value("profile").toObject());
+  for (const auto &value : obj.value("categories").toArray()) {
+    data.categories.push_back(Category::fromJson(value.toObject()));
+  }
+  for (const auto &value : obj.value("bills").toArray()) {
+    data.bills.push_back(Bill::fromJson(value.toObject()));
+  }
+  if (!CalendarRollups::fromJson(obj.value("rollups").toObject(),
+                                 data.rollups) ||
+      data.rollups.billCount() != data.bills.size()) {
+    data.rollups = CalendarRollups::build(data.bills);
+  }
+  data.reindex();
+  return data;
+}
+
+void report(const char *name, qint64 nsecs, long long allocs, int rounds) {
+  std::printf("%-16s %8.2f ms/load", name,
+              static_cast<double>(nsecs) / rounds / 1e6);
+  if (kCountsAllocations) {
+    std::printf("  %10lld allocs/load", allocs / rounds);
+  }
+  std::printf("\n");
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  const int count = argc > 1 ? QString(argv[1]).toInt() : 20000;
+  const int rounds = argc > 2 ? QString(argv[2]).toInt() : 20;
+
+  UserData data;
+  data.profile.id = IdGenerator::next().toString();
+  data.profile.username = "bench";
+  for (int i = 0; i < 8; ++i) {
+    Category category;
+    category.id = IdGenerator::next();
+    category.name = QStringLiteral("分类%1").arg(i);
+    category.type = "expense";
+    data.categories.push_back(category);
+  }
+  const QDateTime base(QDate(2020, 1, 1), QTime(9, 0), Qt::UTC);
+  for (int i = 0; i < count; ++i) {
+    Bill bill;
+    bill.id = IdGenerator::next();
+    bill.amount = (i % 500) * 1.25;
+    bill.categoryId = data.categories[i % data.categories.size()].id;
+    bill.note = i % 4 == 0 ? QStringLiteral("午餐 #%1").arg(i)
+                           : QStringLiteral("午餐");
+    bill.timestamp = base.addSecs(static_cast<qint64>(i) * 3571);
+    data.bills.push_back(bill);
+  }
+  data.rollups = CalendarRollups::build(data.bills);
+  const QByteArray bytes = JsonStorage::encode(data);
+
+  QElapsedTimer timer;
+  UserData viaTree;
+  long long before = allocations();
+  timer.start();
+  for (int r = 0; r < rounds; ++r) {
+    viaTree = decodeViaTree(bytes);
+  }
+  const qint64 treeNs = timer.nsecsElapsed();
+  const long long treeAllocs = allocations() - before;
+
+  UserData streamed;
+  before = allocations();
+  timer.restart();
+  for (int r = 0; r < rounds; ++r) {
+    JsonStorage::decode(bytes, streamed);
+  }
+  const qint64 streamNs = timer.nsecsElapsed();
+  const long long streamAllocs = allocations() - before;
+
+  report("QJsonDocument", treeNs, treeAllocs, rounds);
+  report("JsonReader", streamNs, streamAllocs, rounds);
+  std::printf("speedup %.1fx\n", static_cast<double>(treeNs) / streamNs);
+  if (!kCountsAllocations) {
+    std::printf("allocation counting requires glibc\n");
+  }
+  const bool same =
+      JsonStorage::encode(viaTree) == JsonStorage::encode(streamed);
+  std::printf("results identical: %s\n", same ? "yes" : "NO");
+  return same ? 0 : 1;
+}
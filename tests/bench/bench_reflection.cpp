@@ -0,0 +1,133 @@
+// 实体编解码基准：对比手写的 toJson/fromJson 与字段表生成的编解码。
+// 用法：bench_reflection [条数]
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QVector>
+
+#include <cstdio>
+
+#include "core/EntityFields.h"
+#include "core/IdGenerator.h"
+
+using namespace core;
+
+namespace {
+
+// 引入字段表之前 Entities.cpp 中的手写实现，作为对照。
+QJsonObject handWrittenToJson(const Bill &bill) {
+  QJsonObject obj;
+  obj["id"] = bill.id.toString();
+  obj["amount"] = bill.amount;
+  obj["categoryId"] = bill.categoryId.toString();
+  obj["note"] = bill.note;
+  obj["timestamp"] = TimestampCodec::format(bill.timestamp);
+  obj["type"] = bill.type == BillType::Income ? "income" : "expense";
+  return obj;
+}
+
+Bill handWrittenFromJson(const QJsonObject &obj) {
+  Bill bill;
+  bill.id = obj.value("id").toString();
+  bill.amount = obj.value("amount").toDouble();
+  bill.categoryId = obj.value("categoryId").toString();
+  bill.note = obj.value("note").toString();
+  bill.timestamp = TimestampCodec::parse(obj.value("timestamp").toString());
+  bill.type = obj.value("type").toString() == "income" ? BillType::Income
+                                                        : BillType::Expense;
+  return bill;
+}
+
+void report(const char *name, qint64 nsecs, int count) {
+  std::printf("%-22s %8.1f ns/op\n", name, static_cast<double>(nsecs) / count);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  const int count = argc > 1 ? QString(argv[1]).toInt() : 100000;
+
+  QVector<Bill> bills;
+  bills.reserve(count);
+  const EntityId categoryId = IdGenerator::next();
+  const QDateTime base(QDate(2020, 1, 1), QTime(9, 0), Qt::UTC);
+  for (int i = 0; i < count; ++i) {
+    Bill bill;
+    bill.id = IdGenerator::next();
+    bill.amount = (i % 500) * 1.25;
+    bill.categoryId = categoryId;
+    bill.note = QStringLiteral("午餐 #%1").arg(i);
+    bill.timestamp = base.addSecs(static_cast<qint64>(i) * 3571);
+    bill.type = i % 4 == 0 ? BillType::Income : BillType::Expense;
+    bills.push_back(bill);
+  }
+
+  QElapsedTimer timer;
+  QVector<QJsonObject> handJson;
+  handJson.reserve(count);
+  timer.start();
+  for (const auto &bill : bills) {
+    handJson.push_back(handWrittenToJson(bill));
+  }
+  const qint64 handEncode = timer.nsecsElapsed();
+
+  QVector<QJsonObject> reflectedJson;
+  reflectedJson.reserve(count);
+  timer.restart();
+  for (const auto &bill : bills) {
+    reflectedJson.push_back(bill.toJson());
+  }
+  const qint64 reflectedEncode = timer.nsecsElapsed();
+
+  int mismatches = 0;
+  timer.restart();
+  for (int i = 0; i < count; ++i) {
+    mismatches += handWrittenFromJson(handJson[i]).id != bills[i].id;
+  }
+  const qint64 handDecode = timer.nsecsElapsed();
+
+  timer.restart();
+  for (int i = 0; i < count; ++i) {
+    mismatches += Bill::fromJson(handJson[i]).id != bills[i].id;
+  }
+  const qint64 reflectedDecode = timer.nsecsElapsed();
+
+  QByteArray binary;
+  timer.restart();
+  {
+    QDataStream out(&binary, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    for (const auto &bill : bills) {
+      reflect::save(out, bill);
+    }
+  }
+  const qint64 binaryEncode = timer.nsecsElapsed();
+
+  timer.restart();
+  {
+    QDataStream in(binary);
+    in.setVersion(QDataStream::Qt_5_12);
+    for (int i = 0; i < count; ++i) {
+      Bill bill;
+      reflect::load(in, bill);
+      mismatches += bill.id != bills[i].id;
+    }
+  }
+  const qint64 binaryDecode = timer.nsecsElapsed();
+
+  report("toJson hand-written", handEncode, count);
+  report("toJson reflected", reflectedEncode, count);
+  report("fromJson hand-written", handDecode, count);
+  report("fromJson reflected", reflectedDecode, count);
+  report("binary save", binaryEncode, count);
+  report("binary load", binaryDecode, count);
+  std::printf("binary %.1f bytes/bill\n",
+              static_cast<double>(binary.size()) / count);
+  // 两种实现的结果必须一致，否则基准没有意义。
+  const bool same = handJson == reflectedJson && mismatches == 0;
+  std::printf("results identical: %s\n", same ? "yes" : "NO");
+  return same ? 0 : 1;
+}
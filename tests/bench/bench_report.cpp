@@ -0,0 +1,88 @@
+// 跨用户并行基准：不同线程数下冷启动 listUsers 与 systemReport 的耗时。
+// 用法：bench_report [用户数] [每用户账单数]，默认 200 个用户、每人 500 条。
+
+#include <QBuffer>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QThread>
+#include <QThreadPool>
+#include <QUuid>
+
+#include <cstdio>
+
+#include "core/JsonStorage.h"
+#include "core/LedgerService.h"
+
+using namespace core;
+
+namespace {
+
+QByteArray makeCsv(int rows) {
+  static const char *const kCategories[] = {"日常支出", "餐饮", "交通", "其他"};
+  QByteArray csv = "timestamp,amount,type,category,note\n";
+  csv.reserve(rows * 48);
+  for (int i = 0; i < rows; ++i) {
+    csv += QString("2025-%1-%2T08:00:00,%3,expense,%4,row %5\n")
+               .arg(1 + i % 12, 2, 10, QLatin1Char('0'))
+               .arg(1 + i % 28, 2, 10, QLatin1Char('0'))
+               .arg(1 + i % 100)
+               .arg(kCategories[i % 4])
+               .arg(i)
+               .toUtf8();
+  }
+  return csv;
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  const int users = argc > 1 ? QString(argv[1]).toInt() : 200;
+  const int rows = argc > 2 ? QString(argv[2]).toInt() : 500;
+
+  const QString dataDir = QDir::tempPath() + "/bk_bench_report_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  {
+    LedgerService seed{QDir(dataDir)};
+    const QByteArray csv = makeCsv(rows);
+    for (int u = 0; u < users; ++u) {
+      QString userId;
+      QString err;
+      const QString name = QString("user%1").arg(u);
+      if (!seed.registerUser(name, name + "@example.com", "p", userId, err)) {
+        std::printf("register failed: %s\n", qPrintable(err));
+        return 1;
+      }
+      QByteArray copy = csv;
+      QBuffer buffer(&copy);
+      ImportReport report;
+      seed.importCsv(userId, buffer, report, err);
+    }
+  }
+
+  const int maxThreads = QThread::idealThreadCount();
+  double baseline = 0.0;
+  for (int threads = 1; threads <= maxThreads; threads *= 2) {
+    QThreadPool::globalInstance()->setMaxThreadCount(threads);
+    // 每轮使用新的存储与服务实例，快照缓存为空，全部从文件读取。
+    JsonStorage storage{QDir(dataDir)};
+    LedgerService service{QDir(dataDir)};
+    QElapsedTimer timer;
+    timer.start();
+    const int listed = storage.listUsers().size();
+    const qint64 listNs = timer.nsecsElapsed();
+    const auto report = service.systemReport();
+    const double reportMs = report.elapsedMs > 0 ? report.elapsedMs : 1.0;
+    if (threads == 1) {
+      baseline = reportMs;
+    }
+    std::printf("threads=%2d listUsers(%d): %.1f ms  systemReport: %lld ms "
+                "(%d bills, speedup %.2fx)\n",
+                threads, listed, listNs / 1e6,
+                static_cast<long long>(report.elapsedMs), report.bills,
+                baseline / reportMs);
+  }
+
+  QDir(dataDir).removeRecursively();
+  return 0;
+}
@@ -0,0 +1,64 @@
+// 全文检索基准：构建 10 万条账单备注的索引，测量构建、序列化与查询延迟。
+// 用法：bench_search [文档数]
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "core/SearchIndex.h"
+
+using namespace core;
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  const int documents = argc > 1 ? QString(argv[1]).toInt() : 100000;
+
+  const QStringList places = {"公司", "机场", "火车站", "超市", "医院",
+                              "学校", "商场", "饭店", "公园", "银行"};
+  const QStringList actions = {"打车去", "午餐在", "买菜于", "停车费",
+                               "聚餐", "加油", "网购", "咖啡"};
+  QElapsedTimer timer;
+  timer.start();
+  SearchIndex index;
+  for (int i = 0; i < documents; ++i) {
+    const QString note = QString("%1%2 %3 第%4单")
+                             .arg(actions[i % actions.size()])
+                             .arg(places[(i / 7) % places.size()])
+                             .arg(i % 13 == 0 ? "taxi" : "")
+                             .arg(i);
+    index.upsert(SearchKind::Bill, QString::number(i), QString(), note);
+  }
+  std::printf("build %d docs: %lld ms\n", documents,
+              static_cast<long long>(timer.elapsed()));
+
+  timer.restart();
+  const QByteArray bytes = index.serialize(1);
+  std::printf("serialize: %lld ms, %d bytes\n",
+              static_cast<long long>(timer.elapsed()), bytes.size());
+  timer.restart();
+  SearchIndex restored;
+  restored.deserialize(bytes, 1);
+  std::printf("deserialize: %lld ms\n",
+              static_cast<long long>(timer.elapsed()));
+
+  const QStringList queries = {"打车", "机场", "打车 机场", "taxi", "聚餐 饭店",
+                               "不存在"};
+  for (const auto &query : queries) {
+    std::vector<qint64> samples;
+    int hits = 0;
+    for (int round = 0; round < 50; ++round) {
+      timer.restart();
+      hits = restored.search(query, 20).size();
+      samples.push_back(timer.nsecsElapsed());
+    }
+    std::sort(samples.begin(), samples.end());
+    std::printf("query %-12s hits=%2d p50=%.3f ms p99=%.3f ms\n",
+                qPrintable(query), hits, samples[samples.size() / 2] / 1e6,
+                samples[samples.size() * 99 / 100] / 1e6);
+  }
+  return 0;
+}
@@ -0,0 +1,105 @@
+// 用户数据编码基准：对比 QJsonObject 树 + QJsonDocument 与流式 JsonWriter。
+// 用法：bench_serialize [账单数] [轮数]
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <cstdio>
+
+#include "core/IdGenerator.h"
+#include "core/JsonStorage.h"
+
+using namespace core;
+
+namespace {
+
+// 改造前 JsonStorage 的编码方式。
+QByteArray encodeViaTree(const UserData &data) {
+  QJsonObject obj;
+  obj["profile"] = data.profile.toJson();
+  QJsonArray categories;
+  for (const auto &category : data.categories) {
+    categories.append(category.toJson());
+  }
+  obj["categories"] = categories;
+  QJsonArray bills;
+  for (const auto &bill : data.bills) {
+    bills.append(bill.toJson());
+  }
+  obj["bills"] = bills;
+  obj["reminders"] = QJsonArray();
+  obj["posts"] = QJsonArray();
+  obj["rollups"] = data.rollups.toJson();
+  return QJsonDocument(obj).toJson();
+}
+
+void report(const char *name, qint64 nsecs, int rounds, int bytes) {
+  std::printf("%-16s %8.2f ms/save  %8d bytes\n", name,
+              static_cast<double>(nsecs) / rounds / 1e6, bytes);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  const int count = argc > 1 ? QString(argv[1]).toInt() : 20000;
+  const int rounds = argc > 2 ? QString(argv[2]).toInt() : 20;
+
+  UserData data;
+  data.profile.id = IdGenerator::next().toString();
+  data.profile.username = "bench";
+  for (int i = 0; i < 8; ++i) {
+    Category category;
+    category.id = IdGenerator::next();
+    category.name = QStringLiteral("分类%1").arg(i);
+    category.type = "expense";
+    data.categories.push_back(category);
+  }
+  const QDateTime base(QDate(2020, 1, 1), QTime(9, 0), Qt::UTC);
+  for (int i = 0; i < count; ++i) {
+    Bill bill;
+    bill.id = IdGenerator::next();
+    bill.amount = (i % 500) * 1.25;
+    bill.categoryId = data.categories[i % data.categories.size()].id;
+    bill.note = QStringLiteral("午餐 #%1").arg(i);
+    bill.timestamp = base.addSecs(static_cast<qint64>(i) * 3571);
+    data.bills.push_back(bill);
+  }
+  data.rollups = CalendarRollups::build(data.bills);
+
+  QElapsedTimer timer;
+  QByteArray viaTree;
+  timer.start();
+  for (int r = 0; r < rounds; ++r) {
+    viaTree = encodeViaTree(data);
+  }
+  const qint64 treeNs = timer.nsecsElapsed();
+
+  QByteArray streamed;
+  timer.restart();
+  for (int r = 0; r < rounds; ++r) {
+    streamed = JsonStorage::encode(data);
+  }
+  const qint64 streamNs = timer.nsecsElapsed();
+
+  QByteArray compact;
+  timer.restart();
+  for (int r = 0; r < rounds; ++r) {
+    compact = JsonStorage::encode(data, JsonWriter::Style::Compact);
+  }
+  const qint64 compactNs = timer.nsecsElapsed();
+
+  report("QJsonDocument", treeNs, rounds, viaTree.size());
+  report("JsonWriter", streamNs, rounds, streamed.size());
+  report("JsonWriter/compact", compactNs, rounds, compact.size());
+  std::printf("speedup %.1fx\n", static_cast<double>(treeNs) / streamNs);
+  // 浮点数的写法随 Qt 版本不同，逐字节相同只作参考，以解析结果判定。
+  const bool same = QJsonDocument::fromJson(viaTree) ==
+                    QJsonDocument::fromJson(streamed);
+  std::printf("results equivalent: %s (byte-identical: %s)\n",
+              same ? "yes" : "NO", viaTree == streamed ? "yes" : "no");
+  return same ? 0 : 1;
+}
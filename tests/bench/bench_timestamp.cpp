@@ -0,0 +1,88 @@
+// 时间戳编解码基准：对比 TimestampCodec 与 QDateTime 的 Qt::ISODate 实现。
+// 用法：bench_timestamp [条数]
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+
+#include <cstdio>
+
+#include "core/TimestampCodec.h"
+
+using namespace core;
+
+namespace {
+
+void report(const char *name, qint64 nsecs, int count) {
+  std::printf("%-22s %8.1f ns/op\n", name, static_cast<double>(nsecs) / count);
+}
+
+}  // namespace
+
+int main(int argc, char *argv[]) {
+  QCoreApplication app(argc, argv);
+  const int count = argc > 1 ? QString(argv[1]).toInt() : 200000;
+
+  // 本地时间、UTC 与固定偏移三种写法轮换，覆盖存储中实际出现的格式。
+  QVector<QDateTime> values;
+  values.reserve(count);
+  const QDateTime base(QDate(2020, 1, 1), QTime(0, 0), Qt::UTC);
+  for (int i = 0; i < count; ++i) {
+    const QDateTime instant = base.addSecs(static_cast<qint64>(i) * 4001);
+    switch (i % 3) {
+      case 0:
+        values.push_back(instant.toLocalTime());
+        break;
+      case 1:
+        values.push_back(instant);
+        break;
+      default:
+        values.push_back(instant.toOffsetFromUtc(8 * 3600));
+        break;
+    }
+  }
+
+  QElapsedTimer timer;
+  QStringList qtTexts;
+  qtTexts.reserve(count);
+  timer.start();
+  for (const auto &value : values) {
+    qtTexts.push_back(value.toString(Qt::ISODate));
+  }
+  const qint64 qtFormat = timer.nsecsElapsed();
+
+  QStringList codecTexts;
+  codecTexts.reserve(count);
+  timer.restart();
+  for (const auto &value : values) {
+    codecTexts.push_back(TimestampCodec::format(value));
+  }
+  const qint64 codecFormat = timer.nsecsElapsed();
+
+  int checksum = 0;
+  timer.restart();
+  for (const auto &text : qtTexts) {
+    checksum += QDateTime::fromString(text, Qt::ISODate).time().second();
+  }
+  const qint64 qtParse = timer.nsecsElapsed();
+
+  timer.restart();
+  for (const auto &text : qtTexts) {
+    checksum -= TimestampCodec::parse(text).time().second();
+  }
+  const qint64 codecParse = timer.nsecsElapsed();
+
+  report("format QDateTime", qtFormat, count);
+  report("format TimestampCodec", codecFormat, count);
+  report("parse QDateTime", qtParse, count);
+  report("parse TimestampCodec", codecParse, count);
+  std::printf("speedup format %.1fx, parse %.1fx\n",
+              static_cast<double>(qtFormat) / codecFormat,
+              static_cast<double>(qtParse) / codecParse);
+  // 两种实现的结果必须一致，否则基准没有意义。
+  const bool same = qtTexts == codecTexts && checksum == 0;
+  std::printf("results identical: %s\n", same ? "yes" : "NO");
+  return same ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+// libFuzzer 入口：对比 TimestampCodec 与 QDateTime(Qt::ISODate) 的解析与生成结果，
+// 任何不一致都视为缺陷并中止；种子见 corpus_timestamp。
+
+#include <cstdint>
+#include <cstdlib>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QString>
+
+#include "core/TimestampCodec.h"
+
+using namespace core;
+
+namespace {
+
+// 有效性、时刻、时间规格与偏移全部一致才算相同。
+bool sameDateTime(const QDateTime &a, const QDateTime &b) {
+  if (a.isValid() != b.isValid()) {
+    return false;
+  }
+  if (!a.isValid()) {
+    return true;
+  }
+  return a == b && a.timeSpec() == b.timeSpec() &&
+         a.offsetFromUtc() == b.offsetFromUtc() && a.date() == b.date() &&
+         a.time() == b.time();
+}
+
+}  // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size) {
+  const QString text = QString::fromUtf8(reinterpret_cast<const char *>(data),
+                                         static_cast<int>(size));
+  const QDateTime reference = QDateTime::fromString(text, Qt::ISODate);
+  const QDateTime parsed = TimestampCodec::parse(text);
+  if (!sameDateTime(parsed, reference)) {
+    std::abort();
+  }
+  if (!reference.isValid()) {
+    return 0;
+  }
+
+  // 生成结果与 Qt 一致，且再次解析后仍一致（往返）。
+  const QString formatted = TimestampCodec::format(reference);
+  if (formatted != reference.toString(Qt::ISODate)) {
+    std::abort();
+  }
+  if (!sameDateTime(TimestampCodec::parse(formatted),
+                    QDateTime::fromString(formatted, Qt::ISODate))) {
+    std::abort();
+  }
+  return 0;
+}
@@ -38,7 +38,7 @@ TEST(IntegrationFlow, FullLifecycleWithReloginAndPersistence) {
       return c.name == "自定义分类";
     });
     ASSERT_NE(foundCat, cats.end());
-    customCatId = foundCat->id;
+    customCatId = foundCat->id.toString();
 
     Bill bill1;
     bill1.categoryId = customCatId;
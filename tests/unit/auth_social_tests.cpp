@@ -10,7 +10,7 @@
 
 using namespace core;
 
-/* 测试用户认证和社交相关功能 共7个测试样例 */
+/* 测试用户认证和社交相关功能 共8个测试样例 */
 
 // 用例：未注册用户或密码错误返回空结果并给出错误提示。
 TEST(AuthSocialTests, AuthenticateFailsForUnknownOrWrongPassword) {
@@ -134,7 +134,7 @@ TEST(AuthSocialTests, PublishTimelineVisibilityAndComment) {
   // C获取时间线应只能一条动态 并且是公开的
   const auto charlieTimeline = service.timeline(charlieId);
   EXPECT_EQ(charlieTimeline.size(), 1);
-  EXPECT_EQ(charlieTimeline.first().visibility, "public");
+  EXPECT_EQ(charlieTimeline.first().visibility, PostVisibility::Public);
 
   // 验证 B 能对 A 的动态发表评论
   const auto aliceTimeline = service.timeline(aliceId);
@@ -195,4 +195,57 @@ TEST(AuthSocialTests, UpdateSettingsAndProfileReadback) {
   EXPECT_EQ(profile->privacyLevel, "private");
 
   QDir(envPath).removeRecursively();
-}
\ No newline at end of file
+}
+
+// 用例：时间线分页顺序稳定且只带评论摘要，完整评论按可见性单独读取。
+TEST(AuthSocialTests, TimelinePagesAndCommentsOnDemand) {
+  const QString envPath = QDir::tempPath() + "/bk_timeline_page_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  qputenv("BOOKEEPER_DATA_DIR", envPath.toUtf8());
+  QDir(envPath).removeRecursively();
+
+  LedgerService service;
+  QString aliceId;
+  QString bobId;
+  QString err;
+  ASSERT_TRUE(service.registerUser("alice_p", "alice_p@example.com", "pw", aliceId, err)) << err.toStdString();
+  ASSERT_TRUE(service.registerUser("bob_p", "bob_p@example.com", "pw", bobId, err)) << err.toStdString();
+  for (int i = 0; i < 5; ++i) {
+    ASSERT_TRUE(service.publishPost(aliceId, QString("动态%1").arg(i), "public", err)) << err.toStdString();
+  }
+  ASSERT_TRUE(service.publishPost(aliceId, "仅好友", "friends", err)) << err.toStdString();
+  const auto full = service.timeline(aliceId);
+  ASSERT_EQ(full.size(), 6);
+  const auto hidden = std::find_if(full.begin(), full.end(), [](const SocialPost &p) {
+    return p.visibility == PostVisibility::Friends;
+  });
+  ASSERT_NE(hidden, full.end());
+  ASSERT_TRUE(service.addComment(aliceId, aliceId, hidden->id, "自评", err)) << err.toStdString();
+
+  // 两页拼起来与完整时间线顺序一致
+  int total = 0;
+  auto first = service.timelinePage(aliceId, 0, 4, &total);
+  const auto second = service.timelinePage(aliceId, 4, 4, &total);
+  EXPECT_EQ(total, 6);
+  ASSERT_EQ(first.size(), 4);
+  ASSERT_EQ(second.size(), 2);
+  first += second;
+  for (int i = 0; i < full.size(); ++i) {
+    EXPECT_EQ(first[i].id, full[i].id);
+    EXPECT_EQ(first[i].comments.size(), first[i].commentCount);
+    EXPECT_EQ(first[i].commentCount, first[i].id == hidden->id ? 1 : 0);
+  }
+  EXPECT_TRUE(service.timelinePage(aliceId, 10, 4).isEmpty());
+
+  // 评论单独读取；非好友看不到仅好友动态的评论
+  EXPECT_EQ(service.postComments(aliceId, aliceId, hidden->id).size(), 1);
+  EXPECT_TRUE(service.postComments(bobId, aliceId, hidden->id).isEmpty());
+
+  // 读取他人的动态不会把其完整账本发布进快照缓存
+  LedgerService reopened;
+  EXPECT_EQ(reopened.timeline(bobId).size(), 5);
+  EXPECT_EQ(reopened.postComments(aliceId, aliceId, hidden->id).size(), 1);
+  EXPECT_EQ(reopened.memoryGauge().cachedUsers, 1);
+
+  QDir(envPath).removeRecursively();
+  qunsetenv("BOOKEEPER_DATA_DIR");
+}
@@ -0,0 +1,183 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QUuid>
+
+#include "core/BillArchive.h"
+#include "core/LedgerService.h"
+
+using namespace core;
+
+/* 测试冷账单归档段的写入、透明汇总与取回 共2个测试样例 */
+
+namespace {
+
+QString tempDataDir() {
+  return QDir::tempPath() + "/bk_archive_" +
+         QUuid::createUuid().toString(QUuid::WithoutBraces);
+}
+
+// 2019 年 1～3 月每月若干笔旧账单，外加两笔近期账单。
+void seedBills(LedgerService &service, const QString &userId) {
+  const auto categories = service.categories(userId);
+  ASSERT_GE(categories.size(), 2);
+  QString err;
+  for (int i = 0; i < 30; ++i) {
+    Bill bill;
+    bill.id = QString("old-%1").arg(i);
+    bill.categoryId = categories[i % 2].id;
+    bill.amount = 10 + i;
+    bill.type = i % 5 == 0 ? BillType::Income : BillType::Expense;
+    bill.note = QString("旧账单 %1").arg(i);
+    bill.timestamp = QDateTime(QDate(2019, 1 + i % 3, 1 + i % 28), QTime(9, 0));
+    ASSERT_TRUE(service.upsertBill(userId, bill, err)) << err.toStdString();
+  }
+  for (int i = 0; i < 2; ++i) {
+    Bill bill;
+    bill.id = QString("new-%1").arg(i);
+    bill.categoryId = categories[0].id;
+    bill.amount = 100;
+    bill.timestamp = QDateTime(QDate(2026, 9, 10 + i), QTime(9, 0));
+    ASSERT_TRUE(service.upsertBill(userId, bill, err)) << err.toStdString();
+  }
+}
+
+}  // namespace
+
+// 用例：归档后加载只含近期账单，汇总、序列与过滤查询的结果与归档前一致。
+TEST(BillArchiveTests, AggregatesAndQueriesSeeArchivedBills) {
+  const QString envPath = tempDataDir();
+  QDir(envPath).removeRecursively();
+  QString userId;
+  QString err;
+  const QDate from(2019, 1, 1);
+  const QDate to(2019, 3, 31);
+  {
+    LedgerService service{QDir(envPath)};
+    ASSERT_TRUE(service.registerUser("cold", "cold@example.com", "p", userId, err)) << err.toStdString();
+    seedBills(service, userId);
+  }
+
+  LedgerService service{QDir(envPath)};
+  const auto summaries = service.summarizeByCategory(userId);
+  const double income = service.totalIncome(userId);
+  const double expense = service.totalExpense(userId);
+  const auto months = service.periodSeries(userId, RollupPeriod::Month, from, to);
+  const auto weeks = service.periodSeries(userId, RollupPeriod::Week, from, to);
+  BillQueryResult before;
+  ASSERT_TRUE(service.queryBills(userId, "date < 2019-02-15 and amount > 12", before, err));
+
+  int archived = 0;
+  ASSERT_TRUE(service.archiveBills(userId, QDate(2020, 1, 1), archived, err)) << err.toStdString();
+  EXPECT_EQ(archived, 30);
+  EXPECT_EQ(service.bills(userId).size(), 2);
+  const auto snapshot = service.snapshot(userId);
+  ASSERT_EQ(snapshot->archive.size(), 3);
+  EXPECT_EQ(snapshot->archive[0].month, QDate(2019, 1, 1));
+  EXPECT_EQ(snapshot->archive[0].count, 10);
+
+  // 重新打开后只读到摘要，汇总仍包含归档部分。
+  LedgerService reopened{QDir(envPath)};
+  EXPECT_EQ(reopened.snapshot(userId)->bills.size(), 2);
+  EXPECT_DOUBLE_EQ(reopened.totalIncome(userId), income);
+  EXPECT_DOUBLE_EQ(reopened.totalExpense(userId), expense);
+  const auto archivedSummaries = reopened.summarizeByCategory(userId);
+  ASSERT_EQ(archivedSummaries.size(), summaries.size());
+  for (int i = 0; i < summaries.size(); ++i) {
+    EXPECT_DOUBLE_EQ(archivedSummaries[i].expense, summaries[i].expense);
+  }
+  const auto archivedMonths =
+      reopened.periodSeries(userId, RollupPeriod::Month, from, to);
+  const auto archivedWeeks =
+      reopened.periodSeries(userId, RollupPeriod::Week, from, to);
+  ASSERT_EQ(archivedMonths.size(), months.size());
+  for (int i = 0; i < months.size(); ++i) {
+    EXPECT_EQ(archivedMonths[i].totals.count, months[i].totals.count);
+    EXPECT_DOUBLE_EQ(archivedMonths[i].totals.expense, months[i].totals.expense);
+  }
+  ASSERT_EQ(archivedWeeks.size(), weeks.size());
+  for (int i = 0; i < weeks.size(); ++i) {
+    EXPECT_EQ(archivedWeeks[i].totals.count, weeks[i].totals.count);
+  }
+  BillQueryResult after;
+  ASSERT_TRUE(reopened.queryBills(userId, "date < 2019-02-15 and amount > 12", after, err));
+  ASSERT_EQ(after.bills.size(), before.bills.size());
+  EXPECT_DOUBLE_EQ(after.totals.expense, before.totals.expense);
+
+  // 带区间的 bills 只解压相交月份，段内超出区间的账单被筛掉。
+  EXPECT_EQ(reopened.bills(userId, QDate(2019, 2, 1), QDate(2019, 2, 28)).size(), 10);
+  EXPECT_EQ(reopened.bills(userId, QDate(), QDate()).size(), 32);
+  EXPECT_EQ(reopened.earliestBillDate(userId), QDate(2019, 1, 1));
+
+  // 仍被归档账单引用的分类不能删除。
+  EXPECT_FALSE(reopened.removeCategory(userId, reopened.categories(userId)[1].id, err));
+  QDir(envPath).removeRecursively();
+}
+
+// 用例：编辑与删除归档账单会写出新版本的段并删除旧版本，段文件远小于原文。
+TEST(BillArchiveTests, EditAndRemoveRewriteSegments) {
+  const QString envPath = tempDataDir();
+  QDir(envPath).removeRecursively();
+  LedgerService service{QDir(envPath)};
+  QString userId;
+  QString err;
+  ASSERT_TRUE(service.registerUser("thaw", "thaw@example.com", "p", userId, err)) << err.toStdString();
+  seedBills(service, userId);
+  int archived = 0;
+  ASSERT_TRUE(service.archiveBills(userId, QDate(2020, 1, 1), archived, err));
+  const ArchiveSegment january = service.snapshot(userId)->archive[0];
+  const QString segmentPath = envPath + "/" +
+      JsonStorage::relativeFilePath(userId, BillArchive::suffix(january));
+  ASSERT_TRUE(QFile::exists(segmentPath));
+
+  Bill edited;
+  edited.id = "old-0";
+  edited.categoryId = service.categories(userId)[0].id;
+  edited.amount = 999;
+  edited.timestamp = QDateTime(QDate(2019, 1, 1), QTime(9, 0));
+  ASSERT_TRUE(service.upsertBill(userId, edited, err)) << err.toStdString();
+  auto snapshot = service.snapshot(userId);
+  EXPECT_EQ(snapshot->bills.size(), 3);
+  EXPECT_EQ(snapshot->archive[0].count, 9);
+  EXPECT_EQ(snapshot->archive[0].version, 2);
+  EXPECT_FALSE(QFile::exists(segmentPath));
+
+  // 把三月的账单改到一月：按原 ID 在三月的段中找到，不会留下重复。
+  edited.id = "old-2";
+  edited.timestamp = QDateTime(QDate(2019, 1, 5), QTime(9, 0));
+  ASSERT_TRUE(service.upsertBill(userId, edited, err)) << err.toStdString();
+  snapshot = service.snapshot(userId);
+  EXPECT_EQ(snapshot->bills.size(), 4);
+  EXPECT_EQ(snapshot->archive[2].count, 9);
+  int total = snapshot->bills.size();
+  for (const auto &segment : snapshot->archive) {
+    total += segment.count;
+  }
+  EXPECT_EQ(total, 32);
+
+  ASSERT_TRUE(service.removeBill(userId, "old-1", err)) << err.toStdString();
+  snapshot = service.snapshot(userId);
+  EXPECT_EQ(snapshot->archive[1].count, 9);
+  EXPECT_FALSE(service.removeBill(userId, "missing", err));
+
+  // 再次归档会把编辑过的账单并回一月的段。
+  ASSERT_TRUE(service.archiveBills(userId, QDate(2020, 1, 1), archived, err));
+  EXPECT_EQ(archived, 2);
+  EXPECT_EQ(service.snapshot(userId)->archive[0].count, 11);
+
+  QVector<Bill> bills(500);
+  for (int i = 0; i < bills.size(); ++i) {
+    bills[i].id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    bills[i].categoryId = "cat";
+    bills[i].amount = i;
+    bills[i].note = "午餐";
+  }
+  const QByteArray compressed = BillArchive::encode(bills);
+  QVector<Bill> decoded;
+  ASSERT_TRUE(BillArchive::decode(compressed, decoded));
+  ASSERT_EQ(decoded.size(), bills.size());
+  EXPECT_EQ(decoded[7].note, bills[7].note);
+  EXPECT_LT(compressed.size(), bills.size() * 100);
+  QDir(envPath).removeRecursively();
+}
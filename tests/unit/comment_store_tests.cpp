@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QUuid>
+
+#include "core/CommentStore.h"
+#include "core/JsonStorage.h"
+#include "core/LedgerService.h"
+
+using namespace core;
+
+/* 测试按动态独立保存的评论串与旧数据迁移 共3个测试样例 */
+
+// 用例：追加后摘要只保留最近几条，分页按时间顺序读取；崩溃留下的半行被截掉。
+TEST(CommentStoreTests, AppendsPagesAndDropsTornTail) {
+  const QString envPath = QDir::tempPath() + "/bk_comments_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+  const EntityId postId = QUuid::createUuid().toString(QUuid::WithoutBraces);
+
+  {
+    CommentStore store{QDir(envPath)};
+    for (int i = 0; i < 5; ++i) {
+      Comment comment;
+      comment.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+      comment.authorId = "author";
+      comment.content = QString("评论%1").arg(i);
+      comment.createdAt = QDateTime::currentDateTimeUtc();
+      ASSERT_TRUE(store.append(postId, comment));
+    }
+    const auto summary = store.summary(postId);
+    EXPECT_EQ(summary.count, 5);
+    ASSERT_EQ(summary.recent.size(), CommentStore::kRecentComments);
+    EXPECT_EQ(summary.recent.last().content, "评论4");
+
+    int total = 0;
+    const auto page = store.read(postId, 1, 2, &total);
+    EXPECT_EQ(total, 5);
+    ASSERT_EQ(page.size(), 2);
+    EXPECT_EQ(page[0].content, "评论1");
+    EXPECT_EQ(page[1].content, "评论2");
+    EXPECT_TRUE(store.read(postId, 5, 2).isEmpty());
+  }
+
+  // 模拟写到一半崩溃：末尾残留不完整的一行
+  QFile file(QDir(envPath).filePath("comments/" + postId.toString() + ".jsonl"));
+  ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Append));
+  file.write("{\"authorId\":\"x\",\"con");
+  file.close();
+
+  CommentStore reopened{QDir(envPath)};
+  EXPECT_EQ(reopened.summary(postId).count, 5);
+  Comment extra;
+  extra.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+  extra.content = "恢复后追加";
+  ASSERT_TRUE(reopened.append(postId, extra));
+  const auto all = reopened.read(postId, 0, -1);
+  ASSERT_EQ(all.size(), 6);
+  EXPECT_EQ(all.last().content, "恢复后追加");
+
+  QDir(envPath).removeRecursively();
+}
+
+// 用例：旧版数据内嵌在动态中的评论在加载时迁入评论库，之后的评论不再改写作者文件。
+TEST(CommentStoreTests, LegacyEmbeddedCommentsMigrateOnLoad) {
+  const QString envPath = QDir::tempPath() + "/bk_comment_migrate_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+
+  UserData legacy;
+  legacy.profile.id = "legacy-user";
+  legacy.profile.username = "legacy";
+  legacy.profile.email = "legacy@example.com";
+  SocialPost post;
+  post.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+  post.authorId = legacy.profile.id;
+  post.content = "旧动态";
+  post.createdAt = QDateTime::currentDateTimeUtc();
+  for (int i = 0; i < 4; ++i) {
+    Comment comment;
+    comment.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    comment.authorId = legacy.profile.id;
+    comment.content = QString("旧评论%1").arg(i);
+    comment.createdAt = post.createdAt.addSecs(i);
+    post.comments.push_back(comment);
+  }
+  legacy.putPost(post);
+  {
+    JsonStorage storage{QDir(envPath)};
+    ASSERT_TRUE(storage.saveUser(legacy));
+  }
+  const QString userFile = QDir(envPath).filePath(JsonStorage::relativeFilePath("legacy-user"));
+  QFile before(userFile);
+  ASSERT_TRUE(before.open(QIODevice::ReadOnly));
+  const QByteArray bytesBefore = before.readAll();
+  before.close();
+
+  LedgerService service{QDir(envPath)};
+  const auto timeline = service.timeline("legacy-user");
+  ASSERT_EQ(timeline.size(), 1);
+  EXPECT_EQ(timeline.first().commentCount, 4);
+  ASSERT_EQ(timeline.first().comments.size(), CommentStore::kRecentComments);
+  EXPECT_EQ(timeline.first().comments.last().content, "旧评论3");
+  EXPECT_EQ(service.postComments("legacy-user", "legacy-user", post.id).size(), 4);
+
+  QString err;
+  ASSERT_TRUE(service.addComment("legacy-user", "legacy-user", post.id, "新评论", err)) << err.toStdString();
+  EXPECT_EQ(service.timeline("legacy-user").first().commentCount, 5);
+  // 评论只追加到评论串，作者的数据文件保持不变
+  QFile after(userFile);
+  ASSERT_TRUE(after.open(QIODevice::ReadOnly));
+  EXPECT_EQ(after.readAll(), bytesBefore);
+
+  // 重新打开后迁移不会重复导入
+  LedgerService reload{QDir(envPath)};
+  EXPECT_EQ(reload.timeline("legacy-user").first().commentCount, 5);
+
+  QDir(envPath).removeRecursively();
+}
+
+// 用例：缓存的评论串数受上限约束，被丢弃的串再次访问时从文件重新扫描。
+TEST(CommentStoreTests, EvictsIdleThreadsBeyondCacheLimit) {
+  const QString envPath = QDir::tempPath() + "/bk_comment_cache_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+  CommentStore store{QDir(envPath), DurabilityOptions{false, 0}};
+  store.setThreadCacheLimit(4);
+
+  QVector<EntityId> posts;
+  for (int i = 0; i < 20; ++i) {
+    posts.push_back(QUuid::createUuid().toString(QUuid::WithoutBraces));
+    for (int j = 0; j <= i % 3; ++j) {
+      Comment comment;
+      comment.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+      comment.content = QString("评论%1-%2").arg(i).arg(j);
+      ASSERT_TRUE(store.append(posts.last(), comment));
+    }
+    EXPECT_LE(store.cachedThreads(), 4);
+  }
+  for (int i = 0; i < posts.size(); ++i) {
+    EXPECT_EQ(store.summary(posts[i]).count, i % 3 + 1);
+  }
+  EXPECT_LE(store.cachedThreads(), 4);
+
+  QDir(envPath).removeRecursively();
+}
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QUuid>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "core/LedgerService.h"
+#include "core/UserExecutor.h"
+
+using namespace core;
+
+/* 测试按用户串行的并发模型与快照读取 共3个测试样例 */
+
+// 用例：多线程并发为同一用户写入账单，不能出现丢失更新。
+TEST(ConcurrencyTests, ConcurrentUpsertsForSameUserAreNotLost) {
+  const QString envPath = QDir::tempPath() + "/bk_concurrency_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  qputenv("BOOKEEPER_DATA_DIR", envPath.toUtf8());
+  QDir(envPath).removeRecursively();
+
+  LedgerService service;
+  QString aliceId;
+  QString bobId;
+  QString err;
+  ASSERT_TRUE(service.registerUser("alice_c", "alice_c@example.com", "p", aliceId, err)) << err.toStdString();
+  ASSERT_TRUE(service.registerUser("bob_c", "bob_c@example.com", "p", bobId, err)) << err.toStdString();
+  const EntityId aliceCat = service.categories(aliceId).first().id;
+  const EntityId bobCat = service.categories(bobId).first().id;
+
+  constexpr int kThreads = 8;
+  constexpr int kPerThread = 10;
+  std::atomic<int> failures{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&, t] {
+      // 偶数线程写 alice，奇数线程写 bob，两个用户并行推进。
+      const bool forAlice = t % 2 == 0;
+      for (int i = 0; i < kPerThread; ++i) {
+        Bill bill;
+        bill.categoryId = forAlice ? aliceCat : bobCat;
+        bill.amount = 1.0;
+        QString message;
+        if (!service.upsertBill(forAlice ? aliceId : bobId, bill, message)) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_EQ(failures.load(), 0);
+  EXPECT_EQ(service.bills(aliceId).size(), kThreads / 2 * kPerThread);
+  EXPECT_EQ(service.bills(bobId).size(), kThreads / 2 * kPerThread);
+  EXPECT_DOUBLE_EQ(service.totalExpense(aliceId), kThreads / 2 * kPerThread * 1.0);
+
+  QDir(envPath).removeRecursively();
+}
+
+// 用例：同一执行器上的任务不并发；多用户独占期间单用户任务被挂起，嵌套调用可重入。
+TEST(ConcurrencyTests, ExecutorsSerializePerUserAndSupportExclusiveSections) {
+  UserExecutors executors(4);
+  int counterA = 0;
+  int counterB = 0;
+  std::atomic<int> insideA{0};
+  std::atomic<bool> overlapped{false};
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&] {
+      for (int i = 0; i < 200; ++i) {
+        if (i % 20 == 0) {
+          executors.runExclusive({"b", "a"}, [&] {
+            ++counterB;
+            // 已独占 a 时再次在 a 上运行应直接执行而不是死锁。
+            executors.run("a", [&] { ++counterA; });
+          });
+          continue;
+        }
+        executors.run("a", [&] {
+          if (insideA.fetch_add(1) != 0) {
+            overlapped = true;
+          }
+          ++counterA;
+          insideA.fetch_sub(1);
+        });
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  EXPECT_FALSE(overlapped.load());
+  EXPECT_EQ(counterA, 4 * 200);
+  EXPECT_EQ(counterB, 4 * 10);
+
+  // 一次性访问大量用户后，空闲执行器被回收而不是常驻。
+  for (int i = 0; i < 500; ++i) {
+    executors.run(QString("visitor-%1").arg(i), [] {});
+  }
+  EXPECT_LT(executors.size(), 500);
+}
+
+// 用例：读者持有的快照在后续提交后保持不变，提交会原子替换为新快照。
+TEST(ConcurrencyTests, SnapshotsStayImmutableAcrossCommits) {
+  const QString envPath = QDir::tempPath() + "/bk_snapshot_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  qputenv("BOOKEEPER_DATA_DIR", envPath.toUtf8());
+  QDir(envPath).removeRecursively();
+
+  LedgerService service;
+  QString userId;
+  QString err;
+  ASSERT_TRUE(service.registerUser("snap", "snap@example.com", "p", userId, err)) << err.toStdString();
+
+  const auto before = service.snapshot(userId);
+  ASSERT_TRUE(before != nullptr);
+  // 无写入时重复读取得到同一快照。
+  EXPECT_EQ(service.snapshot(userId), before);
+  EXPECT_TRUE(before->bills.isEmpty());
+
+  Bill bill;
+  bill.categoryId = before->categories.first().id;
+  bill.amount = 12.0;
+  ASSERT_TRUE(service.upsertBill(userId, bill, err)) << err.toStdString();
+
+  const auto after = service.snapshot(userId);
+  EXPECT_NE(after, before);
+  EXPECT_TRUE(before->bills.isEmpty());
+  ASSERT_EQ(after->bills.size(), 1);
+  EXPECT_DOUBLE_EQ(after->bills.first().amount, 12.0);
+
+  EXPECT_TRUE(service.snapshot("no-such-user") == nullptr);
+
+  QDir(envPath).removeRecursively();
+}
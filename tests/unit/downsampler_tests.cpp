@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <QPointF>
+#include <QVector>
+
+#include <cmath>
+
+#include "core/Downsampler.h"
+
+using namespace core;
+
+/* 测试长序列降采样：点数受限、首尾保留、尖峰不丢 共2个测试样例 */
+
+namespace {
+
+// 十年逐日数据：平滑波动加一个单日尖峰。
+QVector<QPointF> dailySeries(int days, int spikeAt) {
+  QVector<QPointF> points;
+  for (int i = 0; i < days; ++i) {
+    points.push_back(
+        QPointF(i, i == spikeAt ? 5000.0 : 100.0 + 50.0 * std::sin(i / 30.0)));
+  }
+  return points;
+}
+
+bool strictlyIncreasingX(const QVector<QPointF> &points) {
+  for (int i = 1; i < points.size(); ++i) {
+    if (!(points[i - 1].x() < points[i].x())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool containsY(const QVector<QPointF> &points, double y) {
+  for (const auto &point : points) {
+    if (point.y() == y) {
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace
+
+// 用例：LTTB 返回恰好 threshold 个点，保留首尾与尖峰，短序列原样返回。
+TEST(DownsamplerTests, LttbKeepsShapeWithinThreshold) {
+  const auto points = dailySeries(3650, 1234);
+  const auto sampled = Downsampler::lttb(points, 800);
+  ASSERT_EQ(sampled.size(), 800);
+  EXPECT_EQ(sampled.first(), points.first());
+  EXPECT_EQ(sampled.last(), points.last());
+  EXPECT_TRUE(strictlyIncreasingX(sampled));
+  EXPECT_TRUE(containsY(sampled, 5000.0));
+
+  const auto shortSeries = dailySeries(7, -1);
+  EXPECT_EQ(Downsampler::lttb(shortSeries, 800), shortSeries);
+  EXPECT_EQ(Downsampler::lttb(points, 2), points);
+}
+
+// 用例：min/max 每桶至多两个点，极值一定保留。
+TEST(DownsamplerTests, MinMaxKeepsExtremesPerBucket) {
+  auto points = dailySeries(3650, 2000);
+  points[10].setY(-300.0);
+  const auto sampled = Downsampler::minMax(points, 300);
+  EXPECT_LE(sampled.size(), 600);
+  EXPECT_GE(sampled.size(), 300);
+  EXPECT_TRUE(strictlyIncreasingX(sampled));
+  EXPECT_TRUE(containsY(sampled, 5000.0));
+  EXPECT_TRUE(containsY(sampled, -300.0));
+
+  const auto flat = QVector<QPointF>(1000, QPointF(5.0, 1.0));
+  EXPECT_EQ(Downsampler::minMax(flat, 10).size(), 2);
+}
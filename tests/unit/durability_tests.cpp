@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QUuid>
+
+#include <thread>
+#include <vector>
+
+#include "core/GroupCommit.h"
+#include "core/JsonStorage.h"
+
+using namespace core;
+
+/* 测试原子写入、组提交与中断恢复 共3个测试样例 */
+
+// 用例：多线程并发保存被合并成更少的刷盘批次，且全部数据完整落盘。
+TEST(DurabilityTests, ConcurrentSavesAreGroupCommitted) {
+  const QString envPath = QDir::tempPath() + "/bk_durable_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+  JsonStorage storage{QDir(envPath)};
+
+  constexpr int kThreads = 8;
+  constexpr int kPerThread = 20;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&storage, t] {
+      for (int i = 0; i < kPerThread; ++i) {
+        UserData data;
+        data.profile.id = QString("u%1").arg(t);
+        data.profile.username = QString("user-%1-%2").arg(t).arg(i);
+        ASSERT_TRUE(storage.saveUser(data));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+
+  const auto stats = storage.commitStats();
+  EXPECT_EQ(stats.tickets, static_cast<quint64>(kThreads * kPerThread));
+  EXPECT_LE(stats.batches, stats.tickets);
+  EXPECT_GE(stats.batches, 1u);
+
+  for (int t = 0; t < kThreads; ++t) {
+    UserData loaded;
+    ASSERT_TRUE(storage.loadUser(QString("u%1").arg(t), loaded));
+    EXPECT_EQ(loaded.profile.username, QString("user-%1-%2").arg(t).arg(kPerThread - 1));
+    const QFileInfo file(QDir(envPath).filePath(JsonStorage::relativeFilePath(loaded.profile.id)));
+    EXPECT_TRUE(file.dir().entryList({"*.tmp", "*.bak"}, QDir::Files).isEmpty());
+  }
+
+  QDir(envPath).removeRecursively();
+}
+
+// 用例：启动时恢复中断提交留下的备份文件，并清理残留的临时文件。
+TEST(DurabilityTests, RecoversInterruptedCommit) {
+  const QString envPath = QDir::tempPath() + "/bk_recover_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+  {
+    JsonStorage storage{QDir(envPath)};
+    UserData data;
+    data.profile.id = "u1";
+    data.profile.username = "before";
+    ASSERT_TRUE(storage.saveUser(data));
+  }
+
+  // 模拟崩溃：原文件已被移为备份，新文件只写了一半的临时文件。
+  const QString userFile = QDir(envPath).filePath(JsonStorage::relativeFilePath("u1"));
+  const QDir dir = QFileInfo(userFile).dir();
+  ASSERT_TRUE(QFile::rename(userFile, userFile + ".bak"));
+  QFile partial(userFile + ".7.tmp");
+  ASSERT_TRUE(partial.open(QIODevice::WriteOnly));
+  partial.write("{\"profile\":");
+  partial.close();
+
+  JsonStorage storage{QDir(envPath)};
+  UserData loaded;
+  ASSERT_TRUE(storage.loadUser("u1", loaded));
+  EXPECT_EQ(loaded.profile.username, "before");
+  EXPECT_TRUE(dir.entryList({"*.tmp", "*.bak"}, QDir::Files).isEmpty());
+
+  QDir(envPath).removeRecursively();
+}
+
+// 用例：多文件提交在两次重命名之间崩溃时，按意图标记把两个文件都回滚。
+TEST(DurabilityTests, RollsBackMultiFileCommitInterruptedBetweenRenames) {
+  const QString envPath = QDir::tempPath() + "/bk_intent_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+  const QDir dir(envPath);
+  ASSERT_TRUE(dir.mkpath("."));
+  const QString a = dir.filePath("a.json");
+  const QString b = dir.filePath("b.json");
+  const QString c = dir.filePath("c.json");
+  const auto read = [](const QString &path) {
+    QFile file(path);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+  };
+
+  GroupCommitter committer;
+  ASSERT_TRUE(committer.commit({FileWrite{a, "old-a"}, FileWrite{b, "old-b"}}));
+  EXPECT_TRUE(dir.entryList({"*.intent", "*.bak", "*.tmp"}, QDir::Files).isEmpty());
+
+  // 模拟崩溃：标记已落盘，a 已换成新版本并留有备份，b 与新建的 c 尚未替换。
+  QFile intent(dir.filePath("a.json.9.intent"));
+  ASSERT_TRUE(intent.open(QIODevice::WriteOnly));
+  intent.write(("=" + a + "\n=" + b + "\n+" + c + "\n").toUtf8());
+  intent.close();
+  ASSERT_TRUE(QFile::rename(a, a + ".bak"));
+  for (const auto &path : {a, b + ".7.tmp", c + ".8.tmp"}) {
+    QFile file(path);
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write("new");
+  }
+
+  GroupCommitter::recoverDirectory(envPath);
+  EXPECT_EQ(read(a), QByteArray("old-a"));
+  EXPECT_EQ(read(b), QByteArray("old-b"));
+  EXPECT_FALSE(QFile::exists(c));
+  EXPECT_TRUE(dir.entryList({"*.intent", "*.bak", "*.tmp"}, QDir::Files).isEmpty());
+
+  QDir(envPath).removeRecursively();
+}
@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <QSet>
+#include <QUuid>
+
+#include "core/Entities.h"
+
+using namespace core;
+
+/* 测试 128 位实体 ID 与可见范围枚举 共3个测试样例 */
+
+// 用例：UUID 文本解析为数值、其他文本走驻留表，两者都能原样还原。
+TEST(EntityIdTests, RoundTripsUuidAndInternedText) {
+  static_assert(sizeof(EntityId) == 16, "EntityId 应为 128 位");
+
+  const QString uuid = QUuid::createUuid().toString(QUuid::WithoutBraces);
+  const EntityId parsed(uuid);
+  EXPECT_FALSE(parsed.isEmpty());
+  EXPECT_FALSE(parsed.isInterned());
+  EXPECT_EQ(parsed.toString(), uuid);
+  EXPECT_EQ(parsed, EntityId(uuid));
+
+  // 大写、带括号或全零的 UUID 文本不做数值解析，以保证还原结果一致。
+  const QString upper = uuid.toUpper();
+  EXPECT_TRUE(EntityId(upper).isInterned());
+  EXPECT_EQ(EntityId(upper).toString(), upper);
+  const QString nil = QUuid().toString(QUuid::WithoutBraces);
+  EXPECT_EQ(EntityId(nil).toString(), nil);
+  EXPECT_FALSE(EntityId(nil).isEmpty());
+
+  const EntityId shortId("b1");
+  EXPECT_TRUE(shortId.isInterned());
+  EXPECT_EQ(shortId.toString(), "b1");
+  EXPECT_EQ(shortId, EntityId(QStringLiteral("b1")));
+  EXPECT_NE(shortId, EntityId("b2"));
+
+  EXPECT_TRUE(EntityId().isEmpty());
+  EXPECT_TRUE(EntityId(QString()).isEmpty());
+  EXPECT_TRUE(EntityId().toString().isEmpty());
+
+  QSet<EntityId> ids;
+  ids.insert(parsed);
+  ids.insert(shortId);
+  ids.insert(EntityId("b1"));
+  EXPECT_EQ(ids.size(), 2);
+  EXPECT_TRUE(ids.contains(EntityId(uuid)));
+}
+
+// 用例：实体 JSON 仍以文本表示 ID 与可见范围，无法识别的可见范围按仅好友处理。
+TEST(EntityIdTests, JsonBoundaryKeepsTextForm) {
+  Bill bill;
+  bill.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+  bill.categoryId = "legacy-category";
+  const auto obj = bill.toJson();
+  EXPECT_EQ(obj.value("id").toString(), bill.id.toString());
+  EXPECT_EQ(obj.value("categoryId").toString(), "legacy-category");
+  EXPECT_EQ(Bill::fromJson(obj).categoryId, bill.categoryId);
+
+  SocialPost post;
+  post.visibility = PostVisibility::Friends;
+  EXPECT_EQ(post.toJson().value("visibility").toString(), "friends");
+  QJsonObject legacy;
+  EXPECT_EQ(SocialPost::fromJson(legacy).visibility, PostVisibility::Public);
+  legacy["visibility"] = "secret";
+  EXPECT_EQ(SocialPost::fromJson(legacy).visibility, PostVisibility::Friends);
+
+  PostVisibility parsed = PostVisibility::Public;
+  EXPECT_TRUE(parseVisibility("friends", parsed));
+  EXPECT_EQ(parsed, PostVisibility::Friends);
+  EXPECT_FALSE(parseVisibility("everyone", parsed));
+}
+
+// 用例：不登记的查找只认 UUID 与已驻留的文本；驻留 ID 按文本排序。
+TEST(EntityIdTests, LookupDoesNotInternAndOrderFollowsText) {
+  const QString unseen =
+      "unseen-" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  EntityId found("stale");
+  EXPECT_FALSE(EntityId::lookup(unseen, found));
+  EXPECT_EQ(found, EntityId("stale"));
+  EXPECT_FALSE(EntityId::lookup(unseen, found));
+
+  const QString uuid = QUuid::createUuid().toString(QUuid::WithoutBraces);
+  ASSERT_TRUE(EntityId::lookup(uuid, found));
+  EXPECT_EQ(found, EntityId(uuid));
+  ASSERT_TRUE(EntityId::lookup(QString(), found));
+  EXPECT_TRUE(found.isEmpty());
+  const EntityId known(unseen);
+  ASSERT_TRUE(EntityId::lookup(unseen, found));
+  EXPECT_EQ(found, known);
+
+  // 后登记的 "a-…" 仍排在先登记的 "z-…" 之前。
+  const QString suffix = QUuid::createUuid().toString(QUuid::WithoutBraces);
+  const EntityId first("z-" + suffix);
+  const EntityId second("a-" + suffix);
+  EXPECT_TRUE(second < first);
+  EXPECT_FALSE(first < second);
+  EXPECT_FALSE(second < second);
+}
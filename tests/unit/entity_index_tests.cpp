@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+
+#include "core/Entities.h"
+
+using namespace core;
+
+/* 测试 UserData 的 ID 索引维护 共2个测试样例 */
+
+namespace {
+
+Bill billWithId(const QString &id, double amount = 1.0) {
+  Bill bill;
+  bill.id = id;
+  bill.amount = amount;
+  return bill;
+}
+
+}  // namespace
+
+// 用例：插入、替换与交换删除后索引始终指向正确下标。
+TEST(EntityIndexTests, PutAndEraseKeepIndexInSync) {
+  UserData data;
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_EQ(data.putBill(billWithId(QString("b%1").arg(i))), i);
+  }
+  EXPECT_EQ(data.putBill(billWithId("b2", 9.0)), 2);
+  EXPECT_EQ(data.bills.size(), 5);
+  EXPECT_DOUBLE_EQ(data.bills[2].amount, 9.0);
+
+  // 删除 b1 后末尾的 b4 移入其位置。
+  data.eraseBillAt(data.findBill("b1"));
+  ASSERT_EQ(data.bills.size(), 4);
+  EXPECT_EQ(data.findBill("b1"), -1);
+  EXPECT_EQ(data.findBill("b4"), 1);
+  for (int i = 0; i < data.bills.size(); ++i) {
+    EXPECT_EQ(data.findBill(data.bills[i].id), i);
+  }
+  data.eraseBillAt(data.findBill("b3"));
+  EXPECT_EQ(data.findBill("b3"), -1);
+  EXPECT_EQ(data.bills.size(), 3);
+
+  // 分类删除保持顺序。
+  for (const auto &id : {"c1", "c2", "c3"}) {
+    Category category;
+    category.id = id;
+    data.putCategory(category);
+  }
+  data.eraseCategoryAt(data.findCategory("c1"));
+  ASSERT_EQ(data.categories.size(), 2);
+  EXPECT_EQ(data.categories[0].id, "c2");
+  EXPECT_EQ(data.findCategory("c3"), 1);
+}
+
+// 用例：直接改动容器后查找仍正确，写入接口会先重建索引。
+TEST(EntityIndexTests, DirectContainerEditsFallBackAndRebuild) {
+  UserData data;
+  data.putBill(billWithId("a"));
+  data.bills.push_back(billWithId("b"));
+  EXPECT_EQ(data.findBill("b"), 1);
+  EXPECT_EQ(data.findBill("missing"), -1);
+
+  EXPECT_EQ(data.putBill(billWithId("c")), 2);
+  EXPECT_EQ(data.findBill("b"), 1);
+  EXPECT_EQ(data.billIndex.size(), 3);
+
+  Reminder reminder;
+  reminder.id = "r";
+  data.reminders.push_back(reminder);
+  SocialPost post;
+  post.id = "p";
+  data.posts.push_back(post);
+  data.reindex();
+  EXPECT_EQ(data.reminderIndex.size(), 1);
+  EXPECT_EQ(data.findPost("p"), 0);
+  data.eraseReminderAt(0);
+  EXPECT_TRUE(data.reminders.isEmpty());
+  EXPECT_EQ(data.findReminder("r"), -1);
+
+  // 重复的 ID 在重建时只保留第一个，索引重新与容器对齐。
+  data.bills.push_back(billWithId("a", 5.0));
+  data.bills.push_back(billWithId("d"));
+  data.reindex();
+  ASSERT_EQ(data.bills.size(), 4);
+  EXPECT_EQ(data.billIndex.size(), 4);
+  EXPECT_DOUBLE_EQ(data.bills[data.findBill("a")].amount, 1.0);
+  EXPECT_EQ(data.findBill("d"), 3);
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QUuid>
+
+#include <chrono>
+#include <thread>
+
+#include "core/Footprint.h"
+#include "core/LedgerService.h"
+#include "core/SnapshotStore.h"
+
+using namespace core;
+
+/* 测试用户内存占用估算与快照缓存的内存预算 共3个测试样例 */
+
+namespace {
+
+UserSnapshot makeSnapshot(const QString &userId, int bills) {
+  auto data = std::make_shared<UserData>();
+  data->profile.id = userId;
+  for (int i = 0; i < bills; ++i) {
+    Bill bill;
+    bill.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+    bill.amount = i;
+    bill.note = QString("note %1").arg(i);
+    data->putBill(bill);
+  }
+  data->rollups = CalendarRollups::build(data->bills);
+  return data;
+}
+
+}  // namespace
+
+// 用例：估算按分区随数据增长；服务端报告给出已缓存用户的内存与磁盘占用。
+TEST(FootprintTests, SectionsGrowWithDataAndReportDiskBytes) {
+  UserData data;
+  const auto empty = MemoryFootprint::of(data);
+  EXPECT_EQ(empty.bills + empty.notes + empty.posts + empty.comments, 0);
+  EXPECT_GT(empty.other, 0);
+
+  const auto withBills = MemoryFootprint::of(*makeSnapshot("u", 100));
+  EXPECT_GT(withBills.bills, 100 * static_cast<qint64>(sizeof(Bill)));
+  EXPECT_GT(withBills.notes, 0);
+  EXPECT_EQ(withBills.comments, 0);
+
+  SocialPost post;
+  post.id = QUuid::createUuid().toString(QUuid::WithoutBraces);
+  post.content = "动态";
+  post.comments.resize(3);
+  for (auto &comment : post.comments) {
+    comment.content = QString(200, QChar('x'));
+  }
+  data.putPost(post);
+  const auto withPost = MemoryFootprint::of(data);
+  EXPECT_GT(withPost.posts, 0);
+  EXPECT_GT(withPost.comments, 3 * 200 * static_cast<qint64>(sizeof(QChar)));
+
+  const QString envPath = QDir::tempPath() + "/bk_footprint_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+  {
+    LedgerService service{QDir(envPath)};
+    QString userId;
+    QString err;
+    ASSERT_TRUE(service.registerUser("heavy", "heavy@example.com", "p", userId, err)) << err.toStdString();
+    const auto footprints = service.footprints();
+    ASSERT_EQ(footprints.size(), 1);
+    EXPECT_EQ(footprints[0].userId, userId);
+    EXPECT_TRUE(footprints[0].cached);
+    EXPECT_GT(footprints[0].diskBytes, 0);
+    EXPECT_EQ(service.memoryGauge().cachedBytes, footprints[0].memory.total());
+  }
+  // 新实例未缓存任何快照，报告临时读文件估算
+  LedgerService cold{QDir(envPath)};
+  const auto footprints = cold.footprints();
+  ASSERT_EQ(footprints.size(), 1);
+  EXPECT_FALSE(footprints[0].cached);
+  EXPECT_GT(footprints[0].memory.total(), 0);
+  EXPECT_EQ(cold.memoryGauge().cachedUsers, 0);
+
+  QDir(envPath).removeRecursively();
+}
+
+// 用例：超出预算时逐出最久未访问的快照，刚访问过与刚发布的快照保留。
+TEST(FootprintTests, BudgetEvictsLeastRecentlyUsedSnapshot) {
+  using namespace std::chrono_literals;
+  SnapshotStore store;
+  const qint64 size = MemoryFootprint::of(*makeSnapshot("a", 200)).total();
+  store.setMemoryBudget(size * 5 / 2);
+
+  store.publish("a", makeSnapshot("a", 200));
+  std::this_thread::sleep_for(3ms);
+  store.publish("b", makeSnapshot("b", 200));
+  std::this_thread::sleep_for(3ms);
+  ASSERT_TRUE(store.current("a"));
+  std::this_thread::sleep_for(3ms);
+  EXPECT_EQ(store.gauge().evictions, 0u);
+
+  store.publish("c", makeSnapshot("c", 200));
+  EXPECT_TRUE(store.peek("a"));
+  EXPECT_FALSE(store.peek("b"));
+  EXPECT_TRUE(store.peek("c"));
+  const auto gauge = store.gauge();
+  EXPECT_EQ(gauge.evictions, 1u);
+  EXPECT_EQ(gauge.cachedUsers, 2);
+  EXPECT_LE(gauge.cachedBytes, gauge.budgetBytes);
+
+  store.invalidate("a");
+  EXPECT_EQ(store.gauge().cachedBytes,
+            MemoryFootprint::of(*store.peek("c")).total());
+}
+
+// 用例：未命中读盘期间有新快照发布并随即被逐出时，读到的旧数据不能发布。
+TEST(FootprintTests, StaleLoadIsNotPublishedAfterEviction) {
+  SnapshotStore store;
+  const qint64 size = MemoryFootprint::of(*makeSnapshot("a", 200)).total();
+  const quint64 before = store.generation("a");
+  EXPECT_EQ(before, 0u);
+
+  // 读者开始读盘后，写者提交并发布，随后预算迫使其被逐出。
+  store.publish("a", makeSnapshot("a", 200));
+  store.setMemoryBudget(size / 2);
+  ASSERT_FALSE(store.peek("a"));
+
+  EXPECT_FALSE(store.publishIfAbsent("a", makeSnapshot("a", 1), before));
+  EXPECT_FALSE(store.peek("a"));
+
+  // 按当前代数重新读盘的结果可以发布；已有快照时返回现有快照。
+  store.setMemoryBudget(0);
+  const auto fresh = makeSnapshot("a", 200);
+  const quint64 now = store.generation("a");
+  EXPECT_EQ(store.publishIfAbsent("a", fresh, now), fresh);
+  EXPECT_EQ(store.publishIfAbsent("a", makeSnapshot("a", 1), now), fresh);
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUuid>
+
+#include "core/LedgerService.h"
+#include "server/ApiRouter.h"
+#include "server/HttpMessage.h"
+
+using namespace core;
+using namespace server;
+
+/* 测试服务端的 HTTP 解析与 JSON 路由 共3个测试样例 */
+
+namespace {
+
+QByteArray rawRequest(const QByteArray &method, const QByteArray &path,
+                      const QByteArray &body = {},
+                      const QByteArray &extraHeaders = {}) {
+  return method + " " + path + " HTTP/1.1\r\nHost: localhost\r\n" +
+         extraHeaders + "Content-Length: " + QByteArray::number(body.size()) +
+         "\r\n\r\n" + body;
+}
+
+}  // namespace
+
+// 用例：同一缓冲区内的多条流水线请求按顺序解析，半截请求等待后续字节。
+TEST(HttpApiTest, ParserHandlesPipelinedAndPartialRequests) {
+  HttpRequestParser parser;
+  const auto second = rawRequest("POST", "/api/login", "{\"a\":1}",
+                                 "Connection: close\r\n");
+  parser.feed(rawRequest("GET", "/api/users/u1/bills?x=1") +
+              second.left(second.size() - 3));
+
+  HttpRequest request;
+  ASSERT_TRUE(parser.next(request));
+  EXPECT_EQ(request.method, "GET");
+  EXPECT_EQ(request.path, "/api/users/u1/bills");
+  EXPECT_EQ(request.query, "x=1");
+  EXPECT_TRUE(request.keepAlive);
+
+  // 第二条请求体尚未收全。
+  EXPECT_FALSE(parser.next(request));
+  parser.feed(second.right(3));
+  ASSERT_TRUE(parser.next(request));
+  EXPECT_EQ(request.method, "POST");
+  EXPECT_EQ(request.body, "{\"a\":1}");
+  EXPECT_FALSE(request.keepAlive);
+  EXPECT_EQ(parser.pendingBytes(), 0);
+
+  HttpRequestParser broken;
+  broken.feed("garbage\r\n\r\n");
+  EXPECT_FALSE(broken.next(request));
+  EXPECT_TRUE(broken.hasError());
+}
+
+// 用例：通过路由完成注册、查询分类、写入账单与读取汇总。
+TEST(HttpApiTest, RouterServesLedgerOperations) {
+  const QString envPath = QDir::tempPath() + "/bk_http_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+
+  LedgerService service{QDir(envPath)};
+  ApiRouter router(&service);
+
+  QByteArray token;
+  auto call = [&](const QByteArray &method, const QString &path,
+                  const QJsonObject &body = {}) {
+    HttpRequest request;
+    request.method = method;
+    request.path = path;
+    if (!token.isEmpty()) {
+      request.headers.insert("authorization", "Bearer " + token);
+    }
+    if (!body.isEmpty()) {
+      request.body = QJsonDocument(body).toJson(QJsonDocument::Compact);
+    }
+    return router.handle(request);
+  };
+
+  QJsonObject reg;
+  reg["username"] = "http_user";
+  reg["email"] = "http@example.com";
+  reg["password"] = "pw";
+  auto response = call("POST", "/api/register", reg);
+  ASSERT_EQ(response.status, 200) << response.body.toStdString();
+  const auto registered = QJsonDocument::fromJson(response.body).object();
+  const auto userId = registered.value("userId").toString();
+  ASSERT_FALSE(userId.isEmpty());
+
+  // 用户资源须携带注册或登录时签发的令牌，且令牌只对本人有效。
+  EXPECT_EQ(call("GET", QString("/api/users/%1/categories").arg(userId)).status,
+            401);
+  reg["username"] = "http_other";
+  reg["email"] = "other@example.com";
+  token = QJsonDocument::fromJson(call("POST", "/api/register", reg).body)
+              .object()
+              .value("token")
+              .toString()
+              .toLatin1();
+  ASSERT_FALSE(token.isEmpty());
+  EXPECT_EQ(call("GET", QString("/api/users/%1/categories").arg(userId)).status,
+            401);
+  QJsonObject login;
+  login["login"] = "http_user";
+  login["password"] = "pw";
+  response = call("POST", "/api/login", login);
+  ASSERT_EQ(response.status, 200) << response.body.toStdString();
+  token = QJsonDocument::fromJson(response.body)
+              .object()
+              .value("token")
+              .toString()
+              .toLatin1();
+  EXPECT_EQ(token, registered.value("token").toString().toLatin1());
+
+  response = call("GET", QString("/api/users/%1/categories").arg(userId));
+  ASSERT_EQ(response.status, 200);
+  const auto categories = QJsonDocument::fromJson(response.body).array();
+  ASSERT_FALSE(categories.isEmpty());
+
+  QJsonObject bill;
+  bill["categoryId"] = categories.first().toObject().value("id").toString();
+  bill["amount"] = 42.5;
+  bill["type"] = "expense";
+  response = call("POST", QString("/api/users/%1/bills").arg(userId), bill);
+  ASSERT_EQ(response.status, 200) << response.body.toStdString();
+
+  response = call("GET", QString("/api/users/%1/summary").arg(userId));
+  ASSERT_EQ(response.status, 200);
+  EXPECT_DOUBLE_EQ(
+      QJsonDocument::fromJson(response.body).object().value("expense").toDouble(),
+      42.5);
+
+  // 业务错误以 400 与错误文案返回，未知路径返回 404。
+  bill["categoryId"] = "missing";
+  response = call("POST", QString("/api/users/%1/bills").arg(userId), bill);
+  EXPECT_EQ(response.status, 400);
+  EXPECT_EQ(QJsonDocument::fromJson(response.body).object().value("error").toString(),
+            "分类不存在");
+  EXPECT_EQ(call("GET", "/api/nothing").status, 404);
+
+  // 既非 UUID 也未加载过的 ID 直接拒绝，不登记到驻留表。
+  const QString unseen = "unseen-" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  EXPECT_EQ(call("DELETE", QString("/api/users/%1/bills/%2").arg(userId, unseen)).status, 404);
+  EntityId ignored;
+  EXPECT_FALSE(EntityId::lookup(unseen, ignored));
+
+  QDir(envPath).removeRecursively();
+}
+
+// 用例：端点名称折叠用户与条目 ID，应答报文包含长度与连接头。
+TEST(HttpApiTest, EndpointNameAndResponseSerialization) {
+  EXPECT_EQ(endpointName("DELETE", "/api/users/abc/bills/b1"),
+            "DELETE /api/users/:id/bills/:itemId");
+  EXPECT_EQ(endpointName("POST", "/api/login"), "POST /api/login");
+
+  HttpResponse response;
+  response.body = "{}";
+  response.keepAlive = false;
+  const auto raw = response.serialize();
+  EXPECT_TRUE(raw.startsWith("HTTP/1.1 200 OK\r\n"));
+  EXPECT_TRUE(raw.contains("Content-Length: 2\r\n"));
+  EXPECT_TRUE(raw.contains("Connection: close\r\n"));
+  EXPECT_TRUE(raw.endsWith("\r\n\r\n{}"));
+}
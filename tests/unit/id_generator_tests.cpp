@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSet>
+#include <QUuid>
+
+#include <thread>
+#include <vector>
+
+#include "core/IdGenerator.h"
+
+using namespace core;
+
+/* 测试按时间递增的 ID 生成器 共2个测试样例 */
+
+// 用例：同一线程内 ID 严格递增，时钟回拨与计数器耗尽时仍不倒退。
+TEST(IdGeneratorTests, IdsAreMonotonicWithinThread) {
+  // 在独立线程中运行，避免把未来的时间戳留在主线程的生成器状态里。
+  std::thread worker([] {
+    const qint64 base = QDateTime::currentMSecsSinceEpoch() + 60 * 1000;
+    EntityId previous = IdGenerator::next(base);
+    EXPECT_EQ(IdGenerator::timestampOf(previous), base);
+    for (int i = 0; i < 10000; ++i) {
+      // 时间戳固定甚至回拨，只能依靠计数器递增。
+      const EntityId id = IdGenerator::next(i % 2 == 0 ? base : base - 5);
+      ASSERT_TRUE(previous < id);
+      EXPECT_GE(IdGenerator::timestampOf(id), base);
+      previous = id;
+    }
+    const EntityId later = IdGenerator::next(base + 1000);
+    EXPECT_TRUE(previous < later);
+    EXPECT_TRUE(IdGenerator::floorFor(base + 1000) < later);
+    EXPECT_TRUE(later < IdGenerator::floorFor(base + 1001));
+
+    // 文本仍是版本 7 的小写 UUID，并能无损解析回数值形式。
+    const QString text = later.toString();
+    EXPECT_EQ(text.size(), 36);
+    EXPECT_EQ(text.at(14), QLatin1Char('7'));
+    EXPECT_FALSE(EntityId(text).isInterned());
+    EXPECT_EQ(EntityId(text), later);
+  });
+  worker.join();
+
+  EXPECT_EQ(IdGenerator::timestampOf(EntityId("b1")), -1);
+  EXPECT_EQ(IdGenerator::timestampOf(QUuid::createUuid().toString(QUuid::WithoutBraces)), -1);
+}
+
+// 用例：多线程并发生成的 ID 互不重复。
+TEST(IdGeneratorTests, IdsAreUniqueAcrossThreads) {
+  constexpr int kThreads = 4;
+  constexpr int kPerThread = 20000;
+  QMutex mutex;
+  QSet<EntityId> ids;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&] {
+      QVector<EntityId> local;
+      local.reserve(kPerThread);
+      for (int i = 0; i < kPerThread; ++i) {
+        local.push_back(IdGenerator::next());
+      }
+      QMutexLocker locker(&mutex);
+      for (const auto &id : local) {
+        ids.insert(id);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(ids.size(), kThreads * kPerThread);
+}
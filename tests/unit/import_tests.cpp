@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+
+#include <QBuffer>
+#include <QDir>
+#include <QUuid>
+
+#include "core/CsvImporter.h"
+#include "core/LedgerService.h"
+
+using namespace core;
+
+/* 测试批量导入与 CSV 解析 共2个测试样例 */
+
+// 用例：批量导入按 ID 去重、拒绝未知分类，并只保留合法行。
+TEST(ImportTests, ImportBillsDedupesAndRejectsUnknownCategories) {
+  const QString envPath = QDir::tempPath() + "/bk_import_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  qputenv("BOOKEEPER_DATA_DIR", envPath.toUtf8());
+  QDir(envPath).removeRecursively();
+
+  LedgerService service;
+  QString userId;
+  QString err;
+  ASSERT_TRUE(service.registerUser("importer", "importer@example.com", "p", userId, err)) << err.toStdString();
+  const QString catId = service.categories(userId).first().id.toString();
+
+  Bill existing;
+  existing.id = "b1";
+  existing.categoryId = catId;
+  existing.amount = 1.0;
+  ASSERT_TRUE(service.upsertBill(userId, existing, err)) << err.toStdString();
+
+  QVector<Bill> rows;
+  for (int i = 0; i < 5; ++i) {
+    Bill bill;
+    bill.categoryId = catId;
+    bill.amount = 10.0;
+    rows.push_back(bill);
+  }
+  Bill overwrite = existing;
+  overwrite.amount = 99.0;
+  rows.push_back(overwrite);
+  Bill unknown;
+  unknown.categoryId = "missing";
+  rows.push_back(unknown);
+
+  ImportReport report;
+  ASSERT_TRUE(service.importBills(userId, rows, report, err)) << err.toStdString();
+  EXPECT_EQ(report.rows, 7);
+  EXPECT_EQ(report.inserted, 5);
+  EXPECT_EQ(report.updated, 1);
+  EXPECT_EQ(report.rejected, 1);
+  EXPECT_EQ(report.errors.size(), 1);
+  EXPECT_GT(report.rowsPerSecond, 0.0);
+
+  const auto bills = service.bills(userId);
+  ASSERT_EQ(bills.size(), 6);
+  EXPECT_EQ(bills.first().id, "b1");
+  EXPECT_DOUBLE_EQ(bills.first().amount, 99.0);
+
+  QDir(envPath).removeRecursively();
+}
+
+// 用例：CSV 支持表头、引号字段、分类名称与负金额，坏行进入报告。
+TEST(ImportTests, CsvImportParsesQuotedFieldsAndCategoryNames) {
+  const QString envPath = QDir::tempPath() + "/bk_import_csv_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  qputenv("BOOKEEPER_DATA_DIR", envPath.toUtf8());
+  QDir(envPath).removeRecursively();
+
+  LedgerService service;
+  QString userId;
+  QString err;
+  ASSERT_TRUE(service.registerUser("csv", "csv@example.com", "p", userId, err)) << err.toStdString();
+
+  const auto fields = CsvBillImporter::splitRecord("a,\"b,c\",\"say \"\"hi\"\"\"");
+  ASSERT_EQ(fields.size(), 3);
+  EXPECT_EQ(fields.at(1), "b,c");
+  EXPECT_EQ(fields.at(2), "say \"hi\"");
+
+  QByteArray csv;
+  csv += "timestamp,amount,type,category,note,id\n";
+  csv += "2025-01-02T08:00:00,-25.5,,餐饮,\"早餐, 咖啡\",exp-1\n";
+  csv += "2025-01-03 09:30,5000,收入,工资,一月工资,\n";
+  csv += "not-a-date,1,expense,餐饮,坏行,\n";
+  csv += "2025-01-04,3,expense,不存在,未知分类,\n";
+  QBuffer buffer(&csv);
+
+  ImportReport report;
+  ASSERT_TRUE(service.importCsv(userId, buffer, report, err)) << err.toStdString();
+  EXPECT_EQ(report.rows, 4);
+  EXPECT_EQ(report.inserted, 2);
+  EXPECT_EQ(report.rejected, 2);
+
+  const auto bills = service.bills(userId);
+  ASSERT_EQ(bills.size(), 2);
+  EXPECT_EQ(bills.first().id, "exp-1");
+  EXPECT_EQ(bills.first().type, BillType::Expense);
+  EXPECT_DOUBLE_EQ(bills.first().amount, 25.5);
+  EXPECT_EQ(bills.first().note, "早餐, 咖啡");
+  EXPECT_EQ(bills.last().type, BillType::Income);
+  EXPECT_DOUBLE_EQ(service.totalIncome(userId), 5000.0);
+
+  QDir(envPath).removeRecursively();
+}
@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include "core/JsonReader.h"
+#include "core/JsonStorage.h"
+
+using namespace core;
+
+/* 测试流式 JSON 读取器与 QJsonDocument 解析结果的一致性 共2个测试样例 */
+
+namespace {
+
+// 旧的读法：先解析成 QJsonObject 树再逐个实体转换，作为对照。
+bool decodeViaTree(const QByteArray &bytes, UserData &out) {
+  const auto doc = QJsonDocument::fromJson(bytes);
+  if (!doc.isObject()) {
+    return false;
+  }
+  const QJsonObject obj = doc.object();
+  out.profile = UserProfile::fromJson(obj.value("profile").toObject());
+  for (const auto &value : obj.value("categories").toArray()) {
+    out.categories.push_back(Category::fromJson(value.toObject()));
+  }
+  for (const auto &value : obj.value("bills").toArray()) {
+    out.bills.push_back(Bill::fromJson(value.toObject()));
+  }
+  for (const auto &value : obj.value("reminders").toArray()) {
+    out.reminders.push_back(Reminder::fromJson(value.toObject()));
+  }
+  for (const auto &value : obj.value("posts").toArray()) {
+    out.posts.push_back(SocialPost::fromJson(value.toObject()));
+  }
+  if (!CalendarRollups::fromJson(obj.value("rollups").toObject(),
+                                 out.rollups) ||
+      out.rollups.billCount() != out.bills.size()) {
+    out.rollups = CalendarRollups::build(out.bills);
+  }
+  out.reindex();
+  return true;
+}
+
+// 覆盖转义、\u 代理对、多字节 UTF-8、各种数字写法、类型不符与未知键。
+const char kDocument[] = R"({
+  "unknown": {"nested": [1, 2, {"x": null}]},
+  "profile": {
+    "id": "u-1", "username": "小明 \"q\" 😀",
+    "email": "a\\b\/c@example.com", "friendIds": ["f1", 7, "好友\t2"],
+    "passwordHash": 42, "privacyLevel": "friends"
+  },
+  "categories": [
+    {"id": "c-1", "name": "餐饮", "type": "expense"},
+    {"id": "c-2", "name": "Salary"}
+  ],
+  "bills": [
+    {"id": "b-1", "amount": 12.5, "categoryId": "c-1", "note": "午餐",
+     "timestamp": "2024-03-01T08:30:15Z", "type": "expense"},
+    {"id": "b-2", "amount": -0, "categoryId": "c-2", "note": "午餐",
+     "timestamp": "2024-03-01T16:30:15+08:00", "type": "income"},
+    {"id": "b-3", "amount": 1.5e3, "note": "line\nbreak\u0001",
+     "timestamp": "not a date", "type": 3},
+    {"id": "b-4", "amount": "12", "categoryId": "c-1",
+     "timestamp": "2024-03-02T08:30:15.250Z"},
+    {"id": "b-5", "amount": 0.1E-2, "categoryId": "c-1"},
+    {"id": "b-6", "amount": 123456789012345678901234567890}
+  ],
+  "reminders": {"not": "an array"},
+  "posts": [
+    {"id": "p-1", "authorId": "u-1", "content": "今天省钱了",
+     "visibility": "friends", "createdAt": "2024-03-01T08:30:15Z",
+     "comments": [{"id": "m-1", "authorId": "f1", "content": "nice"}]},
+    {"id": "p-2", "comments": null}
+  ],
+  "rollups": {"stale": true}
+})";
+
+}  // namespace
+
+// 用例：流式解码与 QJsonDocument 逐实体解码得到相同的数据，紧凑与缩进
+// 两种风格的文件也都能读回。
+TEST(JsonReaderTests, MatchesQJsonDocumentDecoding) {
+  const QByteArray bytes(kDocument);
+  UserData expected;
+  ASSERT_TRUE(decodeViaTree(bytes, expected));
+  UserData streamed;
+  ASSERT_TRUE(JsonStorage::decode(bytes, streamed));
+
+  // 重新编码后逐字节比较，覆盖全部字段。
+  EXPECT_EQ(JsonStorage::encode(streamed), JsonStorage::encode(expected));
+  EXPECT_EQ(streamed.profile.username,
+            QString::fromUtf8("小明 \"q\" \xF0\x9F\x98\x80"));
+  ASSERT_EQ(streamed.bills.size(), 6);
+  EXPECT_DOUBLE_EQ(streamed.bills[2].amount, 1500);
+  EXPECT_DOUBLE_EQ(streamed.bills[4].amount, 0.001);
+  EXPECT_EQ(streamed.bills[1].type, BillType::Income);
+  EXPECT_EQ(streamed.rollups.billCount(), 6);
+  EXPECT_TRUE(streamed.reminders.isEmpty());
+
+  for (auto style : {JsonWriter::Style::Compact, JsonWriter::Style::Indented}) {
+    const QByteArray encoded = JsonStorage::encode(expected, style);
+    UserData again;
+    ASSERT_TRUE(JsonStorage::decode(encoded, again));
+    EXPECT_EQ(JsonStorage::encode(again, style), encoded);
+  }
+}
+
+// 用例：不合法的文件整体拒绝；同一次读取中重复的短字符串共享存储。
+TEST(JsonReaderTests, RejectsMalformedInputAndPoolsStrings) {
+  const char *malformed[] = {
+      "",
+      "[]",
+      R"({"profile": {"id": "u"}} x)",
+      R"({"bills": [{"id": "b"},]})",
+      R"({"profile": {"id": "u})",
+      R"({"bills": [{"amount": 01}]})",
+      R"({"profile": {"id": "\x"}})",
+      R"({"profile" {"id": "u"}})",
+  };
+  for (const char *text : malformed) {
+    UserData data;
+    EXPECT_FALSE(JsonStorage::decode(QByteArray(text), data)) << text;
+    EXPECT_FALSE(QJsonDocument::fromJson(QByteArray(text)).isObject()) << text;
+  }
+
+  const QByteArray deep = QByteArray(2000, '[') + QByteArray(2000, ']');
+  JsonReader reader(deep);
+  reader.skipValue();
+  EXPECT_FALSE(reader.ok());
+
+  UserData data;
+  ASSERT_TRUE(JsonStorage::decode(QByteArray(kDocument), data));
+  EXPECT_EQ(data.bills[0].note.constData(), data.bills[1].note.constData());
+}
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 
 #include <QDir>
+#include <QFile>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QUuid>
@@ -10,7 +11,7 @@
 
 using namespace core;
 
-/* 测试 JsonStorage 的保存与读取完整性，确保序列化/反序列化字段不丢失。共1个测试样例 */
+/* 测试 JsonStorage 的保存与读取完整性，确保序列化/反序列化字段不丢失。共2个测试样例 */
 
 // 中文注释：验证 JsonStorage 的保存与读取完整性，确保序列化/反序列化字段不丢失。
 TEST(JsonStorageTest, SaveAndLoadUserDataRoundTrip) {
@@ -59,7 +60,7 @@ TEST(JsonStorageTest, SaveAndLoadUserDataRoundTrip) {
   post.id = "post-1";
   post.authorId = data.profile.id;
   post.content = "公开动态";
-  post.visibility = "public";
+  post.visibility = PostVisibility::Public;
   post.createdAt = QDateTime::fromSecsSinceEpoch(1700002000);
   Comment comment;
   comment.id = "cmt-1";
@@ -106,3 +107,62 @@ TEST(JsonStorageTest, SaveAndLoadUserDataRoundTrip) {
   // 5) 清理临时目录
   QDir(envPath).removeRecursively();
 }
+
+// 用例：旧版平铺在数据目录下的用户文件迁入分片目录；清单丢失时重建，
+// 末尾写了一半的登记被忽略，删除用户后重新打开不再列出。
+TEST(JsonStorageTest, MigratesFlatLayoutIntoShardsWithManifest) {
+  const QString envPath = QDir::tempPath() + "/bk_shards_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+  QDir().mkpath(envPath);
+  const QDir root(envPath);
+
+  const QStringList ids = {"u3", "u1", "u2"};
+  for (const auto &id : ids) {
+    UserData data;
+    data.profile.id = id;
+    data.profile.username = "name-" + id;
+    QFile file(root.filePath(id + ".json"));
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+    file.write(JsonStorage::encode(data));
+  }
+  QFile blob(root.filePath("u1.search"));
+  ASSERT_TRUE(blob.open(QIODevice::WriteOnly));
+  blob.write("index");
+  blob.close();
+
+  {
+    JsonStorage storage{root};
+    EXPECT_TRUE(root.entryList({"*.json", "*.search"}, QDir::Files).isEmpty());
+    EXPECT_TRUE(QFile::exists(root.filePath(JsonStorage::relativeFilePath("u2"))));
+    EXPECT_EQ(storage.userIds(), QStringList({"u1", "u2", "u3"}));
+    QByteArray bytes;
+    ASSERT_TRUE(storage.loadBlob("u1", "search", bytes));
+    EXPECT_EQ(bytes, "index");
+    const auto profiles = storage.listUsers();
+    ASSERT_EQ(profiles.size(), 3);
+    EXPECT_EQ(profiles[0].username, "name-u1");
+  }
+
+  // 清单被删除后从分片目录重建；崩溃留下的半行登记不算作用户
+  ASSERT_TRUE(QFile::remove(root.filePath("users.manifest")));
+  {
+    JsonStorage storage{root};
+    EXPECT_EQ(storage.userIds().size(), 3);
+  }
+  QFile manifest(root.filePath("users.manifest"));
+  ASSERT_TRUE(manifest.open(QIODevice::WriteOnly | QIODevice::Append));
+  manifest.write("+u9");
+  manifest.close();
+  {
+    JsonStorage storage{root};
+    EXPECT_EQ(storage.userIds(), QStringList({"u1", "u2", "u3"}));
+    ASSERT_TRUE(storage.removeUser("u2"));
+    UserData fresh;
+    fresh.profile.id = "u0";
+    ASSERT_TRUE(storage.saveUser(fresh));
+  }
+  JsonStorage reopened{root};
+  EXPECT_EQ(reopened.userIds(), QStringList({"u0", "u1", "u3"}));
+
+  QDir(envPath).removeRecursively();
+}
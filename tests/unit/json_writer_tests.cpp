@@ -0,0 +1,191 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QUuid>
+
+#include <cmath>
+#include <limits>
+
+#include "core/IdGenerator.h"
+#include "core/JsonStorage.h"
+#include "core/JsonWriter.h"
+
+using namespace core;
+
+/* 测试流式 JSON 写出器与 QJsonDocument 输出的一致性 共2个测试样例 */
+
+namespace {
+
+// 旧的写法：先构造 QJsonObject 树再整体输出，作为对照。
+QJsonObject buildTree(const UserData &data) {
+  QJsonObject obj;
+  obj["profile"] = data.profile.toJson();
+  QJsonArray categories;
+  for (const auto &category : data.categories) {
+    categories.append(category.toJson());
+  }
+  obj["categories"] = categories;
+  QJsonArray bills;
+  for (const auto &bill : data.bills) {
+    bills.append(bill.toJson());
+  }
+  obj["bills"] = bills;
+  QJsonArray reminders;
+  for (const auto &reminder : data.reminders) {
+    reminders.append(reminder.toJson());
+  }
+  obj["reminders"] = reminders;
+  QJsonArray posts;
+  for (const auto &post : data.posts) {
+    posts.append(post.toJson());
+  }
+  obj["posts"] = posts;
+  obj["rollups"] = data.rollups.toJson();
+  return obj;
+}
+
+UserData sampleData() {
+  UserData data;
+  data.profile.id = IdGenerator::next().toString();
+  data.profile.username = QStringLiteral("小明 \"quote\"");
+  data.profile.email = "a\\b@example.com";
+  data.profile.passwordHash = "hash";
+  data.profile.friendIds << "friend-1" << QStringLiteral("好友\t2");
+
+  Category category;
+  category.id = IdGenerator::next();
+  category.name = QStringLiteral("餐饮😀");
+  category.type = "expense";
+  data.categories.push_back(category);
+  Category legacy;
+  legacy.id = "cat-legacy";
+  legacy.name = "Salary";
+  legacy.type = "income";
+  data.categories.push_back(legacy);
+
+  const double amounts[] = {12, 12.5, -0.1, 999999, 1e7, 1234567.89, 0};
+  const QDateTime base(QDate(2024, 3, 1), QTime(8, 30, 15), Qt::UTC);
+  int i = 0;
+  for (double amount : amounts) {
+    Bill bill;
+    bill.id = IdGenerator::next();
+    bill.amount = amount;
+    bill.categoryId = i % 2 == 0 ? category.id : legacy.id;
+    bill.note = QString("line\nbreak %1 \x01").arg(i);
+    switch (i % 3) {
+      case 0:
+        bill.timestamp = base.addDays(i);
+        break;
+      case 1:
+        bill.timestamp = base.addDays(i).toOffsetFromUtc(8 * 3600);
+        break;
+      default:
+        bill.timestamp = base.addDays(i).toLocalTime();
+        break;
+    }
+    bill.type = i % 2 == 0 ? BillType::Expense : BillType::Income;
+    data.bills.push_back(bill);
+    ++i;
+  }
+  Bill undated;
+  undated.id = "bill-undated";
+  undated.categoryId = legacy.id;
+  undated.amount = 3;
+  data.bills.push_back(undated);
+  data.rollups = CalendarRollups::build(data.bills);
+
+  Reminder reminder;
+  reminder.id = IdGenerator::next();
+  reminder.message = "pay rent";
+  reminder.remindAt = base;
+  reminder.enabled = false;
+  data.reminders.push_back(reminder);
+
+  SocialPost post;
+  post.id = IdGenerator::next();
+  post.authorId = data.profile.id;
+  post.content = QStringLiteral("今天省钱了");
+  post.visibility = PostVisibility::Friends;
+  post.createdAt = base;
+  Comment comment;
+  comment.id = IdGenerator::next();
+  comment.authorId = "friend-1";
+  comment.content = "nice";
+  comment.createdAt = base.addSecs(60);
+  post.comments.push_back(comment);
+  data.posts.push_back(post);
+  SocialPost empty;
+  empty.id = "post-empty";
+  data.posts.push_back(empty);
+  return data;
+}
+
+}  // namespace
+
+// 用例：缩进与紧凑两种风格的输出解析后都与 QJsonDocument 相同；金额都能
+// 被二进制精确表示时逐字节一致（其余浮点数的写法随 Qt 版本不同）。
+TEST(JsonWriterTests, MatchesQJsonDocumentByteForByte) {
+  UserData data = sampleData();
+  QJsonDocument tree(buildTree(data));
+  EXPECT_EQ(QJsonDocument::fromJson(
+                JsonStorage::encode(data, JsonWriter::Style::Indented)),
+            tree);
+  EXPECT_EQ(QJsonDocument::fromJson(
+                JsonStorage::encode(data, JsonWriter::Style::Compact)),
+            tree);
+
+  for (auto &bill : data.bills) {
+    bill.amount = std::floor(bill.amount);
+  }
+  data.rollups = CalendarRollups::build(data.bills);
+  tree = QJsonDocument(buildTree(data));
+  EXPECT_EQ(JsonStorage::encode(data, JsonWriter::Style::Indented),
+            tree.toJson(QJsonDocument::Indented));
+  EXPECT_EQ(JsonStorage::encode(data, JsonWriter::Style::Compact),
+            tree.toJson(QJsonDocument::Compact));
+
+  // 空用户数据同样一致，覆盖空数组的写法。
+  const UserData blank;
+  EXPECT_EQ(JsonStorage::encode(blank),
+            QJsonDocument(buildTree(blank)).toJson());
+
+  JsonWriter out(JsonWriter::Style::Compact);
+  out.beginArray();
+  out.value(std::numeric_limits<double>::infinity());
+  out.value(QLatin1String("x"));
+  out.value(-42);
+  out.endArray();
+  EXPECT_EQ(out.take(), QByteArray("[null,\"x\",-42]"));
+}
+
+// 用例：流式写出的文件可以被 loadUser 完整读回。
+TEST(JsonWriterTests, SavedFileLoadsBack) {
+  const QString envPath = QDir::tempPath() + "/bk_writer_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+  JsonStorage storage{QDir(envPath)};
+
+  const UserData data = sampleData();
+  ASSERT_TRUE(storage.saveUser(data));
+  UserData loaded;
+  ASSERT_TRUE(storage.loadUser(data.profile.id, loaded));
+
+  EXPECT_EQ(loaded.profile.username, data.profile.username);
+  EXPECT_EQ(loaded.profile.friendIds, data.profile.friendIds);
+  ASSERT_EQ(loaded.bills.size(), data.bills.size());
+  for (int i = 0; i < data.bills.size(); ++i) {
+    EXPECT_EQ(loaded.bills[i].id, data.bills[i].id);
+    EXPECT_DOUBLE_EQ(loaded.bills[i].amount, data.bills[i].amount);
+    EXPECT_EQ(loaded.bills[i].note, data.bills[i].note);
+    EXPECT_EQ(loaded.bills[i].timestamp, data.bills[i].timestamp);
+  }
+  ASSERT_EQ(loaded.posts.size(), 2);
+  EXPECT_EQ(loaded.posts.first().visibility, PostVisibility::Friends);
+  ASSERT_EQ(loaded.posts.first().comments.size(), 1);
+  EXPECT_EQ(loaded.rollups.billCount(), data.bills.size());
+  EXPECT_FALSE(loaded.reminders.first().enabled);
+
+  QDir(envPath).removeRecursively();
+}
@@ -25,7 +25,7 @@ TEST(LedgerBillTest, CreateUpdateDeleteAndTotals) {
   ASSERT_TRUE(service.registerUser("u1", "u1@example.com", "p", userId, err)) << err.toStdString();
   const auto cats = service.categories(userId);
   ASSERT_FALSE(cats.isEmpty());
-  const QString catId = cats.first().id;
+  const QString catId = cats.first().id.toString();
 
   // 3) 新增一条收入、一条支出
   Bill income; income.categoryId = catId; income.type = BillType::Income; income.amount = 100.0;
@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QThreadPool>
+#include <QUuid>
+
+#include <atomic>
+
+#include "core/JsonStorage.h"
+#include "core/LedgerService.h"
+#include "core/MapReduce.h"
+
+using namespace core;
+
+/* 测试跨用户的并行 map-reduce 与系统报表 共2个测试样例 */
+
+// 用例：每个条目恰好处理一次，结果与顺序执行一致；工作者数不超过线程池上限。
+TEST(MapReduceTests, ProcessesEveryItemOnceWithBoundedWorkers) {
+  QVector<int> items(10000);
+  for (int i = 0; i < items.size(); ++i) {
+    items[i] = i + 1;
+  }
+  QThreadPool pool;
+  pool.setMaxThreadCount(4);
+  std::atomic<int> calls{0};
+  std::atomic<int> merges{0};
+  const qint64 sum = mapReduce<qint64>(
+      items,
+      [&](int value) {
+        ++calls;
+        return static_cast<qint64>(value);
+      },
+      [](qint64 &acc, qint64 &&value) { acc += value; },
+      [&](qint64 &acc, qint64 &&partial) {
+        ++merges;
+        acc += partial;
+      },
+      &pool);
+  EXPECT_EQ(sum, 10000LL * 10001 / 2);
+  EXPECT_EQ(calls.load(), 10000);
+  EXPECT_LE(merges.load(), 3);
+
+  // 空输入直接返回初始值
+  const qint64 empty = mapReduce<qint64>(
+      QVector<int>(), [](int value) { return static_cast<qint64>(value); },
+      [](qint64 &acc, qint64 &&value) { acc += value; },
+      [](qint64 &acc, qint64 &&partial) { acc += partial; }, &pool);
+  EXPECT_EQ(empty, 0);
+}
+
+// 用例：系统报表汇总所有用户，同名分类跨用户合并；并行的 listUsers 按 ID 排序。
+TEST(MapReduceTests, SystemReportMergesCategoriesAcrossUsers) {
+  const QString envPath = QDir::tempPath() + "/bk_report_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  QDir(envPath).removeRecursively();
+
+  LedgerService service{QDir(envPath)};
+  QString err;
+  for (int u = 0; u < 6; ++u) {
+    QString userId;
+    const QString name = QString("report%1").arg(u);
+    ASSERT_TRUE(service.registerUser(name, name + "@example.com", "p", userId, err)) << err.toStdString();
+    const auto categories = service.categories(userId);
+    for (const auto &category : categories) {
+      Bill bill;
+      bill.categoryId = category.id;
+      bill.amount = 10.0;
+      bill.type = category.type == "income" ? BillType::Income : BillType::Expense;
+      ASSERT_TRUE(service.upsertBill(userId, bill, err)) << err.toStdString();
+    }
+  }
+
+  const auto report = service.systemReport();
+  EXPECT_EQ(report.users, 6);
+  EXPECT_EQ(report.bills, 6 * 5);
+  EXPECT_DOUBLE_EQ(report.income, 6 * 10.0);
+  EXPECT_DOUBLE_EQ(report.expense, 6 * 4 * 10.0);
+  ASSERT_EQ(report.categories.size(), 5);
+  for (const auto &summary : report.categories) {
+    EXPECT_TRUE(summary.categoryId.isEmpty());
+    EXPECT_DOUBLE_EQ(summary.income + summary.expense, 6 * 10.0) << summary.name.toStdString();
+  }
+  // 支出降序，收入分类排在最后
+  EXPECT_EQ(report.categories.last().name, "工资");
+
+  // 新的服务实例不经快照缓存，直接读文件得到同样的结果
+  LedgerService cold{QDir(envPath)};
+  EXPECT_DOUBLE_EQ(cold.systemReport().expense, report.expense);
+
+  const auto profiles = JsonStorage{QDir(envPath)}.listUsers();
+  ASSERT_EQ(profiles.size(), 6);
+  for (int i = 1; i < profiles.size(); ++i) {
+    EXPECT_LT(profiles[i - 1].id, profiles[i].id);
+  }
+
+  QDir(envPath).removeRecursively();
+}
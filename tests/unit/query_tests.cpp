@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QUuid>
+
+#include "core/BillQuery.h"
+#include "core/LedgerService.h"
+
+using namespace core;
+
+/* 测试账单过滤表达式的编译、求值与分组 共3个测试样例 */
+
+namespace {
+
+QVector<Category> sampleCategories() {
+  Category food;
+  food.id = "c1";
+  food.name = "餐饮";
+  food.type = "expense";
+  Category traffic;
+  traffic.id = "c2";
+  traffic.name = "交通";
+  traffic.type = "expense";
+  Category salary;
+  salary.id = "c3";
+  salary.name = "工资";
+  salary.type = "income";
+  return {food, traffic, salary};
+}
+
+Bill makeBill(const QString &id, const QString &categoryId, BillType type,
+              double amount, const QDate &date, const QString &note = QString()) {
+  Bill bill;
+  bill.id = id;
+  bill.categoryId = categoryId;
+  bill.type = type;
+  bill.amount = amount;
+  bill.note = note;
+  bill.timestamp = QDateTime(date, QTime(9, 0));
+  return bill;
+}
+
+}  // namespace
+
+// 用例：组合条件按时间裁剪后逐级过滤，结果按时间升序。
+TEST(QueryTests, FiltersWithCombinedClauses) {
+  const QDate today(2025, 5, 20);
+  // 故意乱序插入，验证时间序下标。
+  const QVector<Bill> bills = {
+      makeBill("b3", "c2", BillType::Expense, 150.0, QDate(2025, 2, 10), "Taxi 去机场"),
+      makeBill("b1", "c1", BillType::Expense, 120.0, QDate(2025, 1, 5), "聚餐"),
+      makeBill("b4", "c2", BillType::Expense, 80.0, QDate(2025, 3, 1), "taxi"),
+      makeBill("b2", "c3", BillType::Income, 5000.0, QDate(2025, 1, 31)),
+      makeBill("b5", "c2", BillType::Expense, 200.0, QDate(2025, 4, 2), "taxi 回家"),
+  };
+  const auto order = BillQuery::timeOrder(bills);
+
+  BillQuery query;
+  QString err;
+  ASSERT_TRUE(BillQuery::compile(
+      "type = expense and category in (餐饮, 交通) and amount > 100 "
+      "and date in last_quarter and note contains \"TAXI\"",
+      sampleCategories(), query, err, today)) << err.toStdString();
+  auto result = query.run(bills, order);
+  ASSERT_EQ(result.bills.size(), 1);
+  EXPECT_EQ(result.bills[0].id, "b3");
+
+  ASSERT_TRUE(BillQuery::compile("date >= 2025-01-01 and date < 2025-03-01",
+                                 sampleCategories(), query, err, today));
+  result = query.run(bills, order);
+  ASSERT_EQ(result.bills.size(), 3);
+  EXPECT_EQ(result.bills[0].id, "b1");
+  EXPECT_EQ(result.bills[1].id, "b2");
+  EXPECT_EQ(result.bills[2].id, "b3");
+  EXPECT_DOUBLE_EQ(result.totals.income, 5000.0);
+  EXPECT_DOUBLE_EQ(result.totals.expense, 270.0);
+
+  ASSERT_TRUE(BillQuery::compile("category != c2 and type != income",
+                                 sampleCategories(), query, err, today));
+  result = query.run(bills, order);
+  ASSERT_EQ(result.bills.size(), 1);
+  EXPECT_EQ(result.bills[0].id, "b1");
+
+  // 空表达式匹配全部账单。
+  ASSERT_TRUE(BillQuery::compile("", sampleCategories(), query, err, today));
+  EXPECT_EQ(query.run(bills, order).bills.size(), bills.size());
+}
+
+// 用例：group by 按分类、日与月聚合求和。
+TEST(QueryTests, GroupsAndSums) {
+  const QVector<Bill> bills = {
+      makeBill("b1", "c1", BillType::Expense, 10.0, QDate(2025, 1, 5)),
+      makeBill("b2", "c1", BillType::Expense, 15.0, QDate(2025, 1, 5)),
+      makeBill("b3", "c2", BillType::Expense, 7.0, QDate(2025, 2, 1)),
+      makeBill("b4", "c3", BillType::Income, 100.0, QDate(2025, 2, 3)),
+  };
+  const auto order = BillQuery::timeOrder(bills);
+  BillQuery query;
+  QString err;
+
+  ASSERT_TRUE(BillQuery::compile("group by month", sampleCategories(), query, err));
+  auto result = query.run(bills, order);
+  ASSERT_EQ(result.groups.size(), 2);
+  EXPECT_EQ(result.groups[0].key, "2025-01");
+  EXPECT_DOUBLE_EQ(result.groups[0].totals.expense, 25.0);
+  EXPECT_EQ(result.groups[1].key, "2025-02");
+  EXPECT_DOUBLE_EQ(result.groups[1].totals.income, 100.0);
+
+  ASSERT_TRUE(BillQuery::compile("type = 支出 group by category", sampleCategories(), query, err));
+  result = query.run(bills, order);
+  ASSERT_EQ(result.groups.size(), 2);
+  EXPECT_EQ(result.groups[0].key, "c1");
+  EXPECT_EQ(result.groups[0].totals.count, 2);
+  EXPECT_DOUBLE_EQ(result.groups[1].totals.expense, 7.0);
+
+  ASSERT_TRUE(BillQuery::compile("amount <= 10 group by day", sampleCategories(), query, err));
+  result = query.run(bills, order);
+  ASSERT_EQ(result.groups.size(), 2);
+  EXPECT_EQ(result.groups[0].key, "2025-01-05");
+  EXPECT_EQ(result.groups[0].totals.count, 1);
+}
+
+// 用例：语法错误与未知分类返回错误信息；服务层接口在快照上执行查询。
+TEST(QueryTests, ReportsErrorsAndRunsThroughService) {
+  BillQuery query;
+  QString err;
+  EXPECT_FALSE(BillQuery::compile("amount >", sampleCategories(), query, err));
+  EXPECT_FALSE(err.isEmpty());
+  EXPECT_FALSE(BillQuery::compile("category in (不存在)", sampleCategories(), query, err));
+  EXPECT_FALSE(BillQuery::compile("date in next_century", sampleCategories(), query, err));
+  EXPECT_FALSE(BillQuery::compile("note contains \"taxi", sampleCategories(), query, err));
+  EXPECT_FALSE(BillQuery::compile("group by month and type = income", sampleCategories(), query, err));
+
+  const QString envPath = QDir::tempPath() + "/bk_query_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  qputenv("BOOKEEPER_DATA_DIR", envPath.toUtf8());
+  QDir(envPath).removeRecursively();
+
+  LedgerService service;
+  QString userId;
+  ASSERT_TRUE(service.registerUser("query", "query@example.com", "p", userId, err)) << err.toStdString();
+  const QDate today = QDate::currentDate();
+  QString foodId;
+  for (const auto &category : service.categories(userId)) {
+    if (category.name == "餐饮") {
+      foodId = category.id.toString();
+    }
+  }
+  ASSERT_TRUE(service.upsertBill(userId, makeBill("b1", foodId, BillType::Expense, 30.0, today), err));
+  ASSERT_TRUE(service.upsertBill(userId, makeBill("b2", foodId, BillType::Expense, 300.0, today), err));
+
+  BillQueryResult result;
+  ASSERT_TRUE(service.queryBills(userId, "category = 餐饮 and amount > 100 and date in today", result, err)) << err.toStdString();
+  ASSERT_EQ(result.bills.size(), 1);
+  EXPECT_EQ(result.bills[0].id, "b2");
+
+  // 写入后新快照上的查询能看到新账单。
+  ASSERT_TRUE(service.upsertBill(userId, makeBill("b3", foodId, BillType::Expense, 500.0, today), err));
+  ASSERT_TRUE(service.queryBills(userId, "amount > 100", result, err));
+  EXPECT_EQ(result.bills.size(), 2);
+  EXPECT_FALSE(service.queryBills(userId, "bogus = 1", result, err));
+
+  QDir(envPath).removeRecursively();
+}
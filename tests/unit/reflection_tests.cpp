@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include <QDataStream>
+#include <QJsonArray>
+#include <QJsonObject>
+
+#include "core/EntityFields.h"
+#include "core/IdGenerator.h"
+
+using namespace core;
+
+/* 测试由字段表生成的 JSON 与二进制编解码 共2个测试样例 */
+
+// 用例：生成的 JSON 与原有格式一致，缺失字段取默认值，未知键被忽略。
+TEST(ReflectionTests, JsonMatchesLegacyLayoutAndDefaults) {
+  Bill bill;
+  bill.id = IdGenerator::next();
+  bill.amount = 42.5;
+  bill.categoryId = "cat-1";
+  bill.note = "lunch";
+  bill.timestamp = QDateTime(QDate(2024, 5, 6), QTime(7, 8, 9), Qt::UTC);
+  bill.type = BillType::Income;
+
+  const QJsonObject json = bill.toJson();
+  EXPECT_EQ(json.keys(), (QStringList{"amount", "categoryId", "id", "note",
+                                      "timestamp", "type"}));
+  EXPECT_EQ(json.value("id").toString(), bill.id.toString());
+  EXPECT_EQ(json.value("timestamp").toString(), "2024-05-06T07:08:09Z");
+  EXPECT_EQ(json.value("type").toString(), "income");
+
+  const Bill decoded = Bill::fromJson(json);
+  EXPECT_EQ(decoded.id, bill.id);
+  EXPECT_DOUBLE_EQ(decoded.amount, bill.amount);
+  EXPECT_EQ(decoded.categoryId, bill.categoryId);
+  EXPECT_EQ(decoded.timestamp, bill.timestamp);
+  EXPECT_EQ(decoded.type, BillType::Income);
+
+  // 字段缺失、类型不符与多余的键。
+  QJsonObject sparse;
+  sparse["aaa"] = 1;
+  sparse["name"] = 7;
+  sparse["zzz"] = "ignored";
+  const Category category = Category::fromJson(sparse);
+  EXPECT_TRUE(category.id.isEmpty());
+  EXPECT_TRUE(category.name.isEmpty());
+  EXPECT_EQ(category.type, "expense");
+
+  const Reminder reminder = Reminder::fromJson(QJsonObject());
+  EXPECT_TRUE(reminder.enabled);
+  const UserProfile profile = UserProfile::fromJson(QJsonObject());
+  EXPECT_TRUE(profile.notificationsEnabled);
+  EXPECT_EQ(profile.privacyLevel, "friends");
+
+  QJsonObject post;
+  post["visibility"] = "secret";
+  QJsonObject comment;
+  comment["content"] = "hi";
+  post["comments"] = QJsonArray{comment};
+  const SocialPost decodedPost = SocialPost::fromJson(post);
+  EXPECT_EQ(decodedPost.visibility, PostVisibility::Friends);
+  ASSERT_EQ(decodedPost.comments.size(), 1);
+  EXPECT_EQ(decodedPost.comments.first().content, "hi");
+  EXPECT_EQ(SocialPost::fromJson(QJsonObject()).visibility,
+            PostVisibility::Public);
+}
+
+// 用例：二进制编码可往返，驻留 ID 以文本保存，损坏的数量被拒绝。
+TEST(ReflectionTests, BinaryRoundTrip) {
+  SocialPost post;
+  post.id = IdGenerator::next();
+  post.authorId = "legacy-author";
+  post.content = QStringLiteral("今天省钱了");
+  post.visibility = PostVisibility::Friends;
+  post.createdAt = QDateTime(QDate(2024, 1, 2), QTime(3, 4, 5), Qt::UTC);
+  for (int i = 0; i < 3; ++i) {
+    Comment comment;
+    comment.id = IdGenerator::next();
+    comment.authorId = QString("friend-%1").arg(i);
+    comment.content = QString("comment %1").arg(i);
+    comment.createdAt = post.createdAt.addSecs(i);
+    post.comments.push_back(comment);
+  }
+
+  QByteArray bytes;
+  {
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    reflect::save(out, post);
+  }
+  SocialPost decoded;
+  {
+    QDataStream in(bytes);
+    in.setVersion(QDataStream::Qt_5_12);
+    reflect::load(in, decoded);
+    ASSERT_EQ(in.status(), QDataStream::Ok);
+    EXPECT_TRUE(in.atEnd());
+  }
+  EXPECT_EQ(decoded.id, post.id);
+  EXPECT_EQ(decoded.authorId.toString(), "legacy-author");
+  EXPECT_EQ(decoded.content, post.content);
+  EXPECT_EQ(decoded.visibility, PostVisibility::Friends);
+  EXPECT_EQ(decoded.createdAt, post.createdAt);
+  ASSERT_EQ(decoded.comments.size(), 3);
+  EXPECT_EQ(decoded.comments[2].authorId.toString(), "friend-2");
+  EXPECT_EQ(decoded.comments[2].createdAt, post.comments[2].createdAt);
+
+  // 截断的数据只会让流进入错误状态，不会崩溃。
+  SocialPost truncated;
+  QDataStream in(bytes.left(bytes.size() / 2));
+  in.setVersion(QDataStream::Qt_5_12);
+  reflect::load(in, truncated);
+  EXPECT_NE(in.status(), QDataStream::Ok);
+}
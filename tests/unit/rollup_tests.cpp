@@ -0,0 +1,153 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QJsonArray>
+#include <QUuid>
+
+#include "core/JsonStorage.h"
+#include "core/LedgerService.h"
+#include "core/Rollups.h"
+
+using namespace core;
+
+/* 测试日历预聚合表的增量维护、区间查询与持久化 共2个测试样例 */
+
+namespace {
+
+Bill makeBill(const QString &id, const QString &categoryId, BillType type,
+              double amount, const QDate &date) {
+  Bill bill;
+  bill.id = id;
+  bill.categoryId = categoryId;
+  bill.type = type;
+  bill.amount = amount;
+  bill.timestamp = QDateTime(date, QTime(12, 0));
+  return bill;
+}
+
+// 逐日比较两张汇总表（QHash 遍历顺序不固定，不直接比较 JSON）。
+void expectSameDays(const CalendarRollups &a, const CalendarRollups &b,
+                    const QDate &from, const QDate &to) {
+  const auto left = a.series(RollupPeriod::Day, from, to);
+  const auto right = b.series(RollupPeriod::Day, from, to);
+  ASSERT_EQ(left.size(), right.size());
+  for (int i = 0; i < left.size(); ++i) {
+    EXPECT_EQ(left[i].totals.count, right[i].totals.count);
+    EXPECT_DOUBLE_EQ(left[i].totals.income, right[i].totals.income);
+    EXPECT_DOUBLE_EQ(left[i].totals.expense, right[i].totals.expense);
+  }
+}
+
+}  // namespace
+
+// 用例：增量维护与全量重建结果一致，日/周/月/年序列按桶返回并包含空桶。
+TEST(RollupTests, IncrementalUpdatesMatchRebuildAndSeries) {
+  const QDate monday(2025, 3, 3);
+  QVector<Bill> bills = {
+      makeBill("b1", "c1", BillType::Expense, 10.0, monday),
+      makeBill("b2", "c1", BillType::Expense, 5.0, monday.addDays(2)),
+      makeBill("b3", "c2", BillType::Income, 100.0, monday.addDays(9)),
+      makeBill("b4", "c2", BillType::Expense, 7.0, QDate(2024, 12, 31)),
+  };
+
+  CalendarRollups incremental;
+  for (const auto &bill : bills) {
+    incremental.add(bill);
+  }
+  // 修改 b2 的金额与日期、删除 b4。
+  incremental.remove(bills[1]);
+  bills[1] = makeBill("b2", "c1", BillType::Expense, 8.0, monday.addDays(1));
+  incremental.add(bills[1]);
+  incremental.remove(bills[3]);
+  bills.removeLast();
+
+  const auto rebuilt = CalendarRollups::build(bills);
+  EXPECT_EQ(incremental.billCount(), 3);
+  expectSameDays(incremental, rebuilt, QDate(2024, 12, 1), QDate(2025, 3, 31));
+
+  const auto days = incremental.series(RollupPeriod::Day, monday, monday.addDays(2));
+  ASSERT_EQ(days.size(), 3);
+  EXPECT_DOUBLE_EQ(days[0].totals.expense, 10.0);
+  EXPECT_DOUBLE_EQ(days[1].totals.expense, 8.0);
+  EXPECT_EQ(days[2].totals.count, 0);
+
+  const auto weeks = incremental.series(RollupPeriod::Week, monday.addDays(3), monday.addDays(10));
+  ASSERT_EQ(weeks.size(), 2);
+  EXPECT_EQ(weeks[0].start, monday);
+  EXPECT_DOUBLE_EQ(weeks[0].totals.expense, 18.0);
+  EXPECT_DOUBLE_EQ(weeks[1].totals.income, 100.0);
+
+  const auto months = incremental.series(RollupPeriod::Month, QDate(2024, 12, 1), QDate(2025, 3, 31), "c1");
+  ASSERT_EQ(months.size(), 4);
+  EXPECT_EQ(months[0].totals.count, 0);
+  EXPECT_DOUBLE_EQ(months[3].totals.expense, 18.0);
+  EXPECT_DOUBLE_EQ(months[3].totals.income, 0.0);
+
+  const auto years = incremental.series(RollupPeriod::Year, QDate(2024, 6, 1), QDate(2025, 1, 1));
+  ASSERT_EQ(years.size(), 2);
+  EXPECT_EQ(years[0].totals.count, 0);
+  EXPECT_EQ(years[1].totals.count, 3);
+
+  CalendarRollups restored;
+  ASSERT_TRUE(CalendarRollups::fromJson(incremental.toJson(), restored));
+  EXPECT_EQ(restored.billCount(), incremental.billCount());
+  expectSameDays(restored, incremental, QDate(2024, 12, 1), QDate(2025, 3, 31));
+  EXPECT_DOUBLE_EQ(restored.series(RollupPeriod::Year, QDate(2025, 1, 1), QDate(2025, 1, 1)).first().totals.income, 100.0);
+
+  // 输出按日期与分类排序，与哈希表的迭代顺序无关。
+  EXPECT_EQ(incremental.toJson(), rebuilt.toJson());
+  const auto entries = incremental.toJson().value("days").toArray();
+  for (int i = 1; i < entries.size(); ++i) {
+    EXPECT_LE(entries[i - 1].toObject().value("d").toDouble(), entries[i].toObject().value("d").toDouble());
+  }
+}
+
+// 用例：服务层在账单增删改后维护汇总表，并与账单一同落盘；旧文件缺少汇总时自动重建。
+TEST(RollupTests, ServiceMaintainsAndPersistsRollups) {
+  const QString envPath = QDir::tempPath() + "/bk_rollup_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  qputenv("BOOKEEPER_DATA_DIR", envPath.toUtf8());
+  QDir(envPath).removeRecursively();
+
+  QString userId;
+  QString err;
+  const QDate today = QDate::currentDate();
+  {
+    LedgerService service;
+    ASSERT_TRUE(service.registerUser("rollup", "rollup@example.com", "p", userId, err)) << err.toStdString();
+    const QString catId = service.categories(userId).first().id.toString();
+    ASSERT_TRUE(service.upsertBill(userId, makeBill("b1", catId, BillType::Expense, 20.0, today), err));
+    ASSERT_TRUE(service.upsertBill(userId, makeBill("b2", catId, BillType::Expense, 30.0, today.addDays(-1)), err));
+    ASSERT_TRUE(service.upsertBill(userId, makeBill("b1", catId, BillType::Expense, 25.0, today), err));
+    ASSERT_TRUE(service.removeBill(userId, "b2", err));
+
+    const auto week = service.periodSeries(userId, RollupPeriod::Day, today.addDays(-6), today);
+    ASSERT_EQ(week.size(), 7);
+    EXPECT_DOUBLE_EQ(week.last().totals.expense, 25.0);
+    EXPECT_EQ(week[5].totals.count, 0);
+    EXPECT_DOUBLE_EQ(service.totalExpense(userId), 25.0);
+  }
+
+  // 新实例从磁盘读取持久化的汇总表。
+  {
+    LedgerService service;
+    const auto data = service.snapshot(userId);
+    ASSERT_TRUE(data != nullptr);
+    EXPECT_EQ(data->rollups.billCount(), 1);
+    EXPECT_DOUBLE_EQ(service.periodSeries(userId, RollupPeriod::Month, today, today).first().totals.expense, 25.0);
+  }
+
+  // 模拟旧版本文件：汇总表与账单不一致时按账单重建。
+  {
+    JsonStorage storage{QDir(envPath)};
+    UserData data;
+    ASSERT_TRUE(storage.loadUser(userId, data));
+    data.rollups = CalendarRollups();
+    ASSERT_TRUE(storage.saveUser(data));
+    UserData reloaded;
+    ASSERT_TRUE(storage.loadUser(userId, reloaded));
+    EXPECT_EQ(reloaded.rollups.billCount(), 1);
+    EXPECT_DOUBLE_EQ(reloaded.rollups.grandTotal().expense, 25.0);
+  }
+
+  QDir(envPath).removeRecursively();
+}
@@ -0,0 +1,134 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFile>
+#include <QUuid>
+
+#include <algorithm>
+
+#include "core/LedgerService.h"
+#include "core/SearchIndex.h"
+
+using namespace core;
+
+/* 测试全文检索的切词、排序、持久化与增量维护 共3个测试样例 */
+
+// 用例：中文按二元组切分，英文与数字按整词小写切分。
+TEST(SearchTests, TokenizesCjkBigramsAndLatinWords) {
+  EXPECT_EQ(SearchIndex::tokenize("打车去机场"),
+            QStringList({"打车", "车去", "去机", "机场"}));
+  EXPECT_EQ(SearchIndex::tokenize("Taxi到 T2航站楼, 58元"),
+            QStringList({"taxi", "到", "t2", "航站", "站楼", "58", "元"}));
+  EXPECT_TRUE(SearchIndex::tokenize("  ,.!  ").isEmpty());
+}
+
+// 用例：查询需命中全部词项并按相关度排序；删除与替换生效；序列化往返一致。
+TEST(SearchTests, RanksHitsAndRoundTripsThroughSerialization) {
+  SearchIndex index;
+  index.upsert(SearchKind::Bill, "b1", QString(), "午餐 牛肉面");
+  index.upsert(SearchKind::Bill, "b2", QString(), "打车去机场");
+  index.upsert(SearchKind::Bill, "b3", QString(), "机场 打车 打车 回家");
+  index.upsert(SearchKind::Post, "p1", QString(), "今天去机场接人");
+  index.upsert(SearchKind::Comment, "c1", "p1", "机场好远");
+
+  auto hits = index.search("打车", 10);
+  ASSERT_EQ(hits.size(), 2);
+  EXPECT_EQ(hits[0].id, "b3");  // 词频更高
+  EXPECT_EQ(hits[1].id, "b2");
+
+  hits = index.search("机场 打车", 10);
+  EXPECT_EQ(hits.size(), 2);
+  hits = index.search("机场", 10);
+  EXPECT_EQ(hits.size(), 4);
+  EXPECT_TRUE(index.search("不存在的词", 10).isEmpty());
+
+  index.remove(SearchKind::Bill, "b3");
+  index.upsert(SearchKind::Bill, "b1", QString(), "早餐");
+  hits = index.search("打车", 10);
+  ASSERT_EQ(hits.size(), 1);
+  EXPECT_EQ(hits[0].id, "b2");
+  EXPECT_TRUE(index.search("牛肉", 10).isEmpty());
+
+  const QByteArray bytes = index.serialize(42);
+  SearchIndex restored;
+  EXPECT_FALSE(restored.deserialize(bytes, 7));
+  ASSERT_TRUE(restored.deserialize(bytes, 42));
+  EXPECT_EQ(restored.documentCount(), index.documentCount());
+  hits = restored.search("机场", 10);
+  ASSERT_EQ(hits.size(), 3);
+  const auto comment = std::find_if(hits.begin(), hits.end(), [](const SearchHit &hit) { return hit.kind == SearchKind::Comment; });
+  ASSERT_NE(comment, hits.end());
+  EXPECT_EQ(comment->parentId, "p1");
+
+  // 墓碑不计入文档频率：带墓碑的索引与重新加载的索引得分相同且为正。
+  const auto live = index.search("机场", 10);
+  ASSERT_EQ(live.size(), hits.size());
+  for (int i = 0; i < hits.size(); ++i) {
+    EXPECT_GT(live[i].score, 0.0);
+    EXPECT_DOUBLE_EQ(live[i].score, hits[i].score);
+  }
+}
+
+// 用例：服务层检索随账单、动态与评论的增删改实时更新，并在重启后复用持久化索引。
+TEST(SearchTests, ServiceKeepsIndexInSyncAcrossRestarts) {
+  const QString envPath = QDir::tempPath() + "/bk_search_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  qputenv("BOOKEEPER_DATA_DIR", envPath.toUtf8());
+  QDir(envPath).removeRecursively();
+
+  QString userId;
+  QString err;
+  {
+    LedgerService service;
+    ASSERT_TRUE(service.registerUser("search", "search@example.com", "p", userId, err)) << err.toStdString();
+    const QString catId = service.categories(userId).first().id.toString();
+    Bill bill;
+    bill.id = "b1";
+    bill.categoryId = catId;
+    bill.note = "出租车";
+    ASSERT_TRUE(service.upsertBill(userId, bill, err));
+    // 首次查询构建索引，之后的修改增量生效。
+    EXPECT_EQ(service.search(userId, "租车").size(), 1);
+
+    bill.id = "b2";
+    bill.note = "租车自驾";
+    ASSERT_TRUE(service.upsertBill(userId, bill, err));
+    EXPECT_EQ(service.search(userId, "租车").size(), 2);
+    ASSERT_TRUE(service.removeBill(userId, "b1", err));
+    auto hits = service.search(userId, "租车");
+    ASSERT_EQ(hits.size(), 1);
+    EXPECT_EQ(hits[0].id, "b2");
+
+    ASSERT_TRUE(service.publishPost(userId, "周末自驾游", "public", err));
+    const auto postId = service.timeline(userId).first().id;
+    ASSERT_TRUE(service.addComment(userId, userId, postId, "带上我自驾", err));
+    hits = service.search(userId, "自驾");
+    EXPECT_EQ(hits.size(), 3);
+  }
+
+  // 重启后加载持久化索引，结果与之前一致。
+  {
+    LedgerService service;
+    EXPECT_TRUE(QFile::exists(QDir(envPath).filePath(JsonStorage::relativeFilePath(userId, "search"))));
+    EXPECT_EQ(service.search(userId, "自驾").size(), 3);
+    EXPECT_EQ(service.search(userId, "租车").size(), 1);
+  }
+
+  // 索引未加载时的新评论使持久化索引失效；索引占用记在快照上，随之逐出。
+  {
+    LedgerService service;
+    const auto postId = service.timeline(userId).first().id;
+    ASSERT_TRUE(service.addComment(userId, userId, postId, "自驾路线", err));
+    EXPECT_FALSE(QFile::exists(QDir(envPath).filePath(JsonStorage::relativeFilePath(userId, "search"))));
+    EXPECT_EQ(service.search(userId, "自驾").size(), 4);
+    const auto footprints = service.footprints();
+    ASSERT_EQ(footprints.size(), 1);
+    EXPECT_GT(footprints[0].memory.search, 0);
+    EXPECT_EQ(service.memoryGauge().cachedBytes, footprints[0].memory.total());
+    service.setMemoryBudget(1);
+    EXPECT_EQ(service.memoryGauge().cachedBytes, 0);
+    service.setMemoryBudget(0);
+    EXPECT_EQ(service.search(userId, "自驾").size(), 4);
+  }
+
+  QDir(envPath).removeRecursively();
+}
@@ -0,0 +1,74 @@
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QStringList>
+
+#include "core/TimestampCodec.h"
+
+using namespace core;
+
+/* 测试手写 ISO 8601 时间戳编解码与 Qt 的一致性 共2个测试样例 */
+
+namespace {
+
+void expectSameAsQt(const QString &text) {
+  const QDateTime expected = QDateTime::fromString(text, Qt::ISODate);
+  const QDateTime actual = TimestampCodec::parse(text);
+  ASSERT_EQ(actual.isValid(), expected.isValid()) << text.toStdString();
+  if (expected.isValid()) {
+    EXPECT_EQ(actual, expected) << text.toStdString();
+    EXPECT_EQ(actual.timeSpec(), expected.timeSpec()) << text.toStdString();
+    EXPECT_EQ(actual.offsetFromUtc(), expected.offsetFromUtc()) << text.toStdString();
+    EXPECT_EQ(actual.time(), expected.time()) << text.toStdString();
+  }
+}
+
+}  // namespace
+
+// 用例：常见写法走快速路径，非常见写法回退到 Qt，结果均与 Qt 相同。
+TEST(TimestampTests, ParseMatchesQt) {
+  QDateTime value;
+  EXPECT_TRUE(TimestampCodec::tryParseFast("2024-02-03T04:05:06", value));
+  EXPECT_EQ(value.timeSpec(), Qt::LocalTime);
+  EXPECT_TRUE(TimestampCodec::tryParseFast("2024-02-03T04:05:06Z", value));
+  EXPECT_EQ(value.timeSpec(), Qt::UTC);
+  EXPECT_TRUE(TimestampCodec::tryParseFast("2024-02-03T04:05:06.25-05:30", value));
+  EXPECT_EQ(value.offsetFromUtc(), -(5 * 3600 + 30 * 60));
+  EXPECT_EQ(value.time().msec(), 250);
+  EXPECT_FALSE(TimestampCodec::tryParseFast("2024-02-03 04:05:06", value));
+  EXPECT_FALSE(TimestampCodec::tryParseFast("2024-02-03T24:00:00", value));
+
+  const QStringList samples = {
+      "2024-02-03T04:05:06",       "2024-02-03T04:05:06Z",
+      "2024-02-03T04:05:06+08:00", "2024-02-03T04:05:06.5Z",
+      "2024-02-03T04:05:06.123+00:00", "2024-02-29",
+      "2023-02-29T00:00:00",       "2024-13-01T00:00:00",
+      "2024-02-03T04:61:00",       "2024-02-03 04:05:06",
+      "2024-02-03T24:00:00",       "2024-02-03T04:05",
+      "2024-02-03T04:05:06+0800",  "2024-02-03T04:05:06+08",
+      "2024-02-03T04:05:06.1234Z", "0000-01-01T00:00:00",
+      "garbage",                   "",
+  };
+  for (const auto &text : samples) {
+    expectSameAsQt(text);
+  }
+}
+
+// 用例：三种时间规格的生成结果与 Qt 一致，且能往返解析。
+TEST(TimestampTests, FormatMatchesQtAndRoundTrips) {
+  const QDateTime utc(QDate(2024, 2, 3), QTime(4, 5, 6, 789), Qt::UTC);
+  const QVector<QDateTime> values = {
+      utc, utc.toLocalTime(), utc.toOffsetFromUtc(8 * 3600),
+      utc.toOffsetFromUtc(-(9 * 3600 + 30 * 60)),
+      QDateTime(QDate(1, 1, 1), QTime(0, 0), Qt::UTC),
+      QDateTime(QDate(9999, 12, 31), QTime(23, 59, 59), Qt::UTC),
+  };
+  for (const auto &value : values) {
+    const QString text = TimestampCodec::format(value);
+    EXPECT_EQ(text, value.toString(Qt::ISODate));
+    expectSameAsQt(text);
+  }
+  EXPECT_EQ(TimestampCodec::format(utc), "2024-02-03T04:05:06Z");
+  EXPECT_EQ(TimestampCodec::format(utc.toOffsetFromUtc(-3600)), "2024-02-03T03:05:06-01:00");
+  EXPECT_TRUE(TimestampCodec::format(QDateTime()).isEmpty());
+}
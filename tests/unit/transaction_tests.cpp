@@ -0,0 +1,114 @@
+#include <gtest/gtest.h>
+
+#include <QDir>
+#include <QFileInfo>
+#include <QUuid>
+
+#include "core/JsonStorage.h"
+#include "core/LedgerService.h"
+
+using namespace core;
+
+/* 测试多操作事务的提交与回滚 共2个测试样例 */
+
+// 用例：同一事务内新建分类并记入多笔账单，一次提交后全部可见且已落盘。
+TEST(TransactionTests, CommitsCategoryAndBillsTogether) {
+  const QString envPath = QDir::tempPath() + "/bk_txn_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  qputenv("BOOKEEPER_DATA_DIR", envPath.toUtf8());
+  QDir(envPath).removeRecursively();
+
+  LedgerService service;
+  QString userId;
+  QString err;
+  ASSERT_TRUE(service.registerUser("txn", "txn@example.com", "p", userId, err)) << err.toStdString();
+  const int baseCategories = service.categories(userId).size();
+
+  const bool ok = service.transaction(
+      {userId},
+      [&](TransactionViews &users, QString &) {
+        UserData *data = users.value(userId);
+        Category category;
+        category.id = "c1";
+        category.name = "旅行";
+        category.type = "expense";
+        data->categories.push_back(category);
+        for (int i = 0; i < 3; ++i) {
+          Bill bill;
+          bill.id = QString("b%1").arg(i);
+          bill.categoryId = "c1";
+          bill.amount = 10.0;
+          bill.timestamp = QDateTime::currentDateTime();
+          data->bills.push_back(bill);
+        }
+        return true;
+      },
+      err);
+  ASSERT_TRUE(ok) << err.toStdString();
+
+  EXPECT_EQ(service.categories(userId).size(), baseCategories + 1);
+  EXPECT_EQ(service.bills(userId).size(), 3);
+
+  // 磁盘上的数据与快照一致，且没有残留的临时或备份文件。
+  JsonStorage storage{QDir(envPath)};
+  UserData onDisk;
+  ASSERT_TRUE(storage.loadUser(userId, onDisk));
+  EXPECT_EQ(onDisk.bills.size(), 3);
+  const QFileInfo userFile(QDir(envPath).filePath(JsonStorage::relativeFilePath(userId)));
+  EXPECT_TRUE(userFile.dir().entryList({"*.tmp", "*.bak"}, QDir::Files).isEmpty());
+
+  QDir(envPath).removeRecursively();
+}
+
+// 用例：事务函数放弃或校验失败时，任何用户的数据都不发生变化。
+TEST(TransactionTests, AbortAndValidationFailureLeaveNoTrace) {
+  const QString envPath = QDir::tempPath() + "/bk_txn_abort_" + QUuid::createUuid().toString(QUuid::WithoutBraces);
+  qputenv("BOOKEEPER_DATA_DIR", envPath.toUtf8());
+  QDir(envPath).removeRecursively();
+
+  LedgerService service;
+  QString aliceId;
+  QString bobId;
+  QString err;
+  ASSERT_TRUE(service.registerUser("alice_t", "alice_t@example.com", "p", aliceId, err)) << err.toStdString();
+  ASSERT_TRUE(service.registerUser("bob_t", "bob_t@example.com", "p", bobId, err)) << err.toStdString();
+  const auto aliceBefore = service.snapshot(aliceId);
+  const auto bobBefore = service.snapshot(bobId);
+
+  // 事务函数主动放弃。
+  EXPECT_FALSE(service.transaction(
+      {aliceId, bobId},
+      [&](TransactionViews &users, QString &message) {
+        users.value(aliceId)->profile.friendIds.append(bobId);
+        message = "aborted";
+        return false;
+      },
+      err));
+  EXPECT_EQ(err, "aborted");
+
+  // 账单引用不存在的分类，校验失败。
+  EXPECT_FALSE(service.transaction(
+      {aliceId, bobId},
+      [&](TransactionViews &users, QString &) {
+        users.value(aliceId)->profile.friendIds.append(bobId);
+        Bill bill;
+        bill.id = "b1";
+        bill.categoryId = "missing";
+        users.value(bobId)->bills.push_back(bill);
+        return true;
+      },
+      err));
+  EXPECT_EQ(err, "分类不存在");
+
+  EXPECT_EQ(service.snapshot(aliceId), aliceBefore);
+  EXPECT_EQ(service.snapshot(bobId), bobBefore);
+  JsonStorage storage{QDir(envPath)};
+  UserData aliceOnDisk;
+  ASSERT_TRUE(storage.loadUser(aliceId, aliceOnDisk));
+  EXPECT_TRUE(aliceOnDisk.profile.friendIds.isEmpty());
+
+  // 不存在的用户无法参与事务。
+  EXPECT_FALSE(service.transaction(
+      {aliceId, "not-exist"}, [](TransactionViews &, QString &) { return true; }, err));
+
+  QDir(envPath).removeRecursively();
+}